@@ -0,0 +1,128 @@
+/**
+ * @file dirty_rect_bench.cpp
+ *
+ * @brief Benchmark of dirty-rectangle partial redraw on the software renderer.
+ *
+ * A scene of 500 sprites is rendered on an off-screen software renderer while a varying number of
+ * them move every frame. For each case the full clear-and-redraw path is compared with the
+ * dirty-rectangle path: frame time, pixels touched per frame (cleared plus drawn) and damage
+ * rectangles after merging.
+ *
+ * Build and run from the Flyweight directory:
+ * @code
+ * make bench && ./bench/dirty_rect_bench
+ * @endcode
+ */
+
+#include <SDL2/SDL.h>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "DirtyRects.h"
+#include "Flyweight.h"
+
+namespace
+{
+    constexpr int SpriteCount = 500;
+    constexpr int FrameCount = 100;
+    constexpr int ScreenWidth = 1280;
+    constexpr int ScreenHeight = 720;
+    constexpr int SpriteSize = 192;
+
+    SDL_Surface* MakeSprite(const std::string&)
+    {
+        SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, SpriteSize, SpriteSize, 32, SDL_PIXELFORMAT_RGBA32);
+        if (surface)
+        {
+            SDL_FillRect(surface, nullptr, SDL_MapRGBA(surface->format, 90, 90, 100, 255));
+        }
+        return surface;
+    }
+
+    double Milliseconds(Uint64 ticks)
+    {
+        return 1000.0 * static_cast<double>(ticks) / SDL_GetPerformanceFrequency();
+    }
+
+    SDL_Point Position(int sprite, int frame)
+    {
+        return SDL_Point{(sprite * 71 + frame * 3) % (ScreenWidth - 48), (sprite * 37) % (ScreenHeight - 48)};
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    (void)argc;
+    (void)argv;
+
+    if (SDL_Init(0) != 0)
+    {
+        std::cerr << "SDL_Init Error: " << SDL_GetError() << std::endl;
+        return 1;
+    }
+
+    SDL_Surface* screen = SDL_CreateRGBSurfaceWithFormat(0, ScreenWidth, ScreenHeight, 32, SDL_PIXELFORMAT_ARGB8888);
+    SDL_Renderer* renderer = screen ? SDL_CreateSoftwareRenderer(screen) : nullptr;
+    if (!renderer)
+    {
+        std::cerr << "SDL_CreateSoftwareRenderer Error: " << SDL_GetError() << std::endl;
+        SDL_Quit();
+        return 1;
+    }
+
+    {
+        FlyweightFactory factory;
+        std::shared_ptr<const Flyweight> sprite = factory.GetTexture(renderer, "generated/sprite", MakeSprite);
+
+        std::cout << "moving  full(ms)  dirty(ms)  speedup  full px/frame  dirty px/frame  rects" << std::endl;
+        for (int moving : {1, 5, 20, 100})
+        {
+            double times[2] = {0.0, 0.0};
+            double pixels[2] = {0.0, 0.0};
+            double rects = 0.0;
+
+            for (int mode = 0; mode < 2; ++mode)
+            {
+                DirtyRectScene scene(SDL_Color{135, 206, 250, 255});
+                for (int i = 0; i < SpriteCount; ++i)
+                {
+                    SDL_Point position = Position(i, 0);
+                    scene.Add(sprite, position.x, position.y);
+                }
+                scene.Render(renderer);
+
+                Uint64 start = SDL_GetPerformanceCounter();
+                for (int frame = 1; frame <= FrameCount; ++frame)
+                {
+                    for (int i = 0; i < moving; ++i)
+                    {
+                        SDL_Point position = Position(i, frame);
+                        scene.Move(static_cast<std::size_t>(i), position.x, position.y);
+                    }
+
+                    if (mode == 0)
+                    {
+                        scene.RenderFull(renderer);
+                    }
+                    else
+                    {
+                        scene.Render(renderer);
+                        rects += static_cast<double>(scene.GetStats().rects);
+                    }
+                    pixels[mode] += static_cast<double>(scene.GetStats().pixelsCleared + scene.GetStats().pixelsDrawn);
+                    SDL_RenderPresent(renderer);
+                }
+                times[mode] = Milliseconds(SDL_GetPerformanceCounter() - start) / FrameCount;
+            }
+
+            std::cout << moving << "  " << times[0] << "  " << times[1] << "  " << times[0] / times[1] << "x  "
+                      << pixels[0] / FrameCount << "  " << pixels[1] / FrameCount << "  " << rects / FrameCount << std::endl;
+        }
+    }
+
+    SDL_DestroyRenderer(renderer);
+    SDL_FreeSurface(screen);
+    SDL_Quit();
+    return 0;
+}
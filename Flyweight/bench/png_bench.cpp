@@ -0,0 +1,595 @@
+/**
+ * @file png_bench.cpp
+ *
+ * @brief Benchmark of the built-in PNG decoder against SDL_image.
+ *
+ * First, a corpus of PNG files generated in memory checks the decoder bit for bit: every color
+ * type and bit depth, with and without tRNS, widths that end the SSE2 loops on every remainder,
+ * rows cycling through the five filters, and zlib streams made of stored or fixed Huffman
+ * blocks. Each file must decode to the pixels it was generated from in both pixel orders, and
+ * must be rejected once a bit of its image data is flipped, with or without a fixed-up chunk CRC.
+ * A palette image without PLTE must be rejected too.
+ *
+ * Then every PNG file below a corpus directory (assets by default) is decoded repeatedly by both
+ * decoders. The SDL_image result is converted to RGBA32, which the texture upload needs anyway,
+ * and compared byte for byte with the built-in decoder's output. Throughput is reported in
+ * megabytes of decoded pixels per second.
+ *
+ * Build and run from the Flyweight directory:
+ * @code
+ * make bench && ./bench/png_bench [corpus directory]
+ * @endcode
+ */
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "PngDecoder.h"
+
+namespace
+{
+    constexpr int Repetitions = 20;
+
+    double Milliseconds(Uint64 ticks)
+    {
+        return 1000.0 * static_cast<double>(ticks) / SDL_GetPerformanceFrequency();
+    }
+
+    std::vector<std::uint8_t> ReadFile(const std::string& path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        return std::vector<std::uint8_t>((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    }
+
+    /**
+     * @brief Decodes with SDL_image and converts to RGBA32. Returns nullptr on failure.
+     */
+    SDL_Surface* LoadWithSdlImage(const std::string& path)
+    {
+        SDL_Surface* loaded = IMG_Load(path.c_str());
+        if (!loaded)
+        {
+            return nullptr;
+        }
+        SDL_Surface* converted = SDL_ConvertSurfaceFormat(loaded, SDL_PIXELFORMAT_RGBA32, 0);
+        SDL_FreeSurface(loaded);
+        return converted;
+    }
+
+    bool SamePixels(const SDL_Surface* surface, const std::vector<std::uint8_t>& pixels, const PngInfo& info)
+    {
+        if (surface->w != static_cast<int>(info.width) || surface->h != static_cast<int>(info.height))
+        {
+            return false;
+        }
+        const std::size_t rowBytes = static_cast<std::size_t>(info.width) * 4;
+        for (std::uint32_t y = 0; y < info.height; ++y)
+        {
+            const auto* row = static_cast<const std::uint8_t*>(surface->pixels) + y * surface->pitch;
+            if (std::memcmp(row, pixels.data() + y * rowBytes, rowBytes) != 0)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // ------------------------------------------------------------------------------------------
+    // Generated corpus
+    // ------------------------------------------------------------------------------------------
+
+    /**
+     * @brief Writes bits least significant first, as deflate does.
+     */
+    struct BitWriter
+    {
+        std::vector<std::uint8_t>& out;
+        std::uint32_t bits = 0;
+        int count = 0;
+
+        void Write(std::uint32_t value, int n)
+        {
+            bits |= value << count;
+            count += n;
+            while (count >= 8)
+            {
+                out.push_back(static_cast<std::uint8_t>(bits));
+                bits >>= 8;
+                count -= 8;
+            }
+        }
+
+        /**
+         * @brief Writes a Huffman code, which deflate stores most significant bit first.
+         */
+        void WriteCode(std::uint32_t code, int n)
+        {
+            for (int i = n - 1; i >= 0; --i)
+            {
+                Write((code >> i) & 1, 1);
+            }
+        }
+
+        void Flush()
+        {
+            if (count > 0)
+            {
+                Write(0, 8 - count);
+            }
+        }
+    };
+
+    void PutBigEndian32(std::vector<std::uint8_t>& out, std::uint32_t value)
+    {
+        for (int shift = 24; shift >= 0; shift -= 8)
+        {
+            out.push_back(static_cast<std::uint8_t>(value >> shift));
+        }
+    }
+
+    std::uint32_t ReferenceCrc32(const std::uint8_t* data, std::size_t size)
+    {
+        std::uint32_t crc = 0xFFFFFFFFu;
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            crc ^= data[i];
+            for (int k = 0; k < 8; ++k)
+            {
+                crc = (crc & 1) ? 0xEDB88320u ^ (crc >> 1) : crc >> 1;
+            }
+        }
+        return crc ^ 0xFFFFFFFFu;
+    }
+
+    /**
+     * @brief zlib stream of data in stored blocks, or in fixed Huffman blocks of literals only.
+     */
+    std::vector<std::uint8_t> Deflate(const std::vector<std::uint8_t>& data, bool stored)
+    {
+        std::vector<std::uint8_t> out = {0x78, 0x01};
+        // Small blocks, so that every file has several of them.
+        constexpr std::size_t BlockSize = 1000;
+        BitWriter writer{out};
+        std::size_t offset = 0;
+        do
+        {
+            const std::size_t length = std::min(BlockSize, data.size() - offset);
+            const bool last = offset + length == data.size();
+            writer.Write(last ? 1 : 0, 1);
+            if (stored)
+            {
+                writer.Write(0, 2);
+                writer.Flush();
+                writer.Write(static_cast<std::uint32_t>(length), 16);
+                writer.Write(static_cast<std::uint32_t>(length ^ 0xFFFF), 16);
+                out.insert(out.end(), data.begin() + offset, data.begin() + offset + length);
+            }
+            else
+            {
+                writer.Write(1, 2);
+                for (std::size_t i = offset; i < offset + length; ++i)
+                {
+                    if (data[i] < 144)
+                    {
+                        writer.WriteCode(0x30 + data[i], 8);
+                    }
+                    else
+                    {
+                        writer.WriteCode(0x190 + data[i] - 144, 9);
+                    }
+                }
+                writer.WriteCode(0, 7);
+            }
+            offset += length;
+        } while (offset < data.size());
+        writer.Flush();
+
+        std::uint32_t a = 1;
+        std::uint32_t b = 0;
+        for (std::uint8_t byte : data)
+        {
+            a = (a + byte) % 65521;
+            b = (b + a) % 65521;
+        }
+        PutBigEndian32(out, (b << 16) | a);
+        return out;
+    }
+
+    void PutChunk(std::vector<std::uint8_t>& png, const char* type, const std::vector<std::uint8_t>& body)
+    {
+        PutBigEndian32(png, static_cast<std::uint32_t>(body.size()));
+        const std::size_t start = png.size();
+        png.insert(png.end(), type, type + 4);
+        png.insert(png.end(), body.begin(), body.end());
+        PutBigEndian32(png, ReferenceCrc32(png.data() + start, png.size() - start));
+    }
+
+    int Predict(int filter, int left, int up, int upLeft)
+    {
+        switch (filter)
+        {
+            case 1: return left;
+            case 2: return up;
+            case 3: return (left + up) / 2;
+            case 4:
+            {
+                const int p = left + up - upLeft;
+                const int pa = std::abs(p - left);
+                const int pb = std::abs(p - up);
+                const int pc = std::abs(p - upLeft);
+                return pa <= pb && pa <= pc ? left : pb <= pc ? up : upLeft;
+            }
+            default: return 0;
+        }
+    }
+
+    struct GeneratedPng
+    {
+        std::string name;
+        std::vector<std::uint8_t> file;
+        std::vector<std::uint8_t> expected;   /**< RGBA32 pixels. */
+        std::size_t idatOffset = 0;           /**< Offset of the IDAT chunk's data in file. */
+        std::size_t idatSize = 0;
+    };
+
+    /**
+     * @brief Generates a PNG file of pseudo-random samples along with its RGBA32 pixels, worked
+     *        out from the samples as the PNG specification describes.
+     */
+    GeneratedPng Generate(int colorType, int depth, bool transparency, std::uint32_t width, std::uint32_t height,
+                          bool stored, std::uint32_t seed)
+    {
+        const int channels = colorType == 2 ? 3 : colorType == 4 ? 2 : colorType == 6 ? 4 : 1;
+        const unsigned maxSample = (1u << depth) - 1;
+        auto random = [&seed]() {
+            seed = seed * 1664525u + 1013904223u;
+            return seed >> 8;
+        };
+
+        std::vector<unsigned> samples(static_cast<std::size_t>(width) * height * channels);
+        for (unsigned& sample : samples)
+        {
+            sample = random() & maxSample;
+        }
+
+        // Palettes hold an entry for every index; tRNS only covers the first half of them.
+        const unsigned paletteSize = colorType == 3 ? maxSample + 1 : 0;
+        std::vector<std::uint8_t> palette(paletteSize * 3);
+        std::vector<std::uint8_t> paletteAlpha(transparency ? (paletteSize + 1) / 2 : 0);
+        for (std::uint8_t& value : palette)
+        {
+            value = static_cast<std::uint8_t>(random());
+        }
+        for (std::uint8_t& value : paletteAlpha)
+        {
+            value = static_cast<std::uint8_t>(random());
+        }
+        // The first pixel's color is the transparent one, so that the key is always hit.
+        const bool keyed = transparency && (colorType == 0 || colorType == 2);
+
+        GeneratedPng png;
+        png.name = "color type " + std::to_string(colorType) + ", " + std::to_string(depth) + " bits, "
+                   + std::to_string(width) + "x" + std::to_string(height) + (transparency ? ", tRNS" : "")
+                   + (stored ? ", stored" : ", fixed Huffman");
+        png.expected.resize(static_cast<std::size_t>(width) * height * 4);
+        auto scale = [depth](unsigned sample) {
+            return static_cast<std::uint8_t>(depth == 16 ? sample >> 8 : sample * 255 / ((1u << depth) - 1));
+        };
+        for (std::size_t pixel = 0; pixel < static_cast<std::size_t>(width) * height; ++pixel)
+        {
+            const unsigned* s = samples.data() + pixel * channels;
+            std::uint8_t* out = png.expected.data() + pixel * 4;
+            switch (colorType)
+            {
+                case 0:
+                    out[0] = out[1] = out[2] = scale(s[0]);
+                    out[3] = keyed && s[0] == samples[0] ? 0 : 255;
+                    break;
+                case 2:
+                    out[0] = scale(s[0]);
+                    out[1] = scale(s[1]);
+                    out[2] = scale(s[2]);
+                    out[3] = keyed && s[0] == samples[0] && s[1] == samples[1] && s[2] == samples[2] ? 0 : 255;
+                    break;
+                case 3:
+                    std::memcpy(out, palette.data() + s[0] * 3, 3);
+                    out[3] = s[0] < paletteAlpha.size() ? paletteAlpha[s[0]] : 255;
+                    break;
+                case 4:
+                    out[0] = out[1] = out[2] = scale(s[0]);
+                    out[3] = scale(s[1]);
+                    break;
+                default:
+                    for (int c = 0; c < 4; ++c)
+                    {
+                        out[c] = scale(s[c]);
+                    }
+                    break;
+            }
+        }
+
+        // Pack the samples most significant bit first, then filter each row with the next filter.
+        const std::size_t rowBytes = (static_cast<std::size_t>(width) * channels * depth + 7) / 8;
+        const std::size_t bpp = std::max<std::size_t>(1, static_cast<std::size_t>(channels) * depth / 8);
+        std::vector<std::uint8_t> packed(rowBytes * height, 0);
+        for (std::uint32_t y = 0; y < height; ++y)
+        {
+            std::uint8_t* row = packed.data() + y * rowBytes;
+            for (std::size_t n = 0; n < static_cast<std::size_t>(width) * channels; ++n)
+            {
+                const unsigned sample = samples[y * static_cast<std::size_t>(width) * channels + n];
+                if (depth == 16)
+                {
+                    row[2 * n] = static_cast<std::uint8_t>(sample >> 8);
+                    row[2 * n + 1] = static_cast<std::uint8_t>(sample);
+                }
+                else
+                {
+                    const std::size_t bit = n * depth;
+                    row[bit / 8] |= static_cast<std::uint8_t>(sample << (8 - depth - bit % 8));
+                }
+            }
+        }
+        std::vector<std::uint8_t> filtered;
+        for (std::uint32_t y = 0; y < height; ++y)
+        {
+            const int filter = static_cast<int>((y + seed % 5) % 5);
+            const std::uint8_t* row = packed.data() + y * rowBytes;
+            const std::uint8_t* previous = y > 0 ? row - rowBytes : nullptr;
+            filtered.push_back(static_cast<std::uint8_t>(filter));
+            for (std::size_t i = 0; i < rowBytes; ++i)
+            {
+                const int left = i >= bpp ? row[i - bpp] : 0;
+                const int up = previous ? previous[i] : 0;
+                const int upLeft = previous && i >= bpp ? previous[i - bpp] : 0;
+                filtered.push_back(static_cast<std::uint8_t>(row[i] - Predict(filter, left, up, upLeft)));
+            }
+        }
+
+        png.file = {0x89, 'P', 'N', 'G', 0x0D, 0x0A, 0x1A, 0x0A};
+        std::vector<std::uint8_t> header;
+        PutBigEndian32(header, width);
+        PutBigEndian32(header, height);
+        header.insert(header.end(), {static_cast<std::uint8_t>(depth), static_cast<std::uint8_t>(colorType), 0, 0, 0});
+        PutChunk(png.file, "IHDR", header);
+        if (colorType == 3)
+        {
+            PutChunk(png.file, "PLTE", palette);
+        }
+        if (transparency)
+        {
+            std::vector<std::uint8_t> key;
+            for (int c = 0; c < (colorType == 2 ? 3 : 1) && keyed; ++c)
+            {
+                key.push_back(static_cast<std::uint8_t>(samples[c] >> 8));
+                key.push_back(static_cast<std::uint8_t>(samples[c]));
+            }
+            PutChunk(png.file, "tRNS", colorType == 3 ? paletteAlpha : key);
+        }
+        const std::vector<std::uint8_t> compressed = Deflate(filtered, stored);
+        png.idatOffset = png.file.size() + 8;
+        png.idatSize = compressed.size();
+        PutChunk(png.file, "IDAT", compressed);
+        PutChunk(png.file, "IEND", {});
+        return png;
+    }
+
+    bool Decodes(const std::vector<std::uint8_t>& file, std::vector<std::uint8_t>& pixels, std::uint32_t width,
+                 PngPixelOrder order)
+    {
+        std::string message;
+        return DecodePng(file.data(), file.size(), pixels.data(), static_cast<std::size_t>(width) * 4, order, message);
+    }
+
+    /**
+     * @brief Checks the decoder against the generated corpus. Returns the number of failures.
+     */
+    std::size_t CheckGeneratedCorpus()
+    {
+        struct Layout
+        {
+            int colorType;
+            int depth;
+        };
+        const Layout layouts[] = {{0, 1}, {0, 2}, {0, 4}, {0, 8}, {0, 16}, {2, 8}, {2, 16}, {3, 1}, {3, 2},
+                                  {3, 4}, {3, 8}, {4, 8}, {4, 16}, {6, 8}, {6, 16}};
+        const std::uint32_t widths[] = {1, 5, 16, 37};
+        constexpr std::uint32_t Height = 11;
+
+        std::size_t cases = 0;
+        std::size_t failures = 0;
+        std::uint32_t seed = 1;
+        for (const Layout& layout : layouts)
+        {
+            for (bool transparency : {false, true})
+            {
+                if (transparency && (layout.colorType == 4 || layout.colorType == 6))
+                {
+                    continue;
+                }
+                for (std::uint32_t width : widths)
+                {
+                    for (bool stored : {true, false})
+                    {
+                        GeneratedPng png = Generate(layout.colorType, layout.depth, transparency, width, Height, stored, seed++);
+                        std::vector<std::uint8_t> pixels(png.expected.size());
+                        ++cases;
+
+                        bool good = Decodes(png.file, pixels, width, PngPixelOrder::RGBA) && pixels == png.expected;
+                        if (good && Decodes(png.file, pixels, width, PngPixelOrder::BGRA))
+                        {
+                            for (std::size_t i = 0; i < pixels.size(); i += 4)
+                            {
+                                std::swap(pixels[i], pixels[i + 2]);
+                            }
+                            good = pixels == png.expected;
+                        }
+                        else
+                        {
+                            good = false;
+                        }
+
+                        // A flipped bit must fail the chunk CRC; with the CRC fixed up, the zlib checksum.
+                        std::vector<std::uint8_t> corrupt = png.file;
+                        corrupt[png.idatOffset + png.idatSize / 2] ^= 0x10;
+                        bool rejected = !Decodes(corrupt, pixels, width, PngPixelOrder::RGBA);
+                        std::vector<std::uint8_t> crcFixed(corrupt.begin(), corrupt.begin() + png.idatOffset - 4);
+                        std::uint32_t crc = ReferenceCrc32(corrupt.data() + png.idatOffset - 4, png.idatSize + 4);
+                        crcFixed.insert(crcFixed.end(), corrupt.begin() + png.idatOffset - 4, corrupt.begin() + png.idatOffset + png.idatSize);
+                        PutBigEndian32(crcFixed, crc);
+                        crcFixed.insert(crcFixed.end(), corrupt.begin() + png.idatOffset + png.idatSize + 4, corrupt.end());
+                        rejected = rejected && !Decodes(crcFixed, pixels, width, PngPixelOrder::RGBA);
+
+                        if (!good || !rejected)
+                        {
+                            std::cout << png.name << ": " << (good ? "corrupt copy decoded" : "wrong pixels") << std::endl;
+                            ++failures;
+                        }
+                    }
+                }
+            }
+        }
+
+        // The same palette image without its PLTE chunk.
+        GeneratedPng png = Generate(3, 8, false, 16, Height, true, seed);
+        const std::size_t plte = 8 + 25;
+        const std::uint32_t plteSize = (png.file[plte] << 24) | (png.file[plte + 1] << 16) | (png.file[plte + 2] << 8) | png.file[plte + 3];
+        png.file.erase(png.file.begin() + plte, png.file.begin() + plte + 12 + plteSize);
+        std::vector<std::uint8_t> pixels(png.expected.size());
+        ++cases;
+        if (Decodes(png.file, pixels, 16, PngPixelOrder::RGBA))
+        {
+            std::cout << "palette image without PLTE: decoded" << std::endl;
+            ++failures;
+        }
+
+        std::cout << cases - failures << " of " << cases << " generated cases pass" << std::endl;
+        return failures;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    const std::string corpus = argc > 1 ? argv[1] : "assets";
+
+    if (SDL_Init(0) != 0)
+    {
+        std::cerr << "SDL_Init Error: " << SDL_GetError() << std::endl;
+        return 1;
+    }
+    if (!(IMG_Init(IMG_INIT_PNG) & IMG_INIT_PNG))
+    {
+        std::cerr << "IMG_Init Error: " << IMG_GetError() << std::endl;
+        SDL_Quit();
+        return 1;
+    }
+
+    const std::size_t corpusFailures = CheckGeneratedCorpus();
+
+    std::vector<std::string> files;
+    std::error_code error;
+    for (auto it = std::filesystem::recursive_directory_iterator(corpus, error);
+         it != std::filesystem::recursive_directory_iterator(); it.increment(error))
+    {
+        std::string extension = it->path().extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return std::tolower(c); });
+        if (it->is_regular_file() && extension == ".png")
+        {
+            files.push_back(it->path().string());
+        }
+    }
+    std::sort(files.begin(), files.end());
+    if (files.empty())
+    {
+        std::cerr << "No PNG files found in " << corpus << std::endl;
+        IMG_Quit();
+        SDL_Quit();
+        return 1;
+    }
+
+    std::size_t totalBytes = 0;
+    Uint64 totalBuiltin = 0;
+    Uint64 totalSdlImage = 0;
+    std::size_t mismatches = 0;
+    std::size_t unsupported = 0;
+
+    std::cout << "file                                  size        builtin(ms)  SDL_image(ms)  speedup  match" << std::endl;
+    for (const std::string& path : files)
+    {
+        std::vector<std::uint8_t> data = ReadFile(path);
+        PngInfo info;
+        std::string message;
+        if (!ReadPngInfo(data.data(), data.size(), info, message))
+        {
+            std::cout << path << ": " << message << std::endl;
+            ++unsupported;
+            continue;
+        }
+
+        const std::size_t pixelBytes = static_cast<std::size_t>(info.width) * info.height * 4;
+        std::vector<std::uint8_t> pixels(pixelBytes);
+
+        bool decoded = true;
+        Uint64 start = SDL_GetPerformanceCounter();
+        for (int i = 0; i < Repetitions && decoded; ++i)
+        {
+            decoded = DecodePng(data.data(), data.size(), pixels.data(), static_cast<std::size_t>(info.width) * 4,
+                                PngPixelOrder::RGBA, message);
+        }
+        Uint64 builtin = SDL_GetPerformanceCounter() - start;
+        if (!decoded)
+        {
+            std::cout << path << ": " << message << ", SDL_image is used instead" << std::endl;
+            ++unsupported;
+            continue;
+        }
+
+        start = SDL_GetPerformanceCounter();
+        SDL_Surface* reference = nullptr;
+        for (int i = 0; i < Repetitions; ++i)
+        {
+            SDL_FreeSurface(reference);
+            reference = LoadWithSdlImage(path);
+        }
+        Uint64 sdlImage = SDL_GetPerformanceCounter() - start;
+
+        bool match = reference && SamePixels(reference, pixels, info);
+        SDL_FreeSurface(reference);
+        if (!match)
+        {
+            ++mismatches;
+        }
+
+        totalBytes += pixelBytes;
+        totalBuiltin += builtin;
+        totalSdlImage += sdlImage;
+
+        std::cout << path << "  " << info.width << "x" << info.height << "  "
+                  << Milliseconds(builtin) / Repetitions << "  " << Milliseconds(sdlImage) / Repetitions << "  "
+                  << static_cast<double>(sdlImage) / builtin << "x  " << (match ? "yes" : "NO") << std::endl;
+    }
+
+    const double megabytes = static_cast<double>(totalBytes) * Repetitions / (1024.0 * 1024.0);
+    if (totalBuiltin > 0 && totalSdlImage > 0)
+    {
+        std::cout << "Built-in decoder: " << megabytes / (Milliseconds(totalBuiltin) / 1000.0) << " MiB/s, SDL_image: "
+                  << megabytes / (Milliseconds(totalSdlImage) / 1000.0) << " MiB/s (including conversion to RGBA32)" << std::endl;
+    }
+    std::cout << mismatches << " mismatching and " << unsupported << " unsupported of " << files.size() << " files" << std::endl;
+
+    IMG_Quit();
+    SDL_Quit();
+    return mismatches == 0 && corpusFailures == 0 ? 0 : 1;
+}
@@ -0,0 +1,118 @@
+/**
+ * @file render_queue_bench.cpp
+ *
+ * @brief Benchmark of the radix-sorted RenderQueue.
+ *
+ * For queues of increasing size, drawing 64 different flyweights in random order, reports the
+ * texture switches before and after sorting, and the sort time of the serial radix sort, the
+ * parallel radix sort and std::stable_sort on the same keys. The radix results are checked
+ * against std::stable_sort.
+ *
+ * Build and run from the Flyweight directory:
+ * @code
+ * make bench && ./bench/render_queue_bench
+ * @endcode
+ */
+
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "RenderQueue.h"
+
+namespace
+{
+    constexpr int FlyweightCount = 64;
+
+    /**
+     * @brief A flyweight that draws nothing, so only the queue itself is measured.
+     */
+    class NullFlyweight : public Flyweight
+    {
+    public:
+        void Draw(SDL_Renderer*, int, int) const override {}
+    };
+
+    double Milliseconds(Uint64 ticks)
+    {
+        return 1000.0 * static_cast<double>(ticks) / SDL_GetPerformanceFrequency();
+    }
+
+    std::size_t CountSwitches(const std::vector<std::uint64_t>& keys)
+    {
+        std::size_t switches = 0;
+        std::uint64_t previous = ~0ULL;
+        for (std::uint64_t key : keys)
+        {
+            std::uint64_t texture = (key >> 40) & 0xFFFF;
+            switches += texture != previous;
+            previous = texture;
+        }
+        return switches;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    (void)argc;
+    (void)argv;
+
+    std::vector<std::unique_ptr<NullFlyweight>> flyweights;
+    for (int i = 0; i < FlyweightCount; ++i)
+    {
+        flyweights.push_back(std::make_unique<NullFlyweight>());
+    }
+
+    const unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    std::mt19937 random(42);
+
+    std::cout << "commands  switches(unsorted)  switches(sorted)  radix(ms)  radix x" << threads
+              << "(ms)  stable_sort(ms)  flush(ms)" << std::endl;
+
+    for (std::size_t size : {1000u, 10000u, 100000u, 1000000u, 4000000u})
+    {
+        RenderQueue queue;
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            const Flyweight& flyweight = *flyweights[random() % FlyweightCount];
+            queue.Submit(flyweight, 0, 0, static_cast<std::uint8_t>(random() % 4), static_cast<std::uint16_t>(random()));
+        }
+
+        std::vector<std::uint64_t> unsorted = queue.GetKeys();
+        std::vector<std::uint64_t> scratch;
+
+        std::vector<std::uint64_t> serial = unsorted;
+        Uint64 start = SDL_GetPerformanceCounter();
+        RadixSortKeys(serial, scratch, 3, 7, 1);
+        double serialMs = Milliseconds(SDL_GetPerformanceCounter() - start);
+
+        std::vector<std::uint64_t> parallel = unsorted;
+        start = SDL_GetPerformanceCounter();
+        RadixSortKeys(parallel, scratch, 3, 7, threads);
+        double parallelMs = Milliseconds(SDL_GetPerformanceCounter() - start);
+
+        std::vector<std::uint64_t> reference = unsorted;
+        start = SDL_GetPerformanceCounter();
+        std::stable_sort(reference.begin(), reference.end(), [](std::uint64_t a, std::uint64_t b) { return (a >> 24) < (b >> 24); });
+        double stableMs = Milliseconds(SDL_GetPerformanceCounter() - start);
+
+        if (serial != reference || parallel != reference)
+        {
+            std::cerr << "Radix sort result differs from std::stable_sort for " << size << " keys" << std::endl;
+            return 1;
+        }
+
+        start = SDL_GetPerformanceCounter();
+        queue.Flush(nullptr);
+        double flushMs = Milliseconds(SDL_GetPerformanceCounter() - start);
+
+        std::cout << size << "  " << CountSwitches(unsorted) << "  " << queue.GetStats().textureSwitches << "  "
+                  << serialMs << "  " << parallelMs << "  " << stableMs << "  " << flushMs << std::endl;
+    }
+    return 0;
+}
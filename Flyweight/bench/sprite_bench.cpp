@@ -0,0 +1,156 @@
+/**
+ * @file sprite_bench.cpp
+ *
+ * @brief Benchmark of sprite-sheet flyweights with 100k animated instances.
+ *
+ * Compares advancing the animations of every instance in the structure-of-arrays AnimationSet
+ * with a conventional object per sprite that keeps a pointer to its sheet, its own frame table
+ * index and a float timer. Drawing is measured separately on an off-screen software renderer.
+ *
+ * Build and run from the Flyweight directory:
+ * @code
+ * make bench && ./bench/sprite_bench
+ * @endcode
+ */
+
+#include <SDL2/SDL.h>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include "Flyweight.h"
+#include "SpriteSheet.h"
+
+namespace
+{
+    constexpr int InstanceCount = 100000;
+    constexpr int FrameCount = 120;
+    constexpr std::uint32_t FrameStepMs = 16;
+    constexpr int SpriteSize = 16;
+    constexpr int SheetFrames = 8;
+
+    /**
+     * @brief The baseline: every sprite owns its animation state as an object.
+     */
+    struct AnimatedSprite
+    {
+        std::shared_ptr<const SpriteSheet> sheet;
+        int frame = 0;
+        float timeMs = 0.0f;
+        int x = 0;
+        int y = 0;
+
+        void Update(float deltaMs)
+        {
+            timeMs += deltaMs;
+            const std::uint16_t* durations = sheet->GetFrameDurations();
+            while (timeMs >= durations[frame])
+            {
+                timeMs -= durations[frame];
+                frame = (frame + 1) % sheet->GetFrameCount();
+            }
+        }
+    };
+
+    SDL_Surface* MakeSheet(const std::string&)
+    {
+        SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, SpriteSize * SheetFrames, SpriteSize, 32, SDL_PIXELFORMAT_RGBA32);
+        if (surface)
+        {
+            for (int frame = 0; frame < SheetFrames; ++frame)
+            {
+                SDL_Rect cell = {frame * SpriteSize, 0, SpriteSize, SpriteSize};
+                SDL_FillRect(surface, &cell, SDL_MapRGBA(surface->format, 32 * frame, 255 - 32 * frame, 128, 255));
+            }
+        }
+        return surface;
+    }
+
+    double Milliseconds(Uint64 ticks)
+    {
+        return 1000.0 * static_cast<double>(ticks) / SDL_GetPerformanceFrequency();
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    (void)argc;
+    (void)argv;
+
+    if (SDL_Init(0) != 0)
+    {
+        std::cerr << "SDL_Init Error: " << SDL_GetError() << std::endl;
+        return 1;
+    }
+
+    SDL_Surface* target = SDL_CreateRGBSurfaceWithFormat(0, 1280, 720, 32, SDL_PIXELFORMAT_ARGB8888);
+    SDL_Renderer* renderer = target ? SDL_CreateSoftwareRenderer(target) : nullptr;
+    if (!renderer)
+    {
+        std::cerr << "SDL_CreateSoftwareRenderer Error: " << SDL_GetError() << std::endl;
+        SDL_Quit();
+        return 1;
+    }
+
+    {
+        FlyweightFactory factory;
+        auto sheet = SpriteSheet::FromGrid(factory.GetTexture(renderer, "generated/sheet", MakeSheet),
+                                           SpriteSize, SpriteSize, SheetFrames, 100);
+
+        AnimationSet animations(sheet);
+        std::vector<AnimatedSprite> sprites(InstanceCount);
+        for (int i = 0; i < InstanceCount; ++i)
+        {
+            int x = (i * 7) % 1264;
+            int y = (i * 13) % 704;
+            animations.Add(x, y, static_cast<std::uint32_t>(i * 37));
+            sprites[i] = AnimatedSprite{sheet, 0, 0.0f, x, y};
+            sprites[i].Update(static_cast<float>(i * 37 % sheet->GetLoopDuration()));
+        }
+
+        Uint64 start = SDL_GetPerformanceCounter();
+        for (int frame = 0; frame < FrameCount; ++frame)
+        {
+            animations.Advance(FrameStepMs);
+        }
+        double soaMs = Milliseconds(SDL_GetPerformanceCounter() - start) / FrameCount;
+
+        start = SDL_GetPerformanceCounter();
+        for (int frame = 0; frame < FrameCount; ++frame)
+        {
+            for (AnimatedSprite& sprite : sprites)
+            {
+                sprite.Update(static_cast<float>(FrameStepMs));
+            }
+        }
+        double objectMs = Milliseconds(SDL_GetPerformanceCounter() - start) / FrameCount;
+
+        int mismatches = 0;
+        for (int i = 0; i < InstanceCount; ++i)
+        {
+            mismatches += animations.GetFrame(i) != sprites[i].frame;
+        }
+
+        start = SDL_GetPerformanceCounter();
+        for (int frame = 0; frame < 10; ++frame)
+        {
+            SDL_RenderClear(renderer);
+            animations.Draw(renderer);
+            SDL_RenderPresent(renderer);
+        }
+        double drawMs = Milliseconds(SDL_GetPerformanceCounter() - start) / 10;
+
+        std::cout << InstanceCount << " animated instances, " << AnimationSet::StateBytesPerInstance
+                  << " bytes of animation state each (object baseline: " << sizeof(AnimatedSprite) << " bytes)" << std::endl;
+        std::cout << "advance SoA:    " << soaMs << " ms/frame" << std::endl;
+        std::cout << "advance object: " << objectMs << " ms/frame" << std::endl;
+        std::cout << "draw:           " << drawMs << " ms/frame" << std::endl;
+        std::cout << "frame mismatches between the two: " << mismatches << std::endl;
+    }
+
+    SDL_DestroyRenderer(renderer);
+    SDL_FreeSurface(target);
+    SDL_Quit();
+    return 0;
+}
@@ -0,0 +1,138 @@
+/**
+ * @file static_layer_bench.cpp
+ *
+ * @brief Benchmark of static layer caching on a mostly static scene.
+ *
+ * The scene has 2000 static sprites and 20 moving ones, drawn on an off-screen software
+ * renderer. Frame time is compared between:
+ * - **immediate**: every sprite drawn every frame;
+ * - **cached**: static sprites composited from a StaticLayer that never changes;
+ * - **dirty region** / **full rebuild**: as cached, but one static sprite moves every frame.
+ *
+ * Build and run from the Flyweight directory:
+ * @code
+ * make bench && ./bench/static_layer_bench
+ * @endcode
+ */
+
+#include <SDL2/SDL.h>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Flyweight.h"
+#include "StaticLayer.h"
+
+namespace
+{
+    constexpr int StaticCount = 2000;
+    constexpr int DynamicCount = 20;
+    constexpr int FrameCount = 100;
+    constexpr int ScreenWidth = 1280;
+    constexpr int ScreenHeight = 720;
+    constexpr int SpriteSize = 128;
+
+    SDL_Surface* MakeSprite(const std::string&)
+    {
+        SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, SpriteSize, SpriteSize, 32, SDL_PIXELFORMAT_RGBA32);
+        if (surface)
+        {
+            SDL_FillRect(surface, nullptr, SDL_MapRGBA(surface->format, 160, 110, 60, 255));
+        }
+        return surface;
+    }
+
+    double Milliseconds(Uint64 ticks)
+    {
+        return 1000.0 * static_cast<double>(ticks) / SDL_GetPerformanceFrequency();
+    }
+
+    SDL_Point StaticPosition(int i)
+    {
+        return SDL_Point{(i * 53) % (ScreenWidth - SpriteSize / 4), (i * 97) % (ScreenHeight - SpriteSize / 4)};
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    (void)argc;
+    (void)argv;
+
+    if (SDL_Init(0) != 0)
+    {
+        std::cerr << "SDL_Init Error: " << SDL_GetError() << std::endl;
+        return 1;
+    }
+
+    SDL_Surface* screen = SDL_CreateRGBSurfaceWithFormat(0, ScreenWidth, ScreenHeight, 32, SDL_PIXELFORMAT_ARGB8888);
+    SDL_Renderer* renderer = screen ? SDL_CreateSoftwareRenderer(screen) : nullptr;
+    if (!renderer)
+    {
+        std::cerr << "SDL_CreateSoftwareRenderer Error: " << SDL_GetError() << std::endl;
+        SDL_Quit();
+        return 1;
+    }
+
+    {
+        FlyweightFactory factory;
+        std::shared_ptr<const Flyweight> sprite = factory.GetTexture(renderer, "generated/sprite", MakeSprite);
+
+        const char* names[] = {"immediate", "cached", "dirty region", "full rebuild"};
+        for (int mode = 0; mode < 4; ++mode)
+        {
+            StaticLayer layer(mode == 3 ? LayerInvalidation::FullRebuild : LayerInvalidation::DirtyRegion);
+            for (int i = 0; i < StaticCount; ++i)
+            {
+                SDL_Point position = StaticPosition(i);
+                layer.Add(sprite, position.x, position.y);
+            }
+
+            std::size_t redrawn = 0;
+            Uint64 start = SDL_GetPerformanceCounter();
+            for (int frame = 0; frame < FrameCount; ++frame)
+            {
+                SDL_SetRenderDrawColor(renderer, 135, 206, 250, 255);
+                SDL_RenderClear(renderer);
+
+                if (mode == 0)
+                {
+                    for (int i = 0; i < StaticCount; ++i)
+                    {
+                        SDL_Point position = StaticPosition(i);
+                        sprite->Draw(renderer, position.x, position.y);
+                    }
+                }
+                else
+                {
+                    if (mode >= 2)
+                    {
+                        SDL_Point position = StaticPosition(frame);
+                        layer.Move(static_cast<std::size_t>(frame), position.x + 5, position.y);
+                    }
+                    layer.Composite(renderer);
+                    redrawn += layer.GetStats().instancesRedrawn;
+                }
+
+                for (int i = 0; i < DynamicCount; ++i)
+                {
+                    sprite->Draw(renderer, (frame * 4 + i * 60) % ScreenWidth, (i * 35) % ScreenHeight);
+                }
+                SDL_RenderPresent(renderer);
+            }
+            double frameMs = Milliseconds(SDL_GetPerformanceCounter() - start) / FrameCount;
+
+            std::cout << names[mode] << ": " << frameMs << " ms/frame";
+            if (mode > 0)
+            {
+                std::cout << ", " << static_cast<double>(redrawn) / FrameCount << " static draws/frame";
+            }
+            std::cout << std::endl;
+        }
+    }
+
+    SDL_DestroyRenderer(renderer);
+    SDL_FreeSurface(screen);
+    SDL_Quit();
+    return 0;
+}
@@ -0,0 +1,139 @@
+/**
+ * @file streaming_bench.cpp
+ *
+ * @brief Benchmark of coverage-driven texture streaming.
+ *
+ * A world of 300 distinct 512x512 textures, eight screens wide, is panned across on an
+ * off-screen software renderer, paced at 60 frames per second so that background loads get the
+ * time they would have in a game. For several budgets the resident texture memory is compared
+ * with full residency, together with the resolution deficit it costs: the share of covered
+ * pixels drawn from a coarser tier than their on-screen size needs, and the average number of
+ * missing tiers per covered pixel.
+ *
+ * Build and run from the Flyweight directory:
+ * @code
+ * make bench && ./bench/streaming_bench
+ * @endcode
+ */
+
+#include <SDL2/SDL.h>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "TextureStreamer.h"
+
+namespace
+{
+    constexpr int TextureCount = 300;
+    constexpr int TextureSize = 512;
+    constexpr int FrameCount = 180;
+    constexpr Uint32 FramePeriodMs = 16;
+    constexpr int ScreenWidth = 1280;
+    constexpr int ScreenHeight = 720;
+    constexpr int WorldWidth = ScreenWidth * 8;
+    constexpr int PanSpeed = 24;
+
+    SDL_Surface* MakeTexture(const std::string& path)
+    {
+        const int seed = std::stoi(path.substr(path.find('/') + 1));
+        SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, TextureSize, TextureSize, 32, SDL_PIXELFORMAT_RGBA32);
+        if (surface)
+        {
+            SDL_FillRect(surface, nullptr, SDL_MapRGBA(surface->format, seed * 37 % 256, seed * 91 % 256, seed * 53 % 256, 255));
+        }
+        return surface;
+    }
+
+    double Milliseconds(Uint64 ticks)
+    {
+        return 1000.0 * static_cast<double>(ticks) / SDL_GetPerformanceFrequency();
+    }
+
+    SDL_Point Position(int instance)
+    {
+        return SDL_Point{(instance * 331) % WorldWidth, (instance * 173) % (ScreenHeight - TextureSize / 4)};
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    (void)argc;
+    (void)argv;
+
+    if (SDL_Init(0) != 0)
+    {
+        std::cerr << "SDL_Init Error: " << SDL_GetError() << std::endl;
+        return 1;
+    }
+
+    SDL_Surface* screen = SDL_CreateRGBSurfaceWithFormat(0, ScreenWidth, ScreenHeight, 32, SDL_PIXELFORMAT_ARGB8888);
+    SDL_Renderer* renderer = screen ? SDL_CreateSoftwareRenderer(screen) : nullptr;
+    if (!renderer)
+    {
+        std::cerr << "SDL_CreateSoftwareRenderer Error: " << SDL_GetError() << std::endl;
+        SDL_Quit();
+        return 1;
+    }
+
+    const double mebibyte = 1024.0 * 1024.0;
+    std::cout << "budget(MiB)  resident(MiB)  full(MiB)  saved  deficit px  tiers missing  loads  frame(ms)" << std::endl;
+    for (std::size_t budget : {2u, 4u, 8u, 16u, 32u})
+    {
+        TextureStreamer streamer(renderer, budget * 1024 * 1024, MakeTexture);
+        std::vector<std::shared_ptr<const StreamedTexture>> textures;
+        for (int i = 0; i < TextureCount; ++i)
+        {
+            textures.push_back(streamer.Get("generated/" + std::to_string(i)));
+        }
+
+        double deficitShare = 0.0;
+        double tierDeficit = 0.0;
+        Uint64 busy = 0;
+        for (int frame = 0; frame < FrameCount; ++frame)
+        {
+            const Uint64 frameStart = SDL_GetPerformanceCounter();
+            const int camera = frame * PanSpeed % (WorldWidth - ScreenWidth);
+            SDL_RenderClear(renderer);
+            for (int i = 0; i < TextureCount; ++i)
+            {
+                SDL_Point position = Position(i);
+                const int x = position.x - camera;
+                if (x > -TextureSize / 4 && x < ScreenWidth)
+                {
+                    textures[i]->Draw(renderer, x, position.y);
+                    streamer.AddCoverage(*textures[i], x, position.y);
+                }
+            }
+            streamer.Update();
+            SDL_RenderPresent(renderer);
+            busy += SDL_GetPerformanceCounter() - frameStart;
+
+            const Uint32 elapsed = static_cast<Uint32>(Milliseconds(SDL_GetPerformanceCounter() - frameStart));
+            if (elapsed < FramePeriodMs)
+            {
+                SDL_Delay(FramePeriodMs - elapsed);
+            }
+
+            const StreamingStats& stats = streamer.GetStats();
+            if (stats.coveredPixels > 0)
+            {
+                deficitShare += static_cast<double>(stats.deficitPixels) / stats.coveredPixels;
+            }
+            tierDeficit += stats.tierDeficit;
+        }
+        const double frameTime = Milliseconds(busy) / FrameCount;
+
+        const StreamingStats& stats = streamer.GetStats();
+        std::cout << budget << "  " << stats.residentBytes / mebibyte << "  " << stats.fullResolutionBytes / mebibyte << "  "
+                  << 100.0 * (stats.fullResolutionBytes - stats.residentBytes) / stats.fullResolutionBytes << "%  "
+                  << 100.0 * deficitShare / FrameCount << "%  " << tierDeficit / FrameCount << "  "
+                  << stats.loadsCompleted << "  " << frameTime << std::endl;
+    }
+
+    SDL_DestroyRenderer(renderer);
+    SDL_FreeSurface(screen);
+    SDL_Quit();
+    return 0;
+}
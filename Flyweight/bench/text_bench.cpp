@@ -0,0 +1,110 @@
+/**
+ * @file text_bench.cpp
+ *
+ * @brief Benchmark of glyph-atlas text rendering with 10k labels per frame.
+ *
+ * Renders into an off-screen software renderer so that it runs headless. Each frame one percent
+ * of the labels change their text, like HUD readouts do. Two modes are compared:
+ * - **cached**: TextLabel keeps its run and only lays out again when the text changes.
+ * - **immediate**: every label is laid out again every frame before being drawn.
+ *
+ * Build and run from the Flyweight directory:
+ * @code
+ * make bench && ./bench/text_bench
+ * @endcode
+ */
+
+#include <SDL2/SDL.h>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Flyweight.h"
+#include "GlyphCache.h"
+
+namespace
+{
+    constexpr int LabelCount = 10000;
+    constexpr int FrameCount = 60;
+    constexpr int ScreenWidth = 1280;
+    constexpr int ScreenHeight = 720;
+
+    std::string LabelText(int label, int frame)
+    {
+        int value = (label * 37 + frame * (label % 100 == frame % 100 ? 1 : 0)) % 1000;
+        return (label % 2 == 0 ? "HP " : "SCORE ") + std::to_string(value);
+    }
+
+    double Milliseconds(Uint64 ticks)
+    {
+        return 1000.0 * static_cast<double>(ticks) / SDL_GetPerformanceFrequency();
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    (void)argc;
+    (void)argv;
+
+    if (SDL_Init(0) != 0)
+    {
+        std::cerr << "SDL_Init Error: " << SDL_GetError() << std::endl;
+        return 1;
+    }
+
+    SDL_Surface* target = SDL_CreateRGBSurfaceWithFormat(0, ScreenWidth, ScreenHeight, 32, SDL_PIXELFORMAT_ARGB8888);
+    SDL_Renderer* renderer = target ? SDL_CreateSoftwareRenderer(target) : nullptr;
+    if (!renderer)
+    {
+        std::cerr << "SDL_CreateSoftwareRenderer Error: " << SDL_GetError() << std::endl;
+        SDL_Quit();
+        return 1;
+    }
+
+    {
+        FlyweightFactory factory;
+        GlyphCache glyphs(factory, renderer, "assets/font5x7.txt", 1);
+        std::vector<TextLabel> labels(LabelCount);
+
+        for (int mode = 0; mode < 2; ++mode)
+        {
+            const bool cached = mode == 0;
+            glyphs.ClearRuns();
+            labels.assign(LabelCount, TextLabel());
+            std::size_t layoutsBefore = glyphs.GetLayoutCount();
+
+            Uint64 start = SDL_GetPerformanceCounter();
+            for (int frame = 0; frame < FrameCount; ++frame)
+            {
+                SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+                SDL_RenderClear(renderer);
+                for (int i = 0; i < LabelCount; ++i)
+                {
+                    int x = (i * 64) % ScreenWidth;
+                    int y = ((i * 64) / ScreenWidth * 8) % ScreenHeight;
+                    if (cached)
+                    {
+                        labels[i].SetText(glyphs, LabelText(i, frame));
+                        labels[i].Draw(renderer, glyphs, x, y);
+                    }
+                    else
+                    {
+                        glyphs.Draw(renderer, *glyphs.BuildRun(LabelText(i, frame)), x, y);
+                    }
+                }
+                SDL_RenderPresent(renderer);
+            }
+            Uint64 elapsed = SDL_GetPerformanceCounter() - start;
+
+            std::cout << (cached ? "cached   " : "immediate") << ": "
+                      << Milliseconds(elapsed) / FrameCount << " ms/frame, "
+                      << static_cast<double>(glyphs.GetLayoutCount() - layoutsBefore) / FrameCount << " layouts/frame, "
+                      << glyphs.GetCachedRunCount() << " cached runs" << std::endl;
+        }
+    }
+
+    SDL_DestroyRenderer(renderer);
+    SDL_FreeSurface(target);
+    SDL_Quit();
+    return 0;
+}
@@ -0,0 +1,269 @@
+#include "DirtyRects.h"
+
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace
+{
+    /**< Beyond this many rectangles the screen is mostly dirty; one bounding box is cheaper. */
+    constexpr std::size_t CoarseMergeThreshold = 512;
+
+    std::int64_t Area(const SDL_Rect& rect)
+    {
+        return static_cast<std::int64_t>(rect.w) * rect.h;
+    }
+
+    /**
+     * @brief Pixels the bounding box of a and b covers that neither a nor b does.
+     */
+    std::int64_t MergeWaste(const SDL_Rect& a, const SDL_Rect& b)
+    {
+        SDL_Rect bounds;
+        SDL_Rect overlap;
+        SDL_UnionRect(&a, &b, &bounds);
+        std::int64_t shared = SDL_IntersectRect(&a, &b, &overlap) ? Area(overlap) : 0;
+        return Area(bounds) - (Area(a) + Area(b) - shared);
+    }
+
+    std::uint64_t ClippedArea(const SDL_Rect& rect, const SDL_Rect& clip)
+    {
+        SDL_Rect visible;
+        return SDL_IntersectRect(&rect, &clip, &visible) ? static_cast<std::uint64_t>(Area(visible)) : 0;
+    }
+}
+
+void MergeDamageRects(std::vector<SDL_Rect>& rects, std::size_t maxRects, std::int64_t mergeSlack)
+{
+    std::size_t kept = 0;
+    for (const SDL_Rect& rect : rects)
+    {
+        if (rect.w > 0 && rect.h > 0)
+        {
+            rects[kept++] = rect;
+        }
+    }
+    rects.resize(kept);
+
+    if (rects.size() > CoarseMergeThreshold)
+    {
+        SDL_Rect bounds = rects[0];
+        for (const SDL_Rect& rect : rects)
+        {
+            SDL_UnionRect(&bounds, &rect, &bounds);
+        }
+        rects.assign(1, bounds);
+        return;
+    }
+
+    // Merge everything that overlaps or is cheap to merge. A grown rect can reach rects that were
+    // already passed over, so repeat until a whole sweep merges nothing.
+    bool merged = true;
+    while (merged)
+    {
+        merged = false;
+        for (std::size_t i = 0; i < rects.size(); ++i)
+        {
+            for (std::size_t j = i + 1; j < rects.size();)
+            {
+                if (SDL_HasIntersection(&rects[i], &rects[j]) || MergeWaste(rects[i], rects[j]) <= mergeSlack)
+                {
+                    SDL_UnionRect(&rects[i], &rects[j], &rects[i]);
+                    rects[j] = rects.back();
+                    rects.pop_back();
+                    merged = true;
+                }
+                else
+                {
+                    ++j;
+                }
+            }
+        }
+    }
+
+    while (rects.size() > maxRects && rects.size() > 1)
+    {
+        std::size_t bestA = 0;
+        std::size_t bestB = 1;
+        std::int64_t bestWaste = std::numeric_limits<std::int64_t>::max();
+        for (std::size_t i = 0; i < rects.size(); ++i)
+        {
+            for (std::size_t j = i + 1; j < rects.size(); ++j)
+            {
+                std::int64_t waste = MergeWaste(rects[i], rects[j]);
+                if (waste < bestWaste)
+                {
+                    bestWaste = waste;
+                    bestA = i;
+                    bestB = j;
+                }
+            }
+        }
+        SDL_UnionRect(&rects[bestA], &rects[bestB], &rects[bestA]);
+        rects[bestB] = rects.back();
+        rects.pop_back();
+    }
+}
+
+
+DirtyRectScene::DirtyRectScene(SDL_Color background)
+    : background(background)
+{
+    DamageAll();
+}
+
+std::size_t DirtyRectScene::Add(std::shared_ptr<const Flyweight> flyweight, int x, int y)
+{
+    if (!flyweight)
+    {
+        throw std::invalid_argument("DirtyRectScene instances need a flyweight");
+    }
+
+    std::size_t id;
+    if (!freeSlots.empty())
+    {
+        id = freeSlots.back();
+        freeSlots.pop_back();
+        instances[id] = Instance{std::move(flyweight), x, y};
+    }
+    else
+    {
+        id = instances.size();
+        instances.push_back(Instance{std::move(flyweight), x, y});
+    }
+    Damage(instances[id]);
+    return id;
+}
+
+DirtyRectScene::Instance& DirtyRectScene::LiveInstance(std::size_t id)
+{
+    if (id >= instances.size() || !instances[id].flyweight)
+    {
+        throw std::out_of_range("DirtyRectScene has no instance " + std::to_string(id));
+    }
+    return instances[id];
+}
+
+void DirtyRectScene::Move(std::size_t id, int x, int y)
+{
+    Instance& instance = LiveInstance(id);
+    if (instance.x == x && instance.y == y)
+    {
+        return;
+    }
+    Damage(instance);
+    instance.x = x;
+    instance.y = y;
+    Damage(instance);
+}
+
+void DirtyRectScene::Replace(std::size_t id, std::shared_ptr<const Flyweight> flyweight)
+{
+    if (!flyweight)
+    {
+        throw std::invalid_argument("DirtyRectScene instances need a flyweight");
+    }
+    Instance& instance = LiveInstance(id);
+    Damage(instance);
+    instance.flyweight = std::move(flyweight);
+    Damage(instance);
+}
+
+void DirtyRectScene::Remove(std::size_t id)
+{
+    Instance& instance = LiveInstance(id);
+    Damage(instance);
+    instance.flyweight.reset();
+    freeSlots.push_back(id);
+}
+
+void DirtyRectScene::Damage(const Instance& instance)
+{
+    if (!instance.flyweight)
+    {
+        return;
+    }
+    SDL_Rect bounds = instance.flyweight->GetBounds(instance.x, instance.y);
+    if (bounds.w <= 0 || bounds.h <= 0)
+    {
+        DamageAll();
+        return;
+    }
+    pendingDamage.push_back(bounds);
+}
+
+void DirtyRectScene::Render(SDL_Renderer* renderer)
+{
+    stats = DirtyRectStats();
+
+    SDL_Rect screen = {0, 0, 0, 0};
+    SDL_GetRendererOutputSize(renderer, &screen.w, &screen.h);
+
+    lastDamage.clear();
+    for (const SDL_Rect& rect : pendingDamage)
+    {
+        SDL_Rect visible;
+        if (SDL_IntersectRect(&rect, &screen, &visible))
+        {
+            lastDamage.push_back(visible);
+        }
+    }
+    pendingDamage.clear();
+    MergeDamageRects(lastDamage);
+
+    SDL_SetRenderDrawColor(renderer, background.r, background.g, background.b, background.a);
+    for (const SDL_Rect& region : lastDamage)
+    {
+        SDL_RenderSetClipRect(renderer, &region);
+        SDL_RenderFillRect(renderer, &region);
+        stats.pixelsCleared += static_cast<std::uint64_t>(Area(region));
+
+        // Instances without bounds damage the whole screen, so they are drawn with it.
+        const bool wholeScreen = SDL_RectEquals(&region, &screen);
+
+        for (const Instance& instance : instances)
+        {
+            if (!instance.flyweight)
+            {
+                continue;
+            }
+            SDL_Rect bounds = instance.flyweight->GetBounds(instance.x, instance.y);
+            const bool unbounded = bounds.w <= 0 || bounds.h <= 0;
+            if (unbounded ? wholeScreen : SDL_HasIntersection(&bounds, &region) == SDL_TRUE)
+            {
+                instance.flyweight->Draw(renderer, instance.x, instance.y);
+                stats.pixelsDrawn += ClippedArea(bounds, region);
+                ++stats.draws;
+            }
+        }
+    }
+    SDL_RenderSetClipRect(renderer, nullptr);
+    stats.rects = lastDamage.size();
+}
+
+void DirtyRectScene::RenderFull(SDL_Renderer* renderer)
+{
+    stats = DirtyRectStats();
+
+    SDL_Rect screen = {0, 0, 0, 0};
+    SDL_GetRendererOutputSize(renderer, &screen.w, &screen.h);
+
+    SDL_SetRenderDrawColor(renderer, background.r, background.g, background.b, background.a);
+    SDL_RenderClear(renderer);
+    stats.pixelsCleared = static_cast<std::uint64_t>(Area(screen));
+
+    for (const Instance& instance : instances)
+    {
+        if (instance.flyweight)
+        {
+            instance.flyweight->Draw(renderer, instance.x, instance.y);
+            stats.pixelsDrawn += ClippedArea(instance.flyweight->GetBounds(instance.x, instance.y), screen);
+            ++stats.draws;
+        }
+    }
+
+    pendingDamage.clear();
+    lastDamage.assign(1, screen);
+    stats.rects = 1;
+}
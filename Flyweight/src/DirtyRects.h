@@ -0,0 +1,106 @@
+#ifndef DIRTY_RECTS_H
+#define DIRTY_RECTS_H
+
+#include <SDL2/SDL.h>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "Flyweight.h"
+
+/**
+ * @brief Merges damage rectangles into a small set that still covers every damaged pixel.
+ *
+ * Overlapping rectangles are always merged. Disjoint ones are merged when their bounding box
+ * wastes fewer pixels than mergeSlack, because one larger rect is cheaper than two small ones
+ * (fewer clip changes and draw passes). If more than maxRects remain, the pairs that waste the
+ * fewest pixels are merged until the limit is met.
+ *
+ * @param rects The rectangles to merge, in place. Empty rectangles are dropped.
+ * @param maxRects Upper bound on the number of rectangles left.
+ * @param mergeSlack Pixels a merge may add beyond the pixels the two rectangles already cover.
+ */
+void MergeDamageRects(std::vector<SDL_Rect>& rects, std::size_t maxRects = 16, std::int64_t mergeSlack = 1024);
+
+/**
+ * @brief What the last DirtyRectScene::Render call touched.
+ */
+struct DirtyRectStats
+{
+    std::size_t rects = 0;            /**< Damage rectangles after merging. */
+    std::uint64_t pixelsCleared = 0;  /**< Background pixels filled. */
+    std::uint64_t pixelsDrawn = 0;    /**< Sprite pixels written, after clipping. */
+    std::size_t draws = 0;            /**< Flyweight draw calls issued. */
+};
+
+/**
+ * @brief Scene of flyweight instances redrawn only where something changed.
+ *
+ * Meant for CPU renderers that keep the previous frame, such as a software SDL_Renderer on the
+ * window surface. Instead of clearing and redrawing everything, Render clears and redraws only
+ * the damage: the old and new bounds of instances that were added, moved, changed or removed.
+ * Damage rectangles are merged into a small set, each of which is cleared to the background and
+ * repainted, clipped, by every instance that intersects it, in scene order. Present the result
+ * with SDL_UpdateWindowSurfaceRects(window, GetDamage()) to also copy only those pixels.
+ */
+class DirtyRectScene
+{
+private:
+    struct Instance
+    {
+        std::shared_ptr<const Flyweight> flyweight;
+        int x;
+        int y;
+    };
+
+    std::vector<Instance> instances;
+    std::vector<std::size_t> freeSlots;
+
+    /**< Damage accumulated since the last Render. */
+    std::vector<SDL_Rect> pendingDamage;
+    /**< Merged damage repainted by the last Render. */
+    std::vector<SDL_Rect> lastDamage;
+    SDL_Color background;
+
+    DirtyRectStats stats;
+
+    Instance& LiveInstance(std::size_t id);
+    void Damage(const Instance& instance);
+
+public:
+    explicit DirtyRectScene(SDL_Color background);
+
+    /**
+     * Add and Replace throw std::invalid_argument for a null flyweight. Move, Replace and Remove
+     * throw std::out_of_range for an id that was never added or was removed already.
+     */
+    std::size_t Add(std::shared_ptr<const Flyweight> flyweight, int x, int y);
+    void Move(std::size_t id, int x, int y);
+    void Replace(std::size_t id, std::shared_ptr<const Flyweight> flyweight);
+    void Remove(std::size_t id);
+
+    /**
+     * @brief Marks the whole screen as damaged, e.g. after the window was exposed or resized.
+     */
+    void DamageAll() { pendingDamage.assign(1, SDL_Rect{0, 0, 1 << 20, 1 << 20}); }
+
+    /**
+     * @brief Repaints the damaged regions on the current render target.
+     */
+    void Render(SDL_Renderer* renderer);
+
+    /**
+     * @brief Clears the whole target and redraws every instance, for comparison.
+     */
+    void RenderFull(SDL_Renderer* renderer);
+
+    /**
+     * @brief Returns the merged damage of the last Render, clipped to the screen.
+     */
+    const std::vector<SDL_Rect>& GetDamage() const { return lastDamage; }
+
+    const DirtyRectStats& GetStats() const { return stats; }
+};
+
+#endif
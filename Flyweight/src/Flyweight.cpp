@@ -0,0 +1,255 @@
+#include "Flyweight.h"
+
+#include <SDL2/SDL_image.h>
+#include <atomic>
+#include <algorithm>
+#include <cctype>
+#include <iostream>
+#include <stdexcept>
+
+#include "PixelHash.h"
+#include "PngDecoder.h"
+
+namespace
+{
+    double SecondsSince(Uint64 start)
+    {
+        return static_cast<double>(SDL_GetPerformanceCounter() - start) / SDL_GetPerformanceFrequency();
+    }
+
+    bool HasPngExtension(const std::string& path)
+    {
+        if (path.size() < 4)
+        {
+            return false;
+        }
+        std::string extension = path.substr(path.size() - 4);
+        for (char& c : extension)
+        {
+            c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        }
+        return extension == ".png";
+    }
+
+    /**
+     * @brief Frees an SDL_Surface when leaving scope, including on exceptions.
+     */
+    struct SurfaceGuard
+    {
+        SDL_Surface* surface;
+        ~SurfaceGuard() { SDL_FreeSurface(surface); }
+    };
+}
+
+
+bool IsFullyOpaque(SDL_Surface* surface)
+{
+    if (SDL_HasColorKey(surface))
+    {
+        return false;
+    }
+    const Uint32 alphaMask = surface->format->Amask;
+    if (alphaMask == 0)
+    {
+        // Paletted surfaces may carry alpha in their palette; only trust formats without alpha.
+        return surface->format->palette == nullptr;
+    }
+    if (surface->format->BytesPerPixel != 4)
+    {
+        return false;
+    }
+
+    for (int y = 0; y < surface->h; ++y)
+    {
+        const Uint32* row = reinterpret_cast<const Uint32*>(static_cast<const Uint8*>(surface->pixels) + y * surface->pitch);
+        Uint32 combined = alphaMask;
+        for (int x = 0; x < surface->w; ++x)
+        {
+            combined &= row[x];
+        }
+        if ((combined & alphaMask) != alphaMask)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+Flyweight::Flyweight()
+{
+    static std::atomic<std::uint32_t> nextId{1};
+    id = nextId.fetch_add(1, std::memory_order_relaxed);
+}
+
+TextureFlyweight::TextureFlyweight(SDL_Renderer* renderer, const std::string& filePath)
+{
+    SDL_Surface* surface = IMG_Load(filePath.c_str());
+    if (!surface)
+    {
+        throw std::runtime_error("Failed to load image: " + filePath);
+    }
+    SurfaceGuard guard{surface};
+    texture = SDL_CreateTextureFromSurface(renderer, surface);
+    if (!texture)
+    {
+        throw std::runtime_error("Failed to create texture: " + filePath);
+    }
+    width = surface->w / 4;
+    height = surface->h / 4;
+    byteSize = static_cast<std::size_t>(surface->w) * surface->h * 4;
+    opaque = IsFullyOpaque(surface);
+}
+
+TextureFlyweight::TextureFlyweight(SDL_Renderer* renderer, SDL_Surface* surface)
+{
+    texture = SDL_CreateTextureFromSurface(renderer, surface);
+    if (!texture)
+    {
+        throw std::runtime_error(std::string("Failed to create texture: ") + SDL_GetError());
+    }
+    width = surface->w / 4;
+    height = surface->h / 4;
+    byteSize = static_cast<std::size_t>(surface->w) * surface->h * 4;
+    opaque = IsFullyOpaque(surface);
+}
+
+TextureFlyweight::~TextureFlyweight()
+{
+    SDL_DestroyTexture(texture);
+}
+
+void TextureFlyweight::Draw(SDL_Renderer* renderer, int x, int y) const
+{
+    SDL_Rect dstRect = {x, y, width, height};
+    SDL_RenderCopy(renderer, texture, nullptr, &dstRect);
+}
+
+
+FlyweightFactory::FlyweightFactory(std::size_t budgetBytes)
+    : textures({}, budgetBytes, [](const TextureFlyweight& flyweight) { return flyweight.GetByteSize(); })
+{
+}
+
+std::shared_ptr<const Flyweight> FlyweightFactory::GetFlyweight(SDL_Renderer* renderer, const std::string& filePath)
+{
+    if (!textures.Contains(filePath))
+    {
+        std::cout << "Creating new Flyweight for: " << filePath << std::endl;
+    }
+    else
+    {
+        std::cout << "Reusing existing Flyweight for: " << filePath << std::endl;
+    }
+
+    return GetTexture(renderer, filePath);
+}
+
+std::shared_ptr<const TextureFlyweight> FlyweightFactory::GetTexture(SDL_Renderer* renderer, const std::string& filePath)
+{
+    const bool builtin = builtinPngDecoder && HasPngExtension(filePath);
+    const Uint32 format = builtin ? GetNativePngFormat(renderer) : SDL_PIXELFORMAT_UNKNOWN;
+    return GetTexture(renderer, filePath, [builtin, format](const std::string& path)
+    {
+        if (builtin)
+        {
+            if (SDL_Surface* surface = LoadPngSurface(path, format))
+            {
+                return surface;
+            }
+        }
+        return IMG_Load(path.c_str());
+    });
+}
+
+std::shared_ptr<const TextureFlyweight> FlyweightFactory::GetTexture(SDL_Renderer* renderer, const std::string& key, const Decoder& decode)
+{
+    auto handle = textures.Get(key, [this, renderer, &decode](const std::string& path)
+    {
+        return LoadTexture(renderer, path, decode);
+    });
+    return handle.Share();
+}
+
+std::shared_ptr<TextureFlyweight> FlyweightFactory::LoadTexture(SDL_Renderer* renderer, const std::string& key, const Decoder& decode)
+{
+    Uint64 start = SDL_GetPerformanceCounter();
+    SDL_Surface* surface = decode(key);
+    if (!surface)
+    {
+        throw std::runtime_error("Failed to load image: " + key);
+    }
+    SurfaceGuard guard{surface};
+    dedupStats.decodeSeconds += SecondsSince(start);
+
+    if (!deduplicateContent)
+    {
+        return std::make_shared<TextureFlyweight>(renderer, surface);
+    }
+
+    start = SDL_GetPerformanceCounter();
+    const std::uint64_t contentHash = HashSurfacePixels(surface);
+    const std::uint64_t checkHash = CheckHashSurfacePixels(surface);
+    dedupStats.hashSeconds += SecondsSince(start);
+    dedupStats.bytesHashed += static_cast<std::size_t>(surface->w) * surface->h * surface->format->BytesPerPixel;
+    ++dedupStats.imagesDecoded;
+
+    // An equal hash only makes a candidate; share the texture if the check hash agrees too.
+    auto candidates = texturesByContent.equal_range(contentHash);
+    for (auto it = candidates.first; it != candidates.second;)
+    {
+        const ContentEntry& entry = it->second;
+        auto shared = entry.texture.lock();
+        if (!shared)
+        {
+            it = texturesByContent.erase(it);
+            continue;
+        }
+        if (entry.width == surface->w && entry.height == surface->h && entry.format == surface->format->format
+            && entry.checkHash == checkHash)
+        {
+            std::cout << "Identical pixels, sharing texture for: " << key << std::endl;
+            ++dedupStats.duplicatesFound;
+            dedupStats.bytesSaved += shared->GetByteSize();
+            return shared;
+        }
+        ++it;
+    }
+
+    auto flyweight = std::make_shared<TextureFlyweight>(renderer, surface);
+    texturesByContent.emplace(contentHash, ContentEntry{flyweight, surface->w, surface->h, surface->format->format, checkHash});
+    if (texturesByContent.size() >= contentSweepSize)
+    {
+        PruneContentIndex();
+        contentSweepSize = std::max<std::size_t>(64, texturesByContent.size() * 2);
+    }
+    return flyweight;
+}
+
+void FlyweightFactory::PruneContentIndex()
+{
+    for (auto it = texturesByContent.begin(); it != texturesByContent.end();)
+    {
+        if (it->second.texture.expired())
+        {
+            it = texturesByContent.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+void FlyweightFactory::PrintDedupReport(std::ostream& out) const
+{
+    const double hashedMegabytes = dedupStats.bytesHashed / (1024.0 * 1024.0);
+    out << "Texture deduplication: " << dedupStats.duplicatesFound << " of " << dedupStats.imagesDecoded
+        << " images were duplicates, " << dedupStats.bytesSaved / 1024 << " KiB of texture memory saved" << std::endl;
+    out << "Hashing cost: " << dedupStats.hashSeconds * 1000.0 << " ms for " << hashedMegabytes << " MiB";
+    if (dedupStats.hashSeconds > 0.0)
+    {
+        out << " (" << hashedMegabytes / dedupStats.hashSeconds << " MiB/s)";
+    }
+    out << ", decoding took " << dedupStats.decodeSeconds * 1000.0 << " ms" << std::endl;
+}
@@ -0,0 +1,288 @@
+#ifndef FLYWEIGHT_H
+#define FLYWEIGHT_H
+
+#include <SDL2/SDL.h>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <limits>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "ResourceCache.h"
+
+/**
+ * @brief Abstract base class representing the Flyweight interface.
+ *
+ * Defines the common interface for all flyweight objects.
+ * Flyweights provide shared resources and operations that depend on unique parameters.
+ */
+class Flyweight
+{
+private:
+    /**< Unique id of this flyweight, used to group draws that share it. */
+    std::uint32_t id;
+
+protected:
+    Flyweight();
+
+public:
+    /**
+     * @brief Renders the flyweight on the screen at the specified position.
+     *
+     * @param renderer The SDL_Renderer used for rendering.
+     * @param x The x-coordinate for the rendering position.
+     * @param y The y-coordinate for the rendering position.
+     */
+    virtual void Draw(SDL_Renderer* renderer, int x, int y) const = 0;
+
+    /**
+     * @brief Returns the screen area Draw covers when drawn at the given position.
+     *
+     * Used to invalidate cached layers and skip hidden draws. An empty rect means the area is
+     * unknown, and callers must then assume the flyweight may cover anything.
+     */
+    virtual SDL_Rect GetBounds(int x, int y) const { return SDL_Rect{x, y, 0, 0}; }
+
+    /**
+     * @brief Returns true if Draw writes every pixel of GetBounds fully opaque.
+     *
+     * Opaque flyweights hide whatever was drawn below them, which occlusion culling relies on.
+     */
+    virtual bool IsOpaque() const { return false; }
+
+    /**
+     * @brief Virtual destructor for Flyweight.
+     */
+    virtual ~Flyweight() = default;
+
+    /**
+     * @brief Returns the id assigned to this flyweight at creation. Ids are never reused.
+     */
+    std::uint32_t GetId() const { return id; }
+};
+
+/**
+ * @brief Returns true if every pixel of the surface has full alpha and no color key applies.
+ *
+ * Conservative: surfaces whose alpha cannot be checked cheaply count as translucent.
+ */
+bool IsFullyOpaque(SDL_Surface* surface);
+
+/**
+ * @brief Concrete implementation of the Flyweight interface for textures.
+ *
+ * This class represents a texture that is shared between multiple instances.
+ * It handles the loading and rendering of an SDL_Texture.
+ */
+class TextureFlyweight : public Flyweight
+{
+private:
+    /**< The shared GPU texture. */
+    SDL_Texture* texture;
+
+    /**< Size the texture is drawn at. */
+    int width, height;
+
+    /**< Approximate memory held by the texture, used for cache budgeting. */
+    std::size_t byteSize;
+
+    /**< Every pixel of the image has full alpha. */
+    bool opaque;
+
+public:
+    /**
+     * @brief Constructs a TextureFlyweight and loads the texture from a file.
+     *
+     * @param renderer The SDL_Renderer used to create the texture.
+     * @param filePath The file path of the texture to load.
+     * @throws std::runtime_error If the texture cannot be loaded.
+     */
+    TextureFlyweight(SDL_Renderer* renderer, const std::string& filePath);
+
+    /**
+     * @brief Constructs a TextureFlyweight from already decoded pixels.
+     *
+     * @param renderer The SDL_Renderer used to create the texture.
+     * @param surface The decoded image. Ownership stays with the caller.
+     * @throws std::runtime_error If the texture cannot be created.
+     */
+    TextureFlyweight(SDL_Renderer* renderer, SDL_Surface* surface);
+
+    TextureFlyweight(const TextureFlyweight&) = delete;
+    TextureFlyweight& operator=(const TextureFlyweight&) = delete;
+
+    /**
+     * @brief Destructor that releases the texture resource.
+     */
+    ~TextureFlyweight() override;
+
+    /**
+     * @brief Renders the texture at the specified position.
+     *
+     * @param renderer The SDL_Renderer used for rendering.
+     * @param x The x-coordinate for the rendering position.
+     * @param y The y-coordinate for the rendering position.
+     */
+    void Draw(SDL_Renderer* renderer, int x, int y) const override;
+
+    SDL_Rect GetBounds(int x, int y) const override { return SDL_Rect{x, y, width, height}; }
+
+    bool IsOpaque() const override { return opaque; }
+
+    /**
+     * @brief Renders a region of the texture, for atlases shared by many small images.
+     *
+     * @param renderer The SDL_Renderer used for rendering.
+     * @param source The region of the texture to draw, in texels.
+     * @param destination Where to draw it on the render target.
+     */
+    void DrawRegion(SDL_Renderer* renderer, const SDL_Rect& source, const SDL_Rect& destination) const
+    {
+        SDL_RenderCopy(renderer, texture, &source, &destination);
+    }
+
+    SDL_Texture* GetTexture() const { return texture; }
+
+    std::size_t GetByteSize() const { return byteSize; }
+};
+
+/**
+ * @brief Statistics of content-level texture deduplication.
+ */
+struct DedupStats
+{
+    std::size_t imagesDecoded = 0;    /**< Images decoded and hashed. */
+    std::size_t duplicatesFound = 0;  /**< Images whose pixels matched an already loaded texture. */
+    std::size_t bytesHashed = 0;      /**< Pixel bytes hashed, each by both hashes. */
+    std::size_t bytesSaved = 0;       /**< Texture memory not allocated thanks to deduplication. */
+    double hashSeconds = 0.0;         /**< Time spent hashing pixels. */
+    double decodeSeconds = 0.0;       /**< Time spent decoding images, for comparison. */
+};
+
+/**
+ * @brief Factory class for creating and managing Flyweight objects.
+ *
+ * This class maintains a cache of flyweight objects to ensure that shared resources are reused
+ * and avoids redundant creation of the same flyweights. Textures are simply the
+ * ResourceCache<TextureFlyweight> instantiation of the generic resource cache.
+ *
+ * Besides the file path, textures are also deduplicated by content: the decoded pixels are hashed
+ * and paths that decode to identical pixels share one TextureFlyweight. This catches the copies of
+ * the same image that modded content tends to ship under different names. A matching hash is only
+ * a candidate: the size, format and a second, independent hash of the pixels must match too before
+ * a texture is shared, so showing the wrong texture would take two 64-bit hashes colliding at once.
+ * Both hashes are kept per texture, not its pixels.
+ */
+class FlyweightFactory
+{
+private:
+    /**< Cache of texture flyweights mapped by file paths. */
+    ResourceCache<TextureFlyweight> textures;
+
+    /**
+     * @brief A texture indexed by content, with what confirms a hash match.
+     */
+    struct ContentEntry
+    {
+        std::weak_ptr<TextureFlyweight> texture;
+        int width;
+        int height;
+        Uint32 format;
+        std::uint64_t checkHash; /**< CheckHashSurfacePixels of the texture's pixels. */
+    };
+
+    /**< Texture flyweights mapped by the hash of their decoded pixels; expired ones are pruned. */
+    std::unordered_multimap<std::uint64_t, ContentEntry> texturesByContent;
+
+    /**< Size of texturesByContent at which expired entries are swept out. */
+    std::size_t contentSweepSize = 64;
+
+    bool deduplicateContent = true;
+    bool builtinPngDecoder = true;
+    DedupStats dedupStats;
+
+public:
+    /**
+     * @brief Produces the pixels of a texture for a key. Returns nullptr on failure.
+     *
+     * The returned surface is owned and freed by the factory.
+     */
+    using Decoder = std::function<SDL_Surface*(const std::string&)>;
+
+private:
+    std::shared_ptr<TextureFlyweight> LoadTexture(SDL_Renderer* renderer, const std::string& key, const Decoder& decode);
+
+    /**
+     * @brief Erases the content entries of textures that are no longer alive.
+     */
+    void PruneContentIndex();
+
+public:
+    /**
+     * @brief Constructs a factory.
+     *
+     * @param budgetBytes Texture memory kept alive for flyweights no client references anymore.
+     */
+    explicit FlyweightFactory(std::size_t budgetBytes = std::numeric_limits<std::size_t>::max());
+
+    /**
+     * @brief Retrieves a Flyweight object for the given file path.
+     *
+     * If the flyweight for the file path does not exist, it creates a new one. Otherwise,
+     * it reuses the existing flyweight from the cache. Must be called on the render thread.
+     *
+     * @param renderer The SDL_Renderer used to create new textures if needed.
+     * @param filePath The file path of the texture.
+     * @return A shared pointer to the Flyweight object.
+     */
+    std::shared_ptr<const Flyweight> GetFlyweight(SDL_Renderer* renderer, const std::string& filePath);
+
+    /**
+     * @brief Retrieves a texture flyweight whose pixels come from a custom decoder.
+     *
+     * Used for textures that are generated rather than loaded from an image file, such as glyph
+     * atlases rasterized from a bitmap font. The decoder only runs on a cache miss, and its output
+     * takes part in content-hash deduplication like any other texture.
+     *
+     * @param renderer The SDL_Renderer used to create new textures if needed.
+     * @param key The cache key, usually the path of the source file.
+     * @param decode Produces the pixels for the key.
+     * @return A shared pointer to the TextureFlyweight.
+     */
+    std::shared_ptr<const TextureFlyweight> GetTexture(SDL_Renderer* renderer, const std::string& key, const Decoder& decode);
+
+    /**
+     * @brief Retrieves a texture flyweight decoded from an image file.
+     *
+     * PNG files go through the built-in decoder, straight into the renderer's native pixel format,
+     * unless it is disabled or does not support the file. Everything else is decoded by SDL_image.
+     */
+    std::shared_ptr<const TextureFlyweight> GetTexture(SDL_Renderer* renderer, const std::string& filePath);
+
+    /**
+     * @brief Gives direct access to the texture cache (budget, eviction, statistics).
+     */
+    ResourceCache<TextureFlyweight>& GetTextureCache() { return textures; }
+
+    /**
+     * @brief Enables or disables content-hash deduplication for textures loaded from now on.
+     */
+    void SetContentDeduplication(bool enabled) { deduplicateContent = enabled; }
+
+    /**
+     * @brief Enables or disables the built-in PNG decoder for files loaded from now on.
+     */
+    void SetBuiltinPngDecoder(bool enabled) { builtinPngDecoder = enabled; }
+
+    const DedupStats& GetDedupStats() const { return dedupStats; }
+
+    /**
+     * @brief Prints the memory saved by deduplication and what the hashing cost during load.
+     */
+    void PrintDedupReport(std::ostream& out) const;
+};
+
+#endif
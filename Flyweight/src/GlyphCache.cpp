@@ -0,0 +1,228 @@
+#include "GlyphCache.h"
+
+#include <cctype>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace
+{
+    constexpr int AtlasColumns = 16;
+
+    /**
+     * @brief Glyph bitmaps as read from the font file, one row string per pixel row.
+     */
+    struct FontDefinition
+    {
+        int cellWidth = 0;
+        int cellHeight = 0;
+        std::vector<std::pair<unsigned char, std::vector<std::string>>> glyphs;
+    };
+
+    FontDefinition ParseFont(const std::string& fontPath)
+    {
+        std::ifstream file(fontPath);
+        if (!file.is_open())
+        {
+            throw std::runtime_error("Failed to open font: " + fontPath);
+        }
+
+        FontDefinition font;
+        std::string line;
+        while (std::getline(file, line))
+        {
+            if (line.empty() || line[0] == '#')
+            {
+                continue;
+            }
+
+            std::istringstream header(line);
+            std::string keyword;
+            header >> keyword;
+            if (keyword == "cell")
+            {
+                header >> font.cellWidth >> font.cellHeight;
+            }
+            else if (keyword == "glyph")
+            {
+                std::string name;
+                header >> name;
+                if (font.cellHeight <= 0 || name.empty())
+                {
+                    throw std::runtime_error("Malformed glyph header in font: " + fontPath);
+                }
+
+                unsigned char character = name == "space" ? ' ' : static_cast<unsigned char>(name[0]);
+                std::vector<std::string> rows;
+                for (int row = 0; row < font.cellHeight && std::getline(file, line); ++row)
+                {
+                    if (static_cast<int>(line.size()) < font.cellWidth)
+                    {
+                        throw std::runtime_error("Short glyph row in font: " + fontPath);
+                    }
+                    rows.push_back(line);
+                }
+                if (static_cast<int>(rows.size()) != font.cellHeight)
+                {
+                    throw std::runtime_error("Truncated glyph in font: " + fontPath);
+                }
+                if (character < 128)
+                {
+                    font.glyphs.emplace_back(character, std::move(rows));
+                }
+            }
+        }
+
+        if (font.cellWidth <= 0 || font.cellHeight <= 0 || font.glyphs.empty())
+        {
+            throw std::runtime_error("Font has no glyphs: " + fontPath);
+        }
+        return font;
+    }
+
+    /**
+     * @brief Returns the atlas region of the n-th glyph. Cells are padded by one texel so that
+     *        filtering never bleeds a neighbouring glyph in.
+     */
+    SDL_Rect AtlasCell(const FontDefinition& font, std::size_t index)
+    {
+        int column = static_cast<int>(index) % AtlasColumns;
+        int row = static_cast<int>(index) / AtlasColumns;
+        return SDL_Rect{column * (font.cellWidth + 1), row * (font.cellHeight + 1), font.cellWidth, font.cellHeight};
+    }
+
+    SDL_Surface* RasterizeAtlas(const FontDefinition& font)
+    {
+        int rows = static_cast<int>((font.glyphs.size() + AtlasColumns - 1) / AtlasColumns);
+        SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, AtlasColumns * (font.cellWidth + 1),
+                                                              rows * (font.cellHeight + 1), 32, SDL_PIXELFORMAT_RGBA32);
+        if (!surface)
+        {
+            return nullptr;
+        }
+
+        SDL_FillRect(surface, nullptr, SDL_MapRGBA(surface->format, 255, 255, 255, 0));
+        const Uint32 lit = SDL_MapRGBA(surface->format, 255, 255, 255, 255);
+        for (std::size_t index = 0; index < font.glyphs.size(); ++index)
+        {
+            SDL_Rect cell = AtlasCell(font, index);
+            const std::vector<std::string>& bitmap = font.glyphs[index].second;
+            for (int y = 0; y < font.cellHeight; ++y)
+            {
+                Uint32* row = reinterpret_cast<Uint32*>(static_cast<Uint8*>(surface->pixels) + (cell.y + y) * surface->pitch);
+                for (int x = 0; x < font.cellWidth; ++x)
+                {
+                    if (bitmap[y][x] == '#')
+                    {
+                        row[cell.x + x] = lit;
+                    }
+                }
+            }
+        }
+        return surface;
+    }
+}
+
+
+GlyphCache::GlyphCache(FlyweightFactory& factory, SDL_Renderer* renderer, const std::string& fontPath, int scale,
+                       std::size_t maxRuns)
+    : scale(scale), maxRuns(maxRuns)
+{
+    FontDefinition font = ParseFont(fontPath);
+    cellWidth = font.cellWidth;
+    cellHeight = font.cellHeight;
+
+    for (std::size_t index = 0; index < font.glyphs.size(); ++index)
+    {
+        glyphRects[font.glyphs[index].first] = AtlasCell(font, index);
+    }
+
+    atlas = factory.GetTexture(renderer, fontPath, [&font](const std::string&)
+    {
+        return RasterizeAtlas(font);
+    });
+}
+
+std::shared_ptr<const TextRun> GlyphCache::Layout(const std::string& text)
+{
+    auto cached = runs.find(text);
+    if (cached != runs.end())
+    {
+        lru.splice(lru.begin(), lru, cached->second.lruPosition);
+        return cached->second.run;
+    }
+
+    auto run = BuildRun(text);
+    if (maxRuns == 0)
+    {
+        return run;
+    }
+    if (runs.size() >= maxRuns)
+    {
+        runs.erase(lru.back());
+        lru.pop_back();
+    }
+    lru.push_front(text);
+    runs.emplace(text, CachedRun{run, lru.begin()});
+    return run;
+}
+
+std::shared_ptr<const TextRun> GlyphCache::BuildRun(const std::string& text)
+{
+    ++layoutCount;
+
+    auto run = std::make_shared<TextRun>();
+    run->quads.reserve(text.size());
+
+    const int advance = (cellWidth + 1) * scale;
+    const int lineHeight = (cellHeight + 1) * scale;
+    int penX = 0;
+    int penY = 0;
+
+    for (char c : text)
+    {
+        if (c == '\n')
+        {
+            penX = 0;
+            penY += lineHeight;
+            continue;
+        }
+
+        unsigned char character = static_cast<unsigned char>(c);
+        if (character >= 128)
+        {
+            character = '?';
+        }
+        if (glyphRects[character].w == 0)
+        {
+            character = static_cast<unsigned char>(std::toupper(character));
+        }
+        if (glyphRects[character].w == 0 && character != ' ')
+        {
+            character = '?';
+        }
+
+        if (character != ' ' && glyphRects[character].w != 0)
+        {
+            SDL_Rect destination = {penX, penY, cellWidth * scale, cellHeight * scale};
+            run->quads.push_back(GlyphQuad{glyphRects[character], destination});
+        }
+        penX += advance;
+        if (penX > run->width)
+        {
+            run->width = penX;
+        }
+    }
+
+    run->height = penY + cellHeight * scale;
+    return run;
+}
+
+void GlyphCache::Draw(SDL_Renderer* renderer, const TextRun& run, int x, int y) const
+{
+    for (const GlyphQuad& quad : run.quads)
+    {
+        SDL_Rect destination = {x + quad.destination.x, y + quad.destination.y, quad.destination.w, quad.destination.h};
+        atlas->DrawRegion(renderer, quad.source, destination);
+    }
+}
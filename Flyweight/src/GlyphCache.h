@@ -0,0 +1,163 @@
+#ifndef GLYPH_CACHE_H
+#define GLYPH_CACHE_H
+
+#include <SDL2/SDL.h>
+#include <array>
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Flyweight.h"
+
+/**
+ * @brief One glyph of a laid out string: where it is in the atlas and where it goes on screen.
+ */
+struct GlyphQuad
+{
+    SDL_Rect source;       /**< Glyph region inside the atlas texture. */
+    SDL_Rect destination;  /**< Position relative to the origin of the string. */
+};
+
+/**
+ * @brief A laid out string, ready to be submitted without any further layout work.
+ *
+ * Runs are immutable and shared between every label showing the same text.
+ */
+struct TextRun
+{
+    std::vector<GlyphQuad> quads;
+    int width = 0;
+    int height = 0;
+};
+
+/**
+ * @brief Flyweight cache of glyphs and laid out strings.
+ *
+ * Two levels of sharing:
+ * - **Glyphs**: the bitmap font file is rasterized once into an atlas texture obtained through
+ *   FlyweightFactory, so every GlyphCache using the same font shares one SDL_Texture.
+ * - **Strings**: the quads of a string are computed once and cached by text. Drawing a cached
+ *   run is only one SDL_RenderCopy per glyph, with no per-frame layout. Readouts such as a score
+ *   produce new strings all session long, so only the most recently used runs are kept.
+ *
+ * The font format is a plain text file (see assets/font5x7.txt): a `cell <width> <height>` header
+ * followed by `glyph <character>` blocks of `#` and `.` rows.
+ */
+class GlyphCache
+{
+private:
+    /**< The atlas holding every glyph of the font. */
+    std::shared_ptr<const TextureFlyweight> atlas;
+
+    /**< Atlas region of every ASCII character, or an empty rect if the font lacks it. */
+    std::array<SDL_Rect, 128> glyphRects{};
+
+    int cellWidth = 0;
+    int cellHeight = 0;
+    int scale;
+
+    struct CachedRun
+    {
+        std::shared_ptr<const TextRun> run;
+        std::list<std::string>::iterator lruPosition;
+    };
+
+    /**< Laid out strings mapped by text. */
+    std::unordered_map<std::string, CachedRun> runs;
+
+    /**< Cached texts, most recently used first. */
+    std::list<std::string> lru;
+
+    std::size_t maxRuns;
+
+    std::size_t layoutCount = 0;
+
+public:
+    /**
+     * @brief Loads a bitmap font and rasterizes it into a shared atlas.
+     *
+     * @param factory The factory that owns the atlas texture.
+     * @param renderer The SDL_Renderer used to create the atlas if needed.
+     * @param fontPath The path of the bitmap font file.
+     * @param scale Integer magnification applied to every glyph on screen.
+     * @param maxRuns Laid out strings kept in the cache; the least recently used go first.
+     * @throws std::runtime_error If the font cannot be read or parsed.
+     */
+    GlyphCache(FlyweightFactory& factory, SDL_Renderer* renderer, const std::string& fontPath, int scale = 1,
+               std::size_t maxRuns = 1024);
+
+    /**
+     * @brief Returns the cached run for the text, laying it out if it is not cached (anymore).
+     */
+    std::shared_ptr<const TextRun> Layout(const std::string& text);
+
+    /**
+     * @brief Lays out the text without consulting or filling the cache.
+     */
+    std::shared_ptr<const TextRun> BuildRun(const std::string& text);
+
+    /**
+     * @brief Submits a laid out run at the given position.
+     */
+    void Draw(SDL_Renderer* renderer, const TextRun& run, int x, int y) const;
+
+    /**
+     * @brief Drops every cached run. Runs still held by labels stay valid.
+     */
+    void ClearRuns()
+    {
+        runs.clear();
+        lru.clear();
+    }
+
+    std::size_t GetCachedRunCount() const { return runs.size(); }
+
+    /**
+     * @brief Returns how many strings have been laid out so far, cached or not.
+     */
+    std::size_t GetLayoutCount() const { return layoutCount; }
+
+    int GetLineHeight() const { return cellHeight * scale; }
+};
+
+/**
+ * @brief A piece of on-screen text, such as a health or score readout.
+ *
+ * The label keeps the run of its current text, so redrawing unchanged text never lays it out
+ * again and changing it to a string seen before is a single cache lookup.
+ */
+class TextLabel
+{
+private:
+    std::string text;
+    std::shared_ptr<const TextRun> run;
+
+public:
+    /**
+     * @brief Changes the text, laying it out only if it differs from the current one.
+     */
+    void SetText(GlyphCache& glyphs, const std::string& newText)
+    {
+        if (run && newText == text)
+        {
+            return;
+        }
+        text = newText;
+        run = glyphs.Layout(text);
+    }
+
+    void Draw(SDL_Renderer* renderer, const GlyphCache& glyphs, int x, int y) const
+    {
+        if (run)
+        {
+            glyphs.Draw(renderer, *run, x, y);
+        }
+    }
+
+    const std::string& GetText() const { return text; }
+};
+
+#endif
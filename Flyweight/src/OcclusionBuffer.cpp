@@ -0,0 +1,213 @@
+#include "OcclusionBuffer.h"
+
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define OCCLUSION_BUFFER_SSE2 1
+#endif
+
+namespace
+{
+    bool IsEmpty(const SDL_Rect& rect)
+    {
+        return rect.w <= 0 || rect.h <= 0;
+    }
+
+    /**
+     * @brief Returns true if every bit of mask is set in row, over words [begin, end).
+     */
+    inline bool Covers(const std::uint64_t* row, const std::uint64_t* mask, std::size_t begin, std::size_t end)
+    {
+#ifdef OCCLUSION_BUFFER_SSE2
+        __m128i missing = _mm_setzero_si128();
+        for (std::size_t i = begin; i < end; i += 2)
+        {
+            __m128i wanted = _mm_loadu_si128(reinterpret_cast<const __m128i*>(mask + i));
+            __m128i covered = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i));
+            missing = _mm_or_si128(missing, _mm_andnot_si128(covered, wanted));
+        }
+        return _mm_movemask_epi8(_mm_cmpeq_epi8(missing, _mm_setzero_si128())) == 0xFFFF;
+#else
+        std::uint64_t missing = 0;
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            missing |= mask[i] & ~row[i];
+        }
+        return missing == 0;
+#endif
+    }
+
+    inline void Fill(std::uint64_t* row, const std::uint64_t* mask, std::size_t begin, std::size_t end)
+    {
+#ifdef OCCLUSION_BUFFER_SSE2
+        for (std::size_t i = begin; i < end; i += 2)
+        {
+            __m128i wanted = _mm_loadu_si128(reinterpret_cast<const __m128i*>(mask + i));
+            __m128i covered = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(row + i), _mm_or_si128(covered, wanted));
+        }
+#else
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            row[i] |= mask[i];
+        }
+#endif
+    }
+}
+
+
+OcclusionBuffer::OcclusionBuffer(int cellSize)
+    : cellSize(std::max(1, cellSize))
+{
+}
+
+void OcclusionBuffer::Reset(int width, int height)
+{
+    screenWidth = width;
+    screenHeight = height;
+    columns = (width + cellSize - 1) / cellSize;
+    rows = (height + cellSize - 1) / cellSize;
+    wordsPerRow = static_cast<std::size_t>((columns + 127) / 128) * 2;
+    bits.assign(wordsPerRow * rows, 0);
+    span.assign(wordsPerRow, 0);
+}
+
+void OcclusionBuffer::BuildSpan(int firstColumn, int lastColumn)
+{
+    // Only the 128-bit blocks the span touches take part; the rest of the row is left alone.
+    spanBegin = static_cast<std::size_t>(firstColumn / 128) * 2;
+    spanEnd = static_cast<std::size_t>((lastColumn + 127) / 128) * 2;
+    for (std::size_t word = spanBegin; word < spanEnd; ++word)
+    {
+        const int low = static_cast<int>(word) * 64;
+        const int first = std::max(firstColumn, low);
+        const int last = std::min(lastColumn, low + 64);
+        if (first >= last)
+        {
+            span[word] = 0;
+        }
+        else if (last - first == 64)
+        {
+            span[word] = ~std::uint64_t(0);
+        }
+        else
+        {
+            span[word] = ((std::uint64_t(1) << (last - first)) - 1) << (first - low);
+        }
+    }
+}
+
+bool OcclusionBuffer::IsOccluded(const SDL_Rect& bounds)
+{
+    SDL_Rect screen = {0, 0, screenWidth, screenHeight};
+    SDL_Rect visible;
+    if (IsEmpty(bounds) || !SDL_IntersectRect(&bounds, &screen, &visible))
+    {
+        return false;
+    }
+
+    // Every cell the rect touches, even partially.
+    const int firstColumn = visible.x / cellSize;
+    const int lastColumn = (visible.x + visible.w + cellSize - 1) / cellSize;
+    const int firstRow = visible.y / cellSize;
+    const int lastRow = (visible.y + visible.h + cellSize - 1) / cellSize;
+
+    BuildSpan(firstColumn, lastColumn);
+    for (int row = firstRow; row < lastRow; ++row)
+    {
+        if (!Covers(bits.data() + row * wordsPerRow, span.data(), spanBegin, spanEnd))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void OcclusionBuffer::AddOccluder(const SDL_Rect& bounds)
+{
+    SDL_Rect screen = {0, 0, screenWidth, screenHeight};
+    SDL_Rect visible;
+    if (IsEmpty(bounds) || !SDL_IntersectRect(&bounds, &screen, &visible))
+    {
+        return;
+    }
+
+    // Only the cells the rect contains entirely. Pixels beyond the screen edge never need
+    // covering, so a rect reaching the edge also covers the partial cells along it.
+    const int right = visible.x + visible.w;
+    const int bottom = visible.y + visible.h;
+    const int firstColumn = (visible.x + cellSize - 1) / cellSize;
+    const int lastColumn = right >= screenWidth ? columns : right / cellSize;
+    const int firstRow = (visible.y + cellSize - 1) / cellSize;
+    const int lastRow = bottom >= screenHeight ? rows : bottom / cellSize;
+    if (firstColumn >= lastColumn || firstRow >= lastRow)
+    {
+        return;
+    }
+
+    BuildSpan(firstColumn, lastColumn);
+    for (int row = firstRow; row < lastRow; ++row)
+    {
+        Fill(bits.data() + row * wordsPerRow, span.data(), spanBegin, spanEnd);
+    }
+}
+
+void OcclusionBuffer::Cull(SDL_Renderer* renderer, std::vector<DrawCommand>& commands)
+{
+    Uint64 start = SDL_GetPerformanceCounter();
+    stats = OcclusionStats();
+    stats.instances = commands.size();
+
+    int width = 0;
+    int height = 0;
+    if (SDL_GetRendererOutputSize(renderer, &width, &height) != 0)
+    {
+        return;
+    }
+    Reset(width, height);
+
+    SDL_Rect screen = {0, 0, width, height};
+    std::vector<bool> hidden(commands.size(), false);
+    for (std::size_t i = commands.size(); i-- > 0;)
+    {
+        const DrawCommand& command = commands[i];
+        SDL_Rect bounds = command.flyweight->GetBounds(command.x, command.y);
+        if (IsEmpty(bounds))
+        {
+            continue;
+        }
+
+        SDL_Rect visible;
+        if (!SDL_IntersectRect(&bounds, &screen, &visible))
+        {
+            hidden[i] = true;
+            ++stats.offscreen;
+            continue;
+        }
+        if (IsOccluded(bounds))
+        {
+            hidden[i] = true;
+            ++stats.rejected;
+            stats.overdrawAvoided += static_cast<std::uint64_t>(visible.w) * visible.h;
+            continue;
+        }
+        if (command.flyweight->IsOpaque())
+        {
+            AddOccluder(bounds);
+            ++stats.occluders;
+        }
+    }
+
+    std::size_t kept = 0;
+    for (std::size_t i = 0; i < commands.size(); ++i)
+    {
+        if (!hidden[i])
+        {
+            commands[kept++] = commands[i];
+        }
+    }
+    commands.resize(kept);
+
+    stats.cullSeconds = static_cast<double>(SDL_GetPerformanceCounter() - start) / SDL_GetPerformanceFrequency();
+}
@@ -0,0 +1,98 @@
+#ifndef OCCLUSION_BUFFER_H
+#define OCCLUSION_BUFFER_H
+
+#include <SDL2/SDL.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "RenderQueue.h"
+
+/**
+ * @brief What the last OcclusionBuffer::Cull call rejected.
+ */
+struct OcclusionStats
+{
+    std::size_t instances = 0;           /**< Draw commands tested. */
+    std::size_t rejected = 0;            /**< Commands fully hidden behind opaque ones. */
+    std::size_t offscreen = 0;           /**< Commands entirely outside the screen. */
+    std::size_t occluders = 0;           /**< Opaque commands rasterized into the buffer. */
+    std::uint64_t overdrawAvoided = 0;   /**< On-screen pixels the rejected commands would have drawn. */
+    double cullSeconds = 0.0;            /**< Time spent testing and filling the buffer. */
+};
+
+/**
+ * @brief Coarse occlusion buffer that rejects flyweight draws hidden behind opaque ones.
+ *
+ * The screen is divided into square cells, one bit each, stored row by row in 128-bit aligned
+ * words so that a horizontal span of cells is tested or filled with a few SSE2 AND/OR operations
+ * per row. Both operations are conservative:
+ * - an opaque flyweight only sets the cells its bounds contain entirely;
+ * - a flyweight is hidden only if every cell its bounds touch is set.
+ *
+ * Cull walks the commands front to back, i.e. in reverse draw order: every command is first
+ * tested against the nearer opaque ones, then, if opaque, added to the buffer. Flyweights with
+ * unknown bounds are never rejected and never occlude.
+ *
+ * To cull a frame's sprites, set Cull as the culler of a RenderQueue sorted with
+ * SortOrder::ByDepth; the queue then hands it the sorted commands before drawing them.
+ */
+class OcclusionBuffer
+{
+private:
+    int cellSize;
+    int columns = 0;
+    int rows = 0;
+    int screenWidth = 0;
+    int screenHeight = 0;
+
+    /**< 64-bit words per row, always even. */
+    std::size_t wordsPerRow = 0;
+    std::vector<std::uint64_t> bits;
+
+    /**< Mask of the span being tested or filled, and the words it touches. */
+    std::vector<std::uint64_t> span;
+    std::size_t spanBegin = 0;
+    std::size_t spanEnd = 0;
+
+    OcclusionStats stats;
+
+    void BuildSpan(int firstColumn, int lastColumn);
+
+public:
+    /**
+     * @brief Constructs a buffer.
+     *
+     * @param cellSize Screen pixels per side of one cell; coarser cells are cheaper but reject less.
+     */
+    explicit OcclusionBuffer(int cellSize = 8);
+
+    /**
+     * @brief Clears the buffer and sizes it for a screen.
+     */
+    void Reset(int width, int height);
+
+    /**
+     * @brief Returns true if every cell the rect touches is covered. Empty rects are never occluded.
+     */
+    bool IsOccluded(const SDL_Rect& bounds);
+
+    /**
+     * @brief Marks the cells the opaque rect fully contains as covered.
+     */
+    void AddOccluder(const SDL_Rect& bounds);
+
+    /**
+     * @brief Removes the commands hidden behind nearer opaque ones or outside the screen.
+     *
+     * @param renderer The renderer the commands are for; its output size is the screen.
+     * @param commands Commands in draw order, back to front. Culled in place, keeping the order.
+     */
+    void Cull(SDL_Renderer* renderer, std::vector<DrawCommand>& commands);
+
+    int GetCellSize() const { return cellSize; }
+
+    const OcclusionStats& GetStats() const { return stats; }
+};
+
+#endif
@@ -0,0 +1,163 @@
+#include "PixelHash.h"
+
+#include <cstring>
+
+namespace
+{
+    constexpr std::uint64_t Prime1 = 0x9E3779B185EBCA87ULL;
+    constexpr std::uint64_t Prime2 = 0xC2B2AE3D27D4EB4FULL;
+    constexpr std::uint64_t Prime3 = 0x165667B19E3779F9ULL;
+    constexpr std::uint64_t Prime4 = 0x85EBCA77C2B2AE63ULL;
+    constexpr std::uint64_t Prime5 = 0x27D4EB2F165667C5ULL;
+
+    // Constants of the check hash, unrelated to the ones above (SplitMix64 and FNV-1a).
+    constexpr std::uint64_t CheckMix1 = 0xBF58476D1CE4E5B9ULL;
+    constexpr std::uint64_t CheckMix2 = 0x94D049BB133111EBULL;
+    constexpr std::uint64_t CheckPrime = 0x100000001B3ULL;
+
+    inline std::uint64_t RotateLeft(std::uint64_t value, int bits)
+    {
+        return (value << bits) | (value >> (64 - bits));
+    }
+
+    inline std::uint64_t ReadWord(const unsigned char* bytes)
+    {
+        std::uint64_t word;
+        std::memcpy(&word, bytes, sizeof(word));
+        return word;
+    }
+
+    inline std::uint64_t Round(std::uint64_t accumulator, std::uint64_t input)
+    {
+        accumulator += input * Prime2;
+        accumulator = RotateLeft(accumulator, 31);
+        return accumulator * Prime1;
+    }
+
+    inline std::uint64_t MergeRound(std::uint64_t hash, std::uint64_t lane)
+    {
+        hash ^= Round(0, lane);
+        return hash * Prime1 + Prime4;
+    }
+}
+
+std::uint64_t HashBytes(const void* data, std::size_t size, std::uint64_t seed)
+{
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    const unsigned char* end = bytes + size;
+    std::uint64_t hash;
+
+    if (size >= 32)
+    {
+        std::uint64_t lanes[4] = {seed + Prime1 + Prime2, seed + Prime2, seed, seed - Prime1};
+        const unsigned char* limit = end - 32;
+        do
+        {
+            // Four independent accumulators: no lane depends on another inside the loop.
+            for (int lane = 0; lane < 4; ++lane)
+            {
+                lanes[lane] = Round(lanes[lane], ReadWord(bytes + lane * 8));
+            }
+            bytes += 32;
+        } while (bytes <= limit);
+
+        hash = RotateLeft(lanes[0], 1) + RotateLeft(lanes[1], 7) + RotateLeft(lanes[2], 12) + RotateLeft(lanes[3], 18);
+        for (std::uint64_t lane : lanes)
+        {
+            hash = MergeRound(hash, lane);
+        }
+    }
+    else
+    {
+        hash = seed + Prime5;
+    }
+
+    hash += static_cast<std::uint64_t>(size);
+
+    for (; bytes + 8 <= end; bytes += 8)
+    {
+        hash ^= Round(0, ReadWord(bytes));
+        hash = RotateLeft(hash, 27) * Prime1 + Prime4;
+    }
+    for (; bytes < end; ++bytes)
+    {
+        hash ^= (*bytes) * Prime5;
+        hash = RotateLeft(hash, 11) * Prime1;
+    }
+
+    hash ^= hash >> 33;
+    hash *= Prime2;
+    hash ^= hash >> 29;
+    hash *= Prime3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+std::uint64_t CheckHashBytes(const void* data, std::size_t size, std::uint64_t seed)
+{
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    const unsigned char* end = bytes + size;
+    std::uint64_t hash = seed ^ (static_cast<std::uint64_t>(size) * CheckMix1);
+
+    for (; bytes + 8 <= end; bytes += 8)
+    {
+        // Each word is mixed down before it enters, as multiplying only carries changes upwards.
+        std::uint64_t word = ReadWord(bytes) * CheckMix1;
+        word ^= word >> 31;
+        hash = RotateLeft(hash ^ word, 27) * CheckMix2 + CheckPrime;
+    }
+    for (; bytes < end; ++bytes)
+    {
+        hash = RotateLeft((hash ^ *bytes) * CheckPrime, 23);
+    }
+
+    hash ^= hash >> 30;
+    hash *= CheckMix1;
+    hash ^= hash >> 27;
+    hash *= CheckMix2;
+    hash ^= hash >> 31;
+    return hash;
+}
+
+namespace
+{
+    using BytesHasher = std::uint64_t (*)(const void*, std::size_t, std::uint64_t);
+
+    std::uint64_t HashSurfaceWith(SDL_Surface* surface, BytesHasher hashBytes)
+    {
+        bool locked = SDL_MUSTLOCK(surface) && SDL_LockSurface(surface) == 0;
+
+        const std::size_t rowBytes = static_cast<std::size_t>(surface->w) * surface->format->BytesPerPixel;
+        const unsigned char* pixels = static_cast<const unsigned char*>(surface->pixels);
+
+        std::uint64_t hash = hashBytes(&surface->format->format, sizeof(surface->format->format),
+                                       (static_cast<std::uint64_t>(surface->w) << 32) | static_cast<std::uint32_t>(surface->h));
+        if (rowBytes == static_cast<std::size_t>(surface->pitch))
+        {
+            hash = hashBytes(pixels, rowBytes * surface->h, hash);
+        }
+        else
+        {
+            for (int row = 0; row < surface->h; ++row)
+            {
+                hash = hashBytes(pixels + static_cast<std::size_t>(row) * surface->pitch, rowBytes, hash);
+            }
+        }
+
+        if (locked)
+        {
+            SDL_UnlockSurface(surface);
+        }
+        return hash;
+    }
+}
+
+std::uint64_t HashSurfacePixels(SDL_Surface* surface)
+{
+    return HashSurfaceWith(surface, HashBytes);
+}
+
+std::uint64_t CheckHashSurfacePixels(SDL_Surface* surface)
+{
+    return HashSurfaceWith(surface, CheckHashBytes);
+}
@@ -0,0 +1,48 @@
+#ifndef PIXEL_HASH_H
+#define PIXEL_HASH_H
+
+#include <SDL2/SDL.h>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Hashes a block of memory with a fast four-lane 64-bit hash.
+ *
+ * The input is consumed 32 bytes at a time into four independent accumulators (the xxHash64
+ * round structure), so the lanes run in parallel on superscalar CPUs and the loop vectorizes
+ * where 64-bit vector multiplies are available. Not cryptographic.
+ *
+ * @param data The bytes to hash.
+ * @param size The number of bytes.
+ * @param seed Initial value mixed into every lane.
+ * @return The 64-bit hash.
+ */
+std::uint64_t HashBytes(const void* data, std::size_t size, std::uint64_t seed = 0);
+
+/**
+ * @brief Hashes a block of memory with a second 64-bit hash, unrelated to HashBytes.
+ *
+ * A single sequential lane with its own constants (SplitMix64 finalizer), so it is slower than
+ * HashBytes but shares neither its structure nor its constants. Inputs with equal HashBytes are
+ * compared with it to confirm that they are equal, without keeping a copy of them.
+ */
+std::uint64_t CheckHashBytes(const void* data, std::size_t size, std::uint64_t seed = 0);
+
+/**
+ * @brief Hashes the decoded pixels of a surface.
+ *
+ * Only the visible bytes of each row are hashed, so row padding never affects the result.
+ * The size and pixel format are part of the hash, so the same bytes in a different layout
+ * never collide by construction.
+ *
+ * @param surface The surface to hash. Locked internally if required.
+ * @return The 64-bit content hash.
+ */
+std::uint64_t HashSurfacePixels(SDL_Surface* surface);
+
+/**
+ * @brief Hashes the decoded pixels of a surface like HashSurfacePixels, with CheckHashBytes.
+ */
+std::uint64_t CheckHashSurfacePixels(SDL_Surface* surface);
+
+#endif
@@ -0,0 +1,1161 @@
+#include "PngDecoder.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define PNG_DECODER_SSE2 1
+#endif
+
+namespace
+{
+    // ------------------------------------------------------------------------------------------
+    // Checksums
+    // ------------------------------------------------------------------------------------------
+
+    /**
+     * @brief Tables of CRC-32 slicing by 8: entries[k][n] is the CRC of byte n followed by k zeros.
+     */
+    struct CrcTable
+    {
+        std::uint32_t entries[8][256];
+
+        CrcTable()
+        {
+            for (std::uint32_t n = 0; n < 256; ++n)
+            {
+                std::uint32_t c = n;
+                for (int k = 0; k < 8; ++k)
+                {
+                    c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                }
+                entries[0][n] = c;
+            }
+            for (int k = 1; k < 8; ++k)
+            {
+                for (std::uint32_t n = 0; n < 256; ++n)
+                {
+                    entries[k][n] = entries[0][entries[k - 1][n] & 0xFF] ^ (entries[k - 1][n] >> 8);
+                }
+            }
+        }
+    };
+
+    /**
+     * @brief CRC-32 of a chunk's type and data, as stored after them.
+     */
+    std::uint32_t Crc32(const std::uint8_t* data, std::size_t size)
+    {
+        static const CrcTable table;
+        const auto& t = table.entries;
+        std::uint32_t crc = 0xFFFFFFFFu;
+        for (; size >= 8; data += 8, size -= 8)
+        {
+            const std::uint32_t low = crc ^ (static_cast<std::uint32_t>(data[0]) | (static_cast<std::uint32_t>(data[1]) << 8)
+                                             | (static_cast<std::uint32_t>(data[2]) << 16) | (static_cast<std::uint32_t>(data[3]) << 24));
+            crc = t[7][low & 0xFF] ^ t[6][(low >> 8) & 0xFF] ^ t[5][(low >> 16) & 0xFF] ^ t[4][low >> 24]
+                ^ t[3][data[4]] ^ t[2][data[5]] ^ t[1][data[6]] ^ t[0][data[7]];
+        }
+        for (; size > 0; ++data, --size)
+        {
+            crc = t[0][(crc ^ *data) & 0xFF] ^ (crc >> 8);
+        }
+        return crc ^ 0xFFFFFFFFu;
+    }
+
+    /**
+     * @brief Adler-32 of the inflated data, as stored at the end of the zlib stream.
+     */
+    std::uint32_t Adler32(const std::uint8_t* data, std::size_t size)
+    {
+        // 5552 is the most bytes that can be summed before the 32-bit sums may overflow.
+        constexpr std::size_t MaxRun = 5552;
+        std::uint32_t a = 1;
+        std::uint32_t b = 0;
+        while (size > 0)
+        {
+            std::size_t run = std::min(size, MaxRun);
+            size -= run;
+#ifdef PNG_DECODER_SSE2
+            // Sixteen bytes at a time: a gains their sum, b gains 16 times the a they start from
+            // plus the bytes weighted 16 down to 1.
+            if (run >= 16)
+            {
+                const std::size_t blocks = run / 16;
+                const __m128i zero = _mm_setzero_si128();
+                const __m128i firstWeights = _mm_setr_epi16(16, 15, 14, 13, 12, 11, 10, 9);
+                const __m128i lastWeights = _mm_setr_epi16(8, 7, 6, 5, 4, 3, 2, 1);
+                __m128i sums = zero;
+                __m128i previousSums = zero;
+                __m128i weighted = zero;
+                for (std::size_t i = 0; i < blocks; ++i, data += 16)
+                {
+                    const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+                    previousSums = _mm_add_epi64(previousSums, sums);
+                    sums = _mm_add_epi64(sums, _mm_sad_epu8(bytes, zero));
+                    weighted = _mm_add_epi32(weighted, _mm_madd_epi16(_mm_unpacklo_epi8(bytes, zero), firstWeights));
+                    weighted = _mm_add_epi32(weighted, _mm_madd_epi16(_mm_unpackhi_epi8(bytes, zero), lastWeights));
+                }
+                std::uint64_t lanes[2];
+                std::uint32_t weights[4];
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), sums);
+                const std::uint64_t sum = lanes[0] + lanes[1];
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), previousSums);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(weights), weighted);
+                b = static_cast<std::uint32_t>((b + static_cast<std::uint64_t>(a) * blocks * 16 + (lanes[0] + lanes[1]) * 16
+                                                + weights[0] + weights[1] + weights[2] + weights[3]) % 65521);
+                a = static_cast<std::uint32_t>((a + sum) % 65521);
+                run -= blocks * 16;
+            }
+#endif
+            for (const std::uint8_t* end = data + run; data < end; ++data)
+            {
+                a += *data;
+                b += a;
+            }
+            a %= 65521;
+            b %= 65521;
+        }
+        return (b << 16) | a;
+    }
+
+    // ------------------------------------------------------------------------------------------
+    // Inflate
+    // ------------------------------------------------------------------------------------------
+
+    constexpr int FastBits = 10;
+    constexpr int FastMask = (1 << FastBits) - 1;
+
+    const std::uint16_t LengthBase[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                                          35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+    const std::uint8_t LengthExtra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                                          3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+    const std::uint16_t DistanceBase[30] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+                                            257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145,
+                                            8193, 12289, 16385, 24577};
+    const std::uint8_t DistanceExtra[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+                                            7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+    const std::uint8_t CodeLengthOrder[19] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+
+    unsigned ReverseBits(unsigned value, int bits)
+    {
+        unsigned reversed = 0;
+        for (int i = 0; i < bits; ++i)
+        {
+            reversed = (reversed << 1) | (value & 1);
+            value >>= 1;
+        }
+        return reversed;
+    }
+
+    /**
+     * @brief Canonical Huffman decoding table.
+     *
+     * Codes up to FastBits long are resolved with one lookup of the next FastBits input bits.
+     * Longer codes fall back to a canonical search over code lengths.
+     */
+    struct Huffman
+    {
+        /**< (length << 9) | symbol for codes that fit in FastBits, 0 otherwise. */
+        std::uint16_t fast[1 << FastBits];
+        std::uint16_t firstCode[16];
+        std::uint16_t firstSymbol[16];
+        std::uint32_t maxCode[17];
+        std::uint8_t sizes[288];
+        std::uint16_t values[288];
+
+        bool Build(const std::uint8_t* lengths, int count)
+        {
+            int counts[17] = {};
+            std::memset(fast, 0, sizeof(fast));
+            for (int i = 0; i < count; ++i)
+            {
+                ++counts[lengths[i]];
+            }
+            counts[0] = 0;
+            for (int i = 1; i < 16; ++i)
+            {
+                if (counts[i] > (1 << i))
+                {
+                    return false;
+                }
+            }
+
+            int nextCode[16];
+            int code = 0;
+            int symbol = 0;
+            for (int i = 1; i < 16; ++i)
+            {
+                nextCode[i] = code;
+                firstCode[i] = static_cast<std::uint16_t>(code);
+                firstSymbol[i] = static_cast<std::uint16_t>(symbol);
+                code += counts[i];
+                if (counts[i] != 0 && code - 1 >= (1 << i))
+                {
+                    return false;
+                }
+                maxCode[i] = static_cast<std::uint32_t>(code) << (16 - i);
+                code <<= 1;
+                symbol += counts[i];
+            }
+            maxCode[16] = 0x10000;
+
+            for (int i = 0; i < count; ++i)
+            {
+                int length = lengths[i];
+                if (length == 0)
+                {
+                    continue;
+                }
+                int slot = nextCode[length] - firstCode[length] + firstSymbol[length];
+                sizes[slot] = static_cast<std::uint8_t>(length);
+                values[slot] = static_cast<std::uint16_t>(i);
+                if (length <= FastBits)
+                {
+                    std::uint16_t entry = static_cast<std::uint16_t>((length << 9) | i);
+                    for (unsigned j = ReverseBits(static_cast<unsigned>(nextCode[length]), length); j < (1u << FastBits); j += 1u << length)
+                    {
+                        fast[j] = entry;
+                    }
+                }
+                ++nextCode[length];
+            }
+            return true;
+        }
+    };
+
+    /**
+     * @brief Little-endian bit reader with a 64-bit buffer.
+     *
+     * Reading past the end of the input yields zero bits and is detected by Overrun().
+     */
+    struct BitReader
+    {
+        const std::uint8_t* next;
+        const std::uint8_t* end;
+        std::uint64_t bits = 0;
+        int count = 0;
+        std::size_t paddingBytes = 0;
+
+        BitReader(const std::uint8_t* begin, const std::uint8_t* end) : next(begin), end(end) {}
+
+        void Refill()
+        {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+            if (end - next >= 8)
+            {
+                // Load eight bytes at once and keep as many whole bytes as fit in the buffer.
+                std::uint64_t word;
+                std::memcpy(&word, next, sizeof(word));
+                bits |= word << count;
+                next += (63 - count) >> 3;
+                count |= 56;
+                return;
+            }
+#endif
+            while (count <= 56)
+            {
+                if (next < end)
+                {
+                    bits |= static_cast<std::uint64_t>(*next++) << count;
+                }
+                else
+                {
+                    ++paddingBytes;
+                }
+                count += 8;
+            }
+        }
+
+        unsigned Peek(int n) const { return static_cast<unsigned>(bits & ((1ULL << n) - 1)); }
+
+        void Consume(int n)
+        {
+            bits >>= n;
+            count -= n;
+        }
+
+        unsigned Read(int n)
+        {
+            if (count < n)
+            {
+                Refill();
+            }
+            unsigned value = Peek(n);
+            Consume(n);
+            return value;
+        }
+
+        /**
+         * @brief True once bits beyond the end of the input have been consumed.
+         */
+        bool Overrun() const { return static_cast<std::size_t>(count) < paddingBytes * 8; }
+
+        /**
+         * @brief Drops the bits up to the next byte boundary and returns the buffered bytes to
+         *        the input, so that stored blocks can be copied directly.
+         */
+        void AlignToByte()
+        {
+            Consume(count & 7);
+            std::size_t buffered = static_cast<std::size_t>(count) / 8;
+            std::size_t real = buffered > paddingBytes ? buffered - paddingBytes : 0;
+            next -= real;
+            paddingBytes = buffered > paddingBytes ? 0 : paddingBytes - buffered;
+            bits = 0;
+            count = 0;
+        }
+    };
+
+    /**
+     * @brief Decodes one symbol. Returns -1 on an invalid code.
+     */
+    inline int DecodeSymbol(BitReader& reader, const Huffman& huffman)
+    {
+        if (reader.count < 16)
+        {
+            reader.Refill();
+        }
+        std::uint16_t entry = huffman.fast[reader.bits & FastMask];
+        if (entry != 0)
+        {
+            reader.Consume(entry >> 9);
+            return entry & 511;
+        }
+
+        unsigned code = ReverseBits(static_cast<unsigned>(reader.bits & 0xFFFF), 16);
+        int length = FastBits + 1;
+        while (length < 16 && code >= huffman.maxCode[length])
+        {
+            ++length;
+        }
+        if (length >= 16)
+        {
+            return -1;
+        }
+        int slot = static_cast<int>(code >> (16 - length)) - huffman.firstCode[length] + huffman.firstSymbol[length];
+        if (slot < 0 || slot >= 288 || huffman.sizes[slot] != length)
+        {
+            return -1;
+        }
+        reader.Consume(length);
+        return huffman.values[slot];
+    }
+
+    /**
+     * @brief Output buffer of a known final size, with slack for 8-byte match copies.
+     */
+    struct InflateOutput
+    {
+        std::vector<std::uint8_t> buffer;
+        std::size_t size = 0;
+        std::size_t capacity = 0;
+
+        explicit InflateOutput(std::size_t expected) : buffer(expected + 8), capacity(expected) {}
+    };
+
+    bool InflateHuffmanBlock(BitReader& reader, const Huffman& literals, const Huffman& distances, InflateOutput& output)
+    {
+        std::uint8_t* out = output.buffer.data();
+        std::size_t position = output.size;
+        const std::size_t capacity = output.capacity;
+
+        for (;;)
+        {
+            int symbol = DecodeSymbol(reader, literals);
+            if (symbol < 256)
+            {
+                if (symbol < 0 || position >= capacity)
+                {
+                    return false;
+                }
+                out[position++] = static_cast<std::uint8_t>(symbol);
+                continue;
+            }
+            if (symbol == 256)
+            {
+                output.size = position;
+                return !reader.Overrun();
+            }
+
+            symbol -= 257;
+            if (symbol >= 29)
+            {
+                return false;
+            }
+            std::size_t length = LengthBase[symbol] + reader.Read(LengthExtra[symbol]);
+
+            int distanceSymbol = DecodeSymbol(reader, distances);
+            if (distanceSymbol < 0 || distanceSymbol >= 30)
+            {
+                return false;
+            }
+            std::size_t distance = DistanceBase[distanceSymbol] + reader.Read(DistanceExtra[distanceSymbol]);
+            if (distance > position || length > capacity - position)
+            {
+                return false;
+            }
+
+            std::uint8_t* destination = out + position;
+            const std::uint8_t* source = destination - distance;
+            if (distance >= 8)
+            {
+                // Chunks never read bytes they have not written yet; the tail may spill into the slack.
+                for (std::size_t copied = 0; copied < length; copied += 8)
+                {
+                    std::memcpy(destination + copied, source + copied, 8);
+                }
+            }
+            else if (distance == 1)
+            {
+                std::memset(destination, *source, length);
+            }
+            else
+            {
+                for (std::size_t i = 0; i < length; ++i)
+                {
+                    destination[i] = source[i];
+                }
+            }
+            position += length;
+        }
+    }
+
+    bool BuildFixedTables(Huffman& literals, Huffman& distances)
+    {
+        std::uint8_t lengths[288];
+        std::memset(lengths, 8, 144);
+        std::memset(lengths + 144, 9, 112);
+        std::memset(lengths + 256, 7, 24);
+        std::memset(lengths + 280, 8, 8);
+        std::uint8_t distanceLengths[30];
+        std::memset(distanceLengths, 5, sizeof(distanceLengths));
+        return literals.Build(lengths, 288) && distances.Build(distanceLengths, 30);
+    }
+
+    bool ReadDynamicTables(BitReader& reader, Huffman& literals, Huffman& distances)
+    {
+        int literalCount = static_cast<int>(reader.Read(5)) + 257;
+        int distanceCount = static_cast<int>(reader.Read(5)) + 1;
+        int codeLengthCount = static_cast<int>(reader.Read(4)) + 4;
+        if (literalCount > 286 || distanceCount > 30)
+        {
+            return false;
+        }
+
+        std::uint8_t codeLengthLengths[19] = {};
+        for (int i = 0; i < codeLengthCount; ++i)
+        {
+            codeLengthLengths[CodeLengthOrder[i]] = static_cast<std::uint8_t>(reader.Read(3));
+        }
+        Huffman codeLengths;
+        if (!codeLengths.Build(codeLengthLengths, 19))
+        {
+            return false;
+        }
+
+        std::uint8_t lengths[286 + 30];
+        const int total = literalCount + distanceCount;
+        int filled = 0;
+        while (filled < total)
+        {
+            int symbol = DecodeSymbol(reader, codeLengths);
+            if (symbol < 0 || symbol > 18)
+            {
+                return false;
+            }
+            if (symbol < 16)
+            {
+                lengths[filled++] = static_cast<std::uint8_t>(symbol);
+                continue;
+            }
+
+            std::uint8_t value = 0;
+            int repeat;
+            if (symbol == 16)
+            {
+                if (filled == 0)
+                {
+                    return false;
+                }
+                value = lengths[filled - 1];
+                repeat = 3 + static_cast<int>(reader.Read(2));
+            }
+            else if (symbol == 17)
+            {
+                repeat = 3 + static_cast<int>(reader.Read(3));
+            }
+            else
+            {
+                repeat = 11 + static_cast<int>(reader.Read(7));
+            }
+            if (repeat > total - filled)
+            {
+                return false;
+            }
+            std::memset(lengths + filled, value, static_cast<std::size_t>(repeat));
+            filled += repeat;
+        }
+
+        if (lengths[256] == 0 || reader.Overrun())
+        {
+            return false;
+        }
+        return literals.Build(lengths, literalCount) && distances.Build(lengths + literalCount, distanceCount);
+    }
+
+    bool Inflate(const std::uint8_t* data, std::size_t size, InflateOutput& output, std::string& error)
+    {
+        if (size < 2 || (data[0] & 0x0F) != 8 || ((data[0] << 8) | data[1]) % 31 != 0 || (data[1] & 0x20))
+        {
+            error = "Invalid zlib header";
+            return false;
+        }
+
+        BitReader reader(data + 2, data + size);
+        Huffman literals;
+        Huffman distances;
+        bool last = false;
+        while (!last)
+        {
+            last = reader.Read(1) != 0;
+            unsigned type = reader.Read(2);
+            if (type == 0)
+            {
+                reader.AlignToByte();
+                if (reader.end - reader.next < 4)
+                {
+                    error = "Truncated stored block";
+                    return false;
+                }
+                std::size_t length = reader.next[0] | (reader.next[1] << 8);
+                std::size_t inverse = reader.next[2] | (reader.next[3] << 8);
+                reader.next += 4;
+                if ((length ^ 0xFFFF) != inverse || static_cast<std::size_t>(reader.end - reader.next) < length
+                    || length > output.capacity - output.size)
+                {
+                    error = "Corrupt stored block";
+                    return false;
+                }
+                std::memcpy(output.buffer.data() + output.size, reader.next, length);
+                output.size += length;
+                reader.next += length;
+            }
+            else if (type == 1 || type == 2)
+            {
+                bool tables = type == 1 ? BuildFixedTables(literals, distances) : ReadDynamicTables(reader, literals, distances);
+                if (!tables || !InflateHuffmanBlock(reader, literals, distances, output))
+                {
+                    error = "Corrupt compressed block";
+                    return false;
+                }
+            }
+            else
+            {
+                error = "Invalid block type";
+                return false;
+            }
+        }
+
+        if (output.size != output.capacity)
+        {
+            error = "Image data is shorter than expected";
+            return false;
+        }
+
+        reader.AlignToByte();
+        if (reader.end - reader.next < 4)
+        {
+            error = "Truncated zlib checksum";
+            return false;
+        }
+        const std::uint32_t expected = (static_cast<std::uint32_t>(reader.next[0]) << 24)
+                                     | (static_cast<std::uint32_t>(reader.next[1]) << 16)
+                                     | (static_cast<std::uint32_t>(reader.next[2]) << 8) | reader.next[3];
+        if (Adler32(output.buffer.data(), output.size) != expected)
+        {
+            error = "Image data checksum mismatch";
+            return false;
+        }
+        return true;
+    }
+
+    // ------------------------------------------------------------------------------------------
+    // Unfiltering
+    // ------------------------------------------------------------------------------------------
+
+    inline std::uint8_t Paeth(int a, int b, int c)
+    {
+        int pa = std::abs(b - c);
+        int pb = std::abs(a - c);
+        int pc = std::abs(a + b - 2 * c);
+        if (pa <= pb && pa <= pc)
+        {
+            return static_cast<std::uint8_t>(a);
+        }
+        return static_cast<std::uint8_t>(pb <= pc ? b : c);
+    }
+
+    void UnfilterScalar(int filter, std::uint8_t* row, const std::uint8_t* previous, std::size_t length, std::size_t bpp)
+    {
+        switch (filter)
+        {
+            case 1:
+                for (std::size_t i = bpp; i < length; ++i)
+                {
+                    row[i] = static_cast<std::uint8_t>(row[i] + row[i - bpp]);
+                }
+                break;
+            case 2:
+                for (std::size_t i = 0; i < length; ++i)
+                {
+                    row[i] = static_cast<std::uint8_t>(row[i] + previous[i]);
+                }
+                break;
+            case 3:
+                for (std::size_t i = 0; i < bpp; ++i)
+                {
+                    row[i] = static_cast<std::uint8_t>(row[i] + (previous[i] >> 1));
+                }
+                for (std::size_t i = bpp; i < length; ++i)
+                {
+                    row[i] = static_cast<std::uint8_t>(row[i] + ((row[i - bpp] + previous[i]) >> 1));
+                }
+                break;
+            case 4:
+                for (std::size_t i = 0; i < bpp; ++i)
+                {
+                    row[i] = static_cast<std::uint8_t>(row[i] + previous[i]);
+                }
+                for (std::size_t i = bpp; i < length; ++i)
+                {
+                    row[i] = static_cast<std::uint8_t>(row[i] + Paeth(row[i - bpp], previous[i], previous[i - bpp]));
+                }
+                break;
+            default:
+                break;
+        }
+    }
+
+#ifdef PNG_DECODER_SSE2
+    inline __m128i LoadPixel(const std::uint8_t* p, std::size_t bpp)
+    {
+        std::uint32_t value = 0;
+        std::memcpy(&value, p, bpp);
+        return _mm_cvtsi32_si128(static_cast<int>(value));
+    }
+
+    inline void StorePixel(std::uint8_t* p, __m128i pixel, std::size_t bpp)
+    {
+        std::uint32_t value = static_cast<std::uint32_t>(_mm_cvtsi128_si32(pixel));
+        std::memcpy(p, &value, bpp);
+    }
+
+    inline __m128i Abs16(__m128i x)
+    {
+        return _mm_max_epi16(x, _mm_sub_epi16(_mm_setzero_si128(), x));
+    }
+
+    inline __m128i Select(__m128i mask, __m128i ifTrue, __m128i ifFalse)
+    {
+        return _mm_or_si128(_mm_and_si128(mask, ifTrue), _mm_andnot_si128(mask, ifFalse));
+    }
+
+    /**
+     * @brief SSE2 unfiltering for 3 and 4 byte pixels. Sub, Average and Paeth carry a dependency
+     *        from one pixel to the next, so they process a pixel per step with all its channels
+     *        in parallel; Up has no such dependency and processes 16 bytes per step.
+     */
+    void UnfilterSse2(int filter, std::uint8_t* row, const std::uint8_t* previous, std::size_t length, std::size_t bpp)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        switch (filter)
+        {
+            case 1:
+            {
+                __m128i a = zero;
+                for (std::size_t i = 0; i < length; i += bpp)
+                {
+                    a = _mm_add_epi8(a, LoadPixel(row + i, bpp));
+                    StorePixel(row + i, a, bpp);
+                }
+                break;
+            }
+            case 2:
+            {
+                std::size_t i = 0;
+                for (; i + 16 <= length; i += 16)
+                {
+                    __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i));
+                    __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(previous + i));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(row + i), _mm_add_epi8(d, b));
+                }
+                for (; i < length; ++i)
+                {
+                    row[i] = static_cast<std::uint8_t>(row[i] + previous[i]);
+                }
+                break;
+            }
+            case 3:
+            {
+                const __m128i one = _mm_set1_epi8(1);
+                __m128i a = zero;
+                for (std::size_t i = 0; i < length; i += bpp)
+                {
+                    __m128i b = LoadPixel(previous + i, bpp);
+                    // _mm_avg_epu8 rounds up; PNG rounds down, so subtract the carried low bit.
+                    __m128i average = _mm_sub_epi8(_mm_avg_epu8(a, b), _mm_and_si128(_mm_xor_si128(a, b), one));
+                    a = _mm_add_epi8(LoadPixel(row + i, bpp), average);
+                    StorePixel(row + i, a, bpp);
+                }
+                break;
+            }
+            case 4:
+            {
+                __m128i a = zero;
+                __m128i c = zero;
+                for (std::size_t i = 0; i < length; i += bpp)
+                {
+                    __m128i b = _mm_unpacklo_epi8(LoadPixel(previous + i, bpp), zero);
+                    __m128i d = LoadPixel(row + i, bpp);
+
+                    __m128i pa = _mm_sub_epi16(b, c);
+                    __m128i pb = _mm_sub_epi16(a, c);
+                    __m128i pc = Abs16(_mm_add_epi16(pa, pb));
+                    pa = Abs16(pa);
+                    pb = Abs16(pb);
+                    __m128i smallest = _mm_min_epi16(pc, _mm_min_epi16(pa, pb));
+                    __m128i nearest = Select(_mm_cmpeq_epi16(smallest, pa), a,
+                                             Select(_mm_cmpeq_epi16(smallest, pb), b, c));
+
+                    d = _mm_add_epi8(d, _mm_packus_epi16(nearest, nearest));
+                    StorePixel(row + i, d, bpp);
+
+                    c = b;
+                    a = _mm_unpacklo_epi8(d, zero);
+                }
+                break;
+            }
+            default:
+                break;
+        }
+    }
+#endif
+
+    bool Unfilter(std::uint8_t* data, std::uint32_t height, std::size_t rowBytes, std::size_t bpp, std::string& error)
+    {
+        std::vector<std::uint8_t> zeroRow(rowBytes, 0);
+        const std::uint8_t* previous = zeroRow.data();
+        for (std::uint32_t y = 0; y < height; ++y)
+        {
+            std::uint8_t* line = data + y * (rowBytes + 1);
+            int filter = line[0];
+            std::uint8_t* row = line + 1;
+            if (filter > 4)
+            {
+                error = "Invalid filter type";
+                return false;
+            }
+#ifdef PNG_DECODER_SSE2
+            if (bpp == 3 || bpp == 4)
+            {
+                UnfilterSse2(filter, row, previous, rowBytes, bpp);
+            }
+            else
+#endif
+            {
+                UnfilterScalar(filter, row, previous, rowBytes, bpp);
+            }
+            previous = row;
+        }
+        return true;
+    }
+
+    // ------------------------------------------------------------------------------------------
+    // Conversion to 32-bit pixels
+    // ------------------------------------------------------------------------------------------
+
+    struct Transparency
+    {
+        bool hasKey = false;
+        std::uint16_t key[3] = {};
+        std::uint8_t paletteAlpha[256];
+    };
+
+    inline void WritePixel(std::uint8_t* out, std::uint8_t r, std::uint8_t g, std::uint8_t b, std::uint8_t a, PngPixelOrder order)
+    {
+        if (order == PngPixelOrder::RGBA)
+        {
+            out[0] = r;
+            out[2] = b;
+        }
+        else
+        {
+            out[0] = b;
+            out[2] = r;
+        }
+        out[1] = g;
+        out[3] = a;
+    }
+
+    /**
+     * @brief Reads sample n of a row of packed samples of 1 to 16 bits.
+     */
+    inline unsigned Sample(const std::uint8_t* row, std::size_t n, int depth)
+    {
+        switch (depth)
+        {
+            case 8:
+                return row[n];
+            case 16:
+                return static_cast<unsigned>((row[2 * n] << 8) | row[2 * n + 1]);
+            default:
+            {
+                std::size_t bit = n * static_cast<std::size_t>(depth);
+                int shift = 8 - depth - static_cast<int>(bit & 7);
+                return (row[bit >> 3] >> shift) & ((1u << depth) - 1);
+            }
+        }
+    }
+
+    /**
+     * @brief Scales a sample to 8 bits: low depths are replicated, 16 bits keep the high byte.
+     */
+    inline std::uint8_t ToByte(unsigned sample, int depth)
+    {
+        switch (depth)
+        {
+            case 1: return static_cast<std::uint8_t>(sample * 255);
+            case 2: return static_cast<std::uint8_t>(sample * 85);
+            case 4: return static_cast<std::uint8_t>(sample * 17);
+            case 16: return static_cast<std::uint8_t>(sample >> 8);
+            default: return static_cast<std::uint8_t>(sample);
+        }
+    }
+
+    void ConvertRow(const std::uint8_t* row, std::uint8_t* out, const PngInfo& info, const std::uint8_t* palette,
+                    const Transparency& transparency, PngPixelOrder order)
+    {
+        const std::uint32_t width = info.width;
+        const int depth = info.bitDepth;
+
+        switch (info.colorType)
+        {
+            case 6:
+                if (depth == 8)
+                {
+                    if (order == PngPixelOrder::RGBA)
+                    {
+                        std::memcpy(out, row, static_cast<std::size_t>(width) * 4);
+                        return;
+                    }
+                    // Swap red and blue on whole 32-bit pixels; the loop vectorizes.
+                    for (std::uint32_t x = 0; x < width; ++x)
+                    {
+                        std::uint32_t pixel;
+                        std::memcpy(&pixel, row + x * 4, 4);
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+                        pixel = (pixel & 0x00FF00FFu) | ((pixel >> 16) & 0x0000FF00u) | ((pixel & 0x0000FF00u) << 16);
+#else
+                        pixel = (pixel & 0xFF00FF00u) | ((pixel >> 16) & 0xFFu) | ((pixel & 0xFFu) << 16);
+#endif
+                        std::memcpy(out + x * 4, &pixel, 4);
+                    }
+                    return;
+                }
+                for (std::uint32_t x = 0; x < width; ++x)
+                {
+                    WritePixel(out + x * 4, ToByte(Sample(row, x * 4, depth), depth), ToByte(Sample(row, x * 4 + 1, depth), depth),
+                               ToByte(Sample(row, x * 4 + 2, depth), depth), ToByte(Sample(row, x * 4 + 3, depth), depth), order);
+                }
+                return;
+
+            case 2:
+                for (std::uint32_t x = 0; x < width; ++x)
+                {
+                    unsigned r = Sample(row, x * 3, depth);
+                    unsigned g = Sample(row, x * 3 + 1, depth);
+                    unsigned b = Sample(row, x * 3 + 2, depth);
+                    bool keyed = transparency.hasKey && r == transparency.key[0] && g == transparency.key[1] && b == transparency.key[2];
+                    WritePixel(out + x * 4, ToByte(r, depth), ToByte(g, depth), ToByte(b, depth), keyed ? 0 : 255, order);
+                }
+                return;
+
+            case 3:
+                for (std::uint32_t x = 0; x < width; ++x)
+                {
+                    unsigned index = Sample(row, x, depth);
+                    const std::uint8_t* color = palette + index * 3;
+                    WritePixel(out + x * 4, color[0], color[1], color[2], transparency.paletteAlpha[index], order);
+                }
+                return;
+
+            case 0:
+                for (std::uint32_t x = 0; x < width; ++x)
+                {
+                    unsigned gray = Sample(row, x, depth);
+                    std::uint8_t value = ToByte(gray, depth);
+                    bool keyed = transparency.hasKey && gray == transparency.key[0];
+                    WritePixel(out + x * 4, value, value, value, keyed ? 0 : 255, order);
+                }
+                return;
+
+            case 4:
+                for (std::uint32_t x = 0; x < width; ++x)
+                {
+                    std::uint8_t value = ToByte(Sample(row, x * 2, depth), depth);
+                    WritePixel(out + x * 4, value, value, value, ToByte(Sample(row, x * 2 + 1, depth), depth), order);
+                }
+                return;
+
+            default:
+                return;
+        }
+    }
+
+    std::uint32_t ReadBigEndian32(const std::uint8_t* p)
+    {
+        return (static_cast<std::uint32_t>(p[0]) << 24) | (static_cast<std::uint32_t>(p[1]) << 16)
+             | (static_cast<std::uint32_t>(p[2]) << 8) | p[3];
+    }
+
+    const std::uint8_t Signature[8] = {0x89, 'P', 'N', 'G', 0x0D, 0x0A, 0x1A, 0x0A};
+
+    int ChannelCount(int colorType)
+    {
+        switch (colorType)
+        {
+            case 0: return 1;
+            case 2: return 3;
+            case 3: return 1;
+            case 4: return 2;
+            case 6: return 4;
+            default: return 0;
+        }
+    }
+
+    bool IsValidDepth(int colorType, int depth)
+    {
+        switch (colorType)
+        {
+            case 0: return depth == 1 || depth == 2 || depth == 4 || depth == 8 || depth == 16;
+            case 3: return depth == 1 || depth == 2 || depth == 4 || depth == 8;
+            case 2:
+            case 4:
+            case 6: return depth == 8 || depth == 16;
+            default: return false;
+        }
+    }
+}
+
+bool ReadPngInfo(const std::uint8_t* data, std::size_t size, PngInfo& info, std::string& error)
+{
+    if (size < 33 || std::memcmp(data, Signature, 8) != 0 || std::memcmp(data + 12, "IHDR", 4) != 0)
+    {
+        error = "Not a PNG file";
+        return false;
+    }
+
+    const std::uint8_t* header = data + 16;
+    info.width = ReadBigEndian32(header);
+    info.height = ReadBigEndian32(header + 4);
+    info.bitDepth = header[8];
+    info.colorType = header[9];
+    info.interlaced = header[12] != 0;
+
+    if (info.width == 0 || info.height == 0 || info.width > (1u << 24) || info.height > (1u << 24))
+    {
+        error = "Invalid image size";
+        return false;
+    }
+    if (!IsValidDepth(info.colorType, info.bitDepth) || header[10] != 0 || header[11] != 0 || header[12] > 1)
+    {
+        error = "Invalid PNG header";
+        return false;
+    }
+    return true;
+}
+
+bool DecodePng(const std::uint8_t* data, std::size_t size, std::uint8_t* pixels, std::size_t pitch,
+               PngPixelOrder order, std::string& error)
+{
+    PngInfo info;
+    if (!ReadPngInfo(data, size, info, error))
+    {
+        return false;
+    }
+    if (info.interlaced)
+    {
+        error = "Interlaced PNG files are not supported";
+        return false;
+    }
+
+    std::uint8_t palette[256 * 3] = {};
+    bool hasPalette = false;
+    Transparency transparency;
+    std::memset(transparency.paletteAlpha, 255, sizeof(transparency.paletteAlpha));
+
+    // Gather the chunks. IDAT data is only contiguous when there is a single IDAT chunk.
+    std::vector<std::uint8_t> compressed;
+    const std::uint8_t* singleIdat = nullptr;
+    std::size_t singleIdatSize = 0;
+    int idatCount = 0;
+
+    std::size_t offset = 8;
+    bool ended = false;
+    while (!ended)
+    {
+        if (size - offset < 12)
+        {
+            error = "Truncated chunk";
+            return false;
+        }
+        std::uint32_t length = ReadBigEndian32(data + offset);
+        const std::uint8_t* type = data + offset + 4;
+        const std::uint8_t* body = data + offset + 8;
+        if (length > size - offset - 12)
+        {
+            error = "Truncated chunk";
+            return false;
+        }
+        if (Crc32(type, length + 4) != ReadBigEndian32(body + length))
+        {
+            error = "Chunk CRC mismatch";
+            return false;
+        }
+
+        if (std::memcmp(type, "IDAT", 4) == 0)
+        {
+            if (idatCount++ == 0)
+            {
+                singleIdat = body;
+                singleIdatSize = length;
+            }
+            else
+            {
+                if (compressed.empty())
+                {
+                    compressed.assign(singleIdat, singleIdat + singleIdatSize);
+                }
+                compressed.insert(compressed.end(), body, body + length);
+            }
+        }
+        else if (std::memcmp(type, "PLTE", 4) == 0)
+        {
+            if (length % 3 != 0 || length > sizeof(palette))
+            {
+                error = "Invalid palette";
+                return false;
+            }
+            std::memcpy(palette, body, length);
+            hasPalette = length > 0;
+        }
+        else if (std::memcmp(type, "tRNS", 4) == 0)
+        {
+            if (info.colorType == 3)
+            {
+                std::memcpy(transparency.paletteAlpha, body, std::min<std::size_t>(length, 256));
+            }
+            else if (info.colorType == 0 && length >= 2)
+            {
+                transparency.hasKey = true;
+                transparency.key[0] = static_cast<std::uint16_t>((body[0] << 8) | body[1]);
+            }
+            else if (info.colorType == 2 && length >= 6)
+            {
+                transparency.hasKey = true;
+                for (int i = 0; i < 3; ++i)
+                {
+                    transparency.key[i] = static_cast<std::uint16_t>((body[2 * i] << 8) | body[2 * i + 1]);
+                }
+            }
+        }
+        else if (std::memcmp(type, "IEND", 4) == 0)
+        {
+            ended = true;
+        }
+        offset += 12 + length;
+    }
+
+    if (idatCount == 0)
+    {
+        error = "No image data";
+        return false;
+    }
+    if (info.colorType == 3 && !hasPalette)
+    {
+        error = "Missing palette";
+        return false;
+    }
+
+    const std::size_t bitsPerPixel = static_cast<std::size_t>(ChannelCount(info.colorType)) * info.bitDepth;
+    const std::size_t rowBytes = (info.width * bitsPerPixel + 7) / 8;
+    const std::size_t bpp = std::max<std::size_t>(1, bitsPerPixel / 8);
+
+    InflateOutput raw(info.height * (rowBytes + 1));
+    const std::uint8_t* stream = idatCount == 1 ? singleIdat : compressed.data();
+    const std::size_t streamSize = idatCount == 1 ? singleIdatSize : compressed.size();
+    if (!Inflate(stream, streamSize, raw, error) || !Unfilter(raw.buffer.data(), info.height, rowBytes, bpp, error))
+    {
+        return false;
+    }
+
+    for (std::uint32_t y = 0; y < info.height; ++y)
+    {
+        ConvertRow(raw.buffer.data() + y * (rowBytes + 1) + 1, pixels + y * pitch, info, palette, transparency, order);
+    }
+    return true;
+}
+
+SDL_Surface* LoadPngSurface(const std::string& filePath, Uint32 pixelFormat)
+{
+    std::ifstream file(filePath, std::ios::binary);
+    if (!file.is_open())
+    {
+        return nullptr;
+    }
+    std::vector<std::uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    PngInfo info;
+    std::string error;
+    if (!ReadPngInfo(data.data(), data.size(), info, error) || info.interlaced)
+    {
+        return nullptr;
+    }
+
+    SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, static_cast<int>(info.width), static_cast<int>(info.height), 32, pixelFormat);
+    if (!surface)
+    {
+        return nullptr;
+    }
+
+    PngPixelOrder order = pixelFormat == SDL_PIXELFORMAT_BGRA32 ? PngPixelOrder::BGRA : PngPixelOrder::RGBA;
+    if (!DecodePng(data.data(), data.size(), static_cast<std::uint8_t*>(surface->pixels),
+                   static_cast<std::size_t>(surface->pitch), order, error))
+    {
+        SDL_FreeSurface(surface);
+        return nullptr;
+    }
+    return surface;
+}
+
+Uint32 GetNativePngFormat(SDL_Renderer* renderer)
+{
+    SDL_RendererInfo info;
+    if (renderer && SDL_GetRendererInfo(renderer, &info) == 0)
+    {
+        for (Uint32 i = 0; i < info.num_texture_formats; ++i)
+        {
+            if (info.texture_formats[i] == SDL_PIXELFORMAT_BGRA32 || info.texture_formats[i] == SDL_PIXELFORMAT_RGBA32)
+            {
+                return info.texture_formats[i];
+            }
+        }
+    }
+    return SDL_PIXELFORMAT_BGRA32;
+}
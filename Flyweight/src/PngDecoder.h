@@ -0,0 +1,80 @@
+#ifndef PNG_DECODER_H
+#define PNG_DECODER_H
+
+#include <SDL2/SDL.h>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Byte order of the 32-bit pixels written by DecodePng.
+ */
+enum class PngPixelOrder
+{
+    RGBA,  /**< Matches SDL_PIXELFORMAT_RGBA32. */
+    BGRA   /**< Matches SDL_PIXELFORMAT_BGRA32, i.e. ARGB8888 on little-endian machines. */
+};
+
+/**
+ * @brief Header fields of a PNG file.
+ */
+struct PngInfo
+{
+    std::uint32_t width = 0;
+    std::uint32_t height = 0;
+    int bitDepth = 0;
+    int colorType = 0;
+    bool interlaced = false;
+};
+
+/**
+ * @brief Reads the IHDR chunk of a PNG file.
+ *
+ * @return false if the data is not a PNG file, with the reason in error.
+ */
+bool ReadPngInfo(const std::uint8_t* data, std::size_t size, PngInfo& info, std::string& error);
+
+/**
+ * @brief Decodes a PNG file straight into 32-bit pixels.
+ *
+ * A built-in decoder tuned for loading many assets fast:
+ * - inflate with a table-driven Huffman decoder (one lookup for codes up to 10 bits) and a
+ *   64-bit bit buffer refilled eight bytes at a time;
+ * - SSE2 unfiltering of the Sub, Up, Average and Paeth filters for 3 and 4 byte pixels, scalar
+ *   code for every other layout;
+ * - conversion of every color type and bit depth straight into the requested pixel order, so
+ *   that SDL never has to convert the surface again when creating the texture.
+ *
+ * Transparency from tRNS chunks becomes alpha. 16-bit samples keep their most significant byte.
+ * Interlaced images are not supported and make the call fail, so that callers can fall back to
+ * SDL_image. Chunk CRCs and the zlib checksum are verified, and a corrupt file makes the call
+ * fail rather than decode into wrong pixels; so does a palette image without a PLTE chunk.
+ *
+ * @param data The whole PNG file.
+ * @param size Size of the file in bytes.
+ * @param pixels Destination of width * height pixels, 4 bytes each.
+ * @param pitch Bytes between the starts of two destination rows.
+ * @param order Byte order of the destination pixels.
+ * @param error Reason of the failure, if any.
+ * @return true on success.
+ */
+bool DecodePng(const std::uint8_t* data, std::size_t size, std::uint8_t* pixels, std::size_t pitch,
+               PngPixelOrder order, std::string& error);
+
+/**
+ * @brief Loads a PNG file into a surface in the renderer's preferred 32-bit format.
+ *
+ * @param filePath The file to load.
+ * @param pixelFormat SDL_PIXELFORMAT_RGBA32 or SDL_PIXELFORMAT_BGRA32.
+ * @return The surface, or nullptr if the file cannot be read or is not supported.
+ */
+SDL_Surface* LoadPngSurface(const std::string& filePath, Uint32 pixelFormat);
+
+/**
+ * @brief Picks the 32-bit format the renderer can upload without conversion.
+ *
+ * @return SDL_PIXELFORMAT_BGRA32 or SDL_PIXELFORMAT_RGBA32.
+ */
+Uint32 GetNativePngFormat(SDL_Renderer* renderer);
+
+#endif
@@ -0,0 +1,349 @@
+#include "RenderQueue.h"
+
+#include <algorithm>
+#include <array>
+#include <condition_variable>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+namespace
+{
+    using Histogram = std::array<std::size_t, 256>;
+
+    /**
+     * @brief Blocks every thread until all of them have arrived, then releases them together.
+     */
+    class Barrier
+    {
+    private:
+        std::mutex mutex;
+        std::condition_variable condition;
+        unsigned threadCount;
+        unsigned waiting = 0;
+        unsigned generation = 0;
+
+    public:
+        explicit Barrier(unsigned threadCount) : threadCount(threadCount) {}
+
+        void Wait()
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            unsigned arrivedGeneration = generation;
+            if (++waiting == threadCount)
+            {
+                waiting = 0;
+                ++generation;
+                condition.notify_all();
+                return;
+            }
+            condition.wait(lock, [&] { return generation != arrivedGeneration; });
+        }
+    };
+
+    inline unsigned Digit(std::uint64_t key, int shift)
+    {
+        return static_cast<unsigned>(key >> shift) & 0xFFu;
+    }
+
+    /**
+     * @brief Returns true if every key has the same digit, in which case the pass can be skipped.
+     */
+    bool IsTrivialPass(const Histogram& totals, std::size_t count)
+    {
+        return std::any_of(totals.begin(), totals.end(), [count](std::size_t bucket) { return bucket == count; });
+    }
+
+    void RadixSortSerial(std::vector<std::uint64_t>& keys, std::vector<std::uint64_t>& scratch, int firstByte, int lastByte)
+    {
+        const std::size_t count = keys.size();
+        for (int byte = firstByte; byte <= lastByte; ++byte)
+        {
+            const int shift = byte * 8;
+            Histogram histogram{};
+            for (std::uint64_t key : keys)
+            {
+                ++histogram[Digit(key, shift)];
+            }
+            if (IsTrivialPass(histogram, count))
+            {
+                continue;
+            }
+
+            std::size_t offset = 0;
+            for (std::size_t& bucket : histogram)
+            {
+                std::size_t size = bucket;
+                bucket = offset;
+                offset += size;
+            }
+            for (std::uint64_t key : keys)
+            {
+                scratch[histogram[Digit(key, shift)]++] = key;
+            }
+            keys.swap(scratch);
+        }
+    }
+
+    void RadixSortParallel(std::vector<std::uint64_t>& keys, std::vector<std::uint64_t>& scratch,
+                           int firstByte, int lastByte, WorkerPool& pool)
+    {
+        const unsigned threadCount = pool.GetThreadCount();
+        const std::size_t count = keys.size();
+        std::vector<Histogram> histograms(threadCount);
+        Barrier barrier(threadCount);
+        std::uint64_t* sorted = keys.data();
+
+        const std::function<void(unsigned)> worker = [&](unsigned thread)
+        {
+            const std::size_t begin = count * thread / threadCount;
+            const std::size_t end = count * (thread + 1) / threadCount;
+            std::uint64_t* source = keys.data();
+            std::uint64_t* destination = scratch.data();
+
+            for (int byte = firstByte; byte <= lastByte; ++byte)
+            {
+                const int shift = byte * 8;
+                Histogram& own = histograms[thread];
+                own.fill(0);
+                for (std::size_t i = begin; i < end; ++i)
+                {
+                    ++own[Digit(source[i], shift)];
+                }
+                barrier.Wait();
+
+                // Every thread derives the same totals, so they all agree on skipping a pass.
+                Histogram totals{};
+                for (const Histogram& histogram : histograms)
+                {
+                    for (std::size_t bucket = 0; bucket < 256; ++bucket)
+                    {
+                        totals[bucket] += histogram[bucket];
+                    }
+                }
+                const bool trivial = IsTrivialPass(totals, count);
+
+                if (!trivial)
+                {
+                    // Bucket-major, thread-minor offsets keep the sort stable across slices.
+                    Histogram offsets;
+                    std::size_t offset = 0;
+                    for (std::size_t bucket = 0; bucket < 256; ++bucket)
+                    {
+                        std::size_t before = 0;
+                        for (unsigned other = 0; other < thread; ++other)
+                        {
+                            before += histograms[other][bucket];
+                        }
+                        offsets[bucket] = offset + before;
+                        offset += totals[bucket];
+                    }
+                    for (std::size_t i = begin; i < end; ++i)
+                    {
+                        std::uint64_t key = source[i];
+                        destination[offsets[Digit(key, shift)]++] = key;
+                    }
+                }
+                barrier.Wait();
+
+                if (!trivial)
+                {
+                    std::swap(source, destination);
+                }
+            }
+
+            if (thread == 0)
+            {
+                sorted = source;
+            }
+        };
+
+        pool.Run(worker);
+
+        if (sorted != keys.data())
+        {
+            keys.swap(scratch);
+        }
+    }
+}
+
+WorkerPool::WorkerPool(unsigned threadCount)
+{
+    for (unsigned thread = 1; thread < threadCount; ++thread)
+    {
+        threads.emplace_back(&WorkerPool::Work, this, thread);
+    }
+}
+
+WorkerPool::~WorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    started.notify_all();
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+}
+
+void WorkerPool::Work(unsigned thread)
+{
+    std::uint64_t seen = 0;
+    for (;;)
+    {
+        const std::function<void(unsigned)>* current;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            started.wait(lock, [&] { return stopping || generation != seen; });
+            if (stopping)
+            {
+                return;
+            }
+            seen = generation;
+            current = job;
+        }
+
+        (*current)(thread);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--running == 0)
+        {
+            finished.notify_one();
+        }
+    }
+}
+
+void WorkerPool::Run(const std::function<void(unsigned)>& newJob)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        job = &newJob;
+        running = static_cast<unsigned>(threads.size());
+        ++generation;
+    }
+    started.notify_all();
+
+    newJob(0);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    finished.wait(lock, [this] { return running == 0; });
+}
+
+
+void RadixSortKeys(std::vector<std::uint64_t>& keys, std::vector<std::uint64_t>& scratch,
+                   int firstByte, int lastByte, unsigned threadCount)
+{
+    if (threadCount <= 1 || keys.size() < threadCount * 256)
+    {
+        scratch.resize(keys.size());
+        RadixSortSerial(keys, scratch, firstByte, lastByte);
+        return;
+    }
+    WorkerPool pool(threadCount);
+    RadixSortKeys(keys, scratch, firstByte, lastByte, pool);
+}
+
+void RadixSortKeys(std::vector<std::uint64_t>& keys, std::vector<std::uint64_t>& scratch,
+                   int firstByte, int lastByte, WorkerPool& pool)
+{
+    scratch.resize(keys.size());
+    if (pool.GetThreadCount() <= 1 || keys.size() < pool.GetThreadCount() * 256)
+    {
+        RadixSortSerial(keys, scratch, firstByte, lastByte);
+    }
+    else
+    {
+        RadixSortParallel(keys, scratch, firstByte, lastByte, pool);
+    }
+}
+
+
+RenderQueue::RenderQueue()
+    : threadCount(std::max(1u, std::thread::hardware_concurrency()))
+{
+}
+
+void RenderQueue::Submit(const Flyweight& flyweight, int x, int y, std::uint8_t layer, std::uint16_t depth)
+{
+    if (commands.size() >= MaxCommands)
+    {
+        throw std::length_error("RenderQueue holds at most 2^24 commands per frame");
+    }
+
+    const std::uint16_t flyweightId = static_cast<std::uint16_t>(flyweight.GetId());
+    const std::uint32_t index = static_cast<std::uint32_t>(commands.size());
+    keys.push_back(order == SortOrder::ByDepth ? MakeKey(layer, depth, flyweightId, index)
+                                               : MakeKey(layer, flyweightId, depth, index));
+    commands.push_back(DrawCommand{&flyweight, x, y});
+}
+
+void RenderQueue::Sort()
+{
+    Uint64 start = SDL_GetPerformanceCounter();
+    // Bytes 0..2 hold the submission index, which is already in order.
+    if (threadCount > 1 && keys.size() >= parallelThreshold)
+    {
+        if (!workers || workers->GetThreadCount() != threadCount)
+        {
+            workers = std::make_unique<WorkerPool>(threadCount);
+        }
+        RadixSortKeys(keys, scratch, 3, 7, *workers);
+    }
+    else
+    {
+        RadixSortKeys(keys, scratch, 3, 7, 1);
+    }
+    stats.sortSeconds = static_cast<double>(SDL_GetPerformanceCounter() - start) / SDL_GetPerformanceFrequency();
+}
+
+void RenderQueue::Flush(SDL_Renderer* renderer)
+{
+    Sort();
+
+    stats.commands = keys.size();
+    stats.textureSwitches = 0;
+    stats.culled = 0;
+    const Flyweight* previous = nullptr;
+    auto draw = [this, renderer, &previous](const DrawCommand& command)
+    {
+        if (command.flyweight != previous)
+        {
+            ++stats.textureSwitches;
+            previous = command.flyweight;
+        }
+        command.flyweight->Draw(renderer, command.x, command.y);
+    };
+
+    if (culler)
+    {
+        drawOrder.clear();
+        for (std::uint64_t key : keys)
+        {
+            drawOrder.push_back(commands[key & 0xFFFFFFu]);
+        }
+        culler(renderer, drawOrder);
+        stats.culled = keys.size() - drawOrder.size();
+        for (const DrawCommand& command : drawOrder)
+        {
+            draw(command);
+        }
+    }
+    else
+    {
+        for (std::uint64_t key : keys)
+        {
+            draw(commands[key & 0xFFFFFFu]);
+        }
+    }
+
+    Clear();
+}
+
+void RenderQueue::Clear()
+{
+    commands.clear();
+    keys.clear();
+}
@@ -0,0 +1,216 @@
+#ifndef RENDER_QUEUE_H
+#define RENDER_QUEUE_H
+
+#include <SDL2/SDL.h>
+#include <cstddef>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Flyweight.h"
+
+/**
+ * @brief A deferred Flyweight::Draw call.
+ */
+struct DrawCommand
+{
+    const Flyweight* flyweight;
+    int x;
+    int y;
+};
+
+/**
+ * @brief Threads started once and kept alive to run the same job on all of them, frame after frame.
+ *
+ * The calling thread takes part as thread 0, so a pool of N threads starts N - 1 of its own.
+ */
+class WorkerPool
+{
+private:
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    std::condition_variable started;
+    std::condition_variable finished;
+    const std::function<void(unsigned)>* job = nullptr;
+    std::uint64_t generation = 0;
+    unsigned running = 0;
+    bool stopping = false;
+
+    void Work(unsigned thread);
+
+public:
+    explicit WorkerPool(unsigned threadCount);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    /**
+     * @brief Calls job(thread) on every thread, 0 being the caller, and returns once all are done.
+     */
+    void Run(const std::function<void(unsigned)>& job);
+
+    unsigned GetThreadCount() const { return static_cast<unsigned>(threads.size()) + 1; }
+};
+
+/**
+ * @brief What the last flush of a RenderQueue cost.
+ */
+struct RenderQueueStats
+{
+    std::size_t commands = 0;         /**< Draw commands submitted. */
+    std::size_t textureSwitches = 0;  /**< Times consecutive draws used a different flyweight. */
+    std::size_t culled = 0;           /**< Commands the culler removed before drawing. */
+    double sortSeconds = 0.0;         /**< Time spent sorting the keys. */
+};
+
+/**
+ * @brief The order in which a RenderQueue draws the commands of one layer.
+ */
+enum class SortOrder
+{
+    ByTexture,  /**< Grouped by flyweight, then by depth: the fewest texture switches. */
+    ByDepth     /**< By depth, then by flyweight: back to front, as occlusion culling needs. */
+};
+
+/**
+ * @brief Collects draw commands for a frame and submits them in an order that minimizes
+ *        texture switches.
+ *
+ * Every command gets a 64-bit sort key:
+ *
+ * | bits  | 63..56 | 55..40                | 39..24 | 23..0                |
+ * |-------|--------|-----------------------|--------|----------------------|
+ * | field | layer  | flyweight id (low 16) | depth  | submission index     |
+ *
+ * With SortOrder::ByDepth the depth and flyweight id fields trade places, so commands are drawn
+ * back to front and the order only groups textures among commands at the same depth.
+ *
+ * Only the low 16 bits of the flyweight id fit in the key. The id only groups draws for batching,
+ * so flyweights whose ids are a multiple of 65536 apart are merely interleaved, costing texture
+ * switches, never drawn out of layer or depth order.
+ *
+ * Keys are sorted with an LSD radix sort on the five upper bytes. The submission index is only
+ * used to find the command again: LSD radix sort is stable, so commands with equal layer, texture
+ * and depth keep their submission order without sorting on it. Byte passes in which every key has
+ * the same digit are skipped. Large queues are sorted by several threads, each histogramming and
+ * scattering its own slice of the keys. The threads are started with the first such sort and
+ * reused by the following ones.
+ */
+class RenderQueue
+{
+private:
+    std::vector<DrawCommand> commands;
+    std::vector<std::uint64_t> keys;
+    std::vector<std::uint64_t> scratch;
+
+    std::size_t parallelThreshold = 1 << 16;
+    unsigned threadCount;
+    std::unique_ptr<WorkerPool> workers;
+
+    SortOrder order = SortOrder::ByTexture;
+
+    RenderQueueStats stats;
+
+public:
+    /**< The largest number of commands a queue can hold per frame. */
+    static constexpr std::size_t MaxCommands = std::size_t(1) << 24;
+
+    /**
+     * @brief Removes commands that need not be drawn, e.g. OcclusionBuffer::Cull.
+     *
+     * Receives the commands in the order they are about to be drawn, back to front, and must
+     * keep that order.
+     */
+    using Culler = std::function<void(SDL_Renderer*, std::vector<DrawCommand>&)>;
+
+private:
+    Culler culler;
+    std::vector<DrawCommand> drawOrder;
+
+public:
+    RenderQueue();
+
+    /**
+     * @brief Builds the sort key of a command. Only the low 16 bits of the flyweight id are kept.
+     */
+    static std::uint64_t MakeKey(std::uint8_t layer, std::uint16_t flyweightId, std::uint16_t depth, std::uint32_t index)
+    {
+        return (static_cast<std::uint64_t>(layer) << 56) | (static_cast<std::uint64_t>(flyweightId) << 40)
+             | (static_cast<std::uint64_t>(depth) << 24) | (index & 0xFFFFFFu);
+    }
+
+    /**
+     * @brief Queues a draw of the flyweight for this frame.
+     *
+     * @param flyweight The flyweight to draw. Must stay alive until the queue is flushed.
+     * @param x The x-coordinate for the rendering position.
+     * @param y The y-coordinate for the rendering position.
+     * @param layer Draw layer; lower layers are drawn first.
+     * @param depth Order within a layer and texture; lower depths are drawn first.
+     * @throws std::length_error If more than MaxCommands are queued.
+     */
+    void Submit(const Flyweight& flyweight, int x, int y, std::uint8_t layer = 0, std::uint16_t depth = 0);
+
+    /**
+     * @brief Sorts the queued commands by their keys.
+     */
+    void Sort();
+
+    /**
+     * @brief Sorts, culls if a culler is set, draws the remaining commands and empties the queue.
+     */
+    void Flush(SDL_Renderer* renderer);
+
+    /**
+     * @brief Drops the queued commands without drawing them.
+     */
+    void Clear();
+
+    /**
+     * @brief Queues at least this large are sorted on several threads.
+     */
+    void SetParallelThreshold(std::size_t commandCount) { parallelThreshold = commandCount; }
+    void SetThreadCount(unsigned count) { threadCount = count > 0 ? count : 1; }
+
+    /**
+     * @brief Sets the order of the commands submitted from now on.
+     */
+    void SetSortOrder(SortOrder newOrder) { order = newOrder; }
+
+    /**
+     * @brief Sets the culler run on every flush after sorting; an empty one disables culling.
+     *
+     * Culling against what is nearer only makes sense when the draw order is back to front, so
+     * a culler is normally paired with SortOrder::ByDepth.
+     */
+    void SetCuller(Culler newCuller) { culler = std::move(newCuller); }
+
+    const std::vector<std::uint64_t>& GetKeys() const { return keys; }
+    const std::vector<DrawCommand>& GetCommands() const { return commands; }
+    const RenderQueueStats& GetStats() const { return stats; }
+};
+
+/**
+ * @brief Stable LSD radix sort of 64-bit keys on the bytes firstByte..lastByte (inclusive).
+ *
+ * @param keys The keys to sort. Sorted in place.
+ * @param scratch Buffer reused between calls; resized as needed.
+ * @param firstByte Least significant byte that takes part in the order.
+ * @param lastByte Most significant byte that takes part in the order.
+ * @param threadCount Number of threads to use; 1 sorts on the calling thread.
+ */
+void RadixSortKeys(std::vector<std::uint64_t>& keys, std::vector<std::uint64_t>& scratch,
+                   int firstByte, int lastByte, unsigned threadCount = 1);
+
+/**
+ * @brief RadixSortKeys on the threads of a pool, which are reused rather than started for the sort.
+ */
+void RadixSortKeys(std::vector<std::uint64_t>& keys, std::vector<std::uint64_t>& scratch,
+                   int firstByte, int lastByte, WorkerPool& pool);
+
+#endif
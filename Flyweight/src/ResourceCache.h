@@ -0,0 +1,435 @@
+#ifndef RESOURCE_CACHE_H
+#define RESOURCE_CACHE_H
+
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <future>
+#include <limits>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Typed handle to a resource owned by a ResourceCache.
+ *
+ * A handle shares ownership of an immutable payload. While any handle to a resource is alive,
+ * the cache will never evict it, so handles are safe to keep across frames.
+ *
+ * @tparam T The payload type (texture, font, sound sample, data blob...).
+ */
+template <typename T>
+class ResourceHandle
+{
+private:
+    std::string key;
+    std::shared_ptr<const T> payload;
+
+public:
+    ResourceHandle() = default;
+
+    ResourceHandle(std::string key, std::shared_ptr<const T> payload)
+        : key(std::move(key)), payload(std::move(payload))
+    {
+    }
+
+    const T* operator->() const { return payload.get(); }
+    const T& operator*() const { return *payload; }
+    const T* Get() const { return payload.get(); }
+    explicit operator bool() const { return payload != nullptr; }
+
+    /**
+     * @brief Returns the key (usually a file path) the resource was loaded from.
+     */
+    const std::string& Key() const { return key; }
+
+    /**
+     * @brief Returns a shared pointer to the payload for APIs that expect one.
+     */
+    const std::shared_ptr<const T>& Share() const { return payload; }
+};
+
+/**
+ * @brief Generic flyweight cache for shared, immutable resources.
+ *
+ * Generalizes the texture-only FlyweightFactory to any payload type. Resources are created by a
+ * pluggable loader, keyed by string (usually a file path) and handed out as ResourceHandle<T>.
+ *
+ * - **Deduplication**: concurrent requests for the same key, whether through Get or GetAsync and
+ *   from any thread, run the loader exactly once; every other caller waits for that load.
+ * - **Async loading**: GetAsync runs the loader on a worker thread and returns a shared future.
+ *   Only use it with loaders that are thread-safe (file blobs, fonts, sound samples). Loaders that
+ *   touch an SDL_Renderer must stay on the render thread and use Get.
+ * - **Budget-based eviction**: every resident resource, referenced or not, is charged the number
+ *   of bytes reported by the sizer. When the total exceeds the budget, least recently used
+ *   resources that are no longer referenced by any handle are dropped; referenced ones stay, so
+ *   the total may remain above the budget.
+ * - **Shared payloads**: a loader may return a payload already cached under another key, e.g. an
+ *   image whose pixels match one loaded before. The payload is charged once, and an entry counts
+ *   as unreferenced when only cache entries hold its payload.
+ *
+ * A loader must not request its own key, directly or through other keys it loads: the load
+ * would wait for itself. Such a Get throws std::logic_error instead of deadlocking.
+ *
+ * @code
+ * ResourceCache<std::vector<char>> blobs([](const std::string& path) {
+ *     return std::make_shared<std::vector<char>>(ReadWholeFile(path));
+ * }, 64 * 1024 * 1024, [](const std::vector<char>& blob) { return blob.size(); });
+ *
+ * auto pending = blobs.GetAsync("levels/level1.bin");
+ * ResourceHandle<std::vector<char>> level = pending.get();
+ * @endcode
+ *
+ * @tparam T The payload type.
+ */
+template <typename T>
+class ResourceCache
+{
+public:
+    using Handle = ResourceHandle<T>;
+    using Loader = std::function<std::shared_ptr<T>(const std::string&)>;
+    using Sizer = std::function<std::size_t(const T&)>;
+
+private:
+    struct Entry
+    {
+        std::shared_ptr<const T> payload;
+        std::size_t bytes;
+        typename std::list<std::string>::iterator lruPosition;
+    };
+
+    Loader loader;
+    Sizer sizer;
+    std::size_t budgetBytes;
+    std::size_t residentBytes = 0;
+
+    mutable std::mutex mutex;
+    /**< Loaded resources mapped by key. */
+    std::unordered_map<std::string, Entry> entries;
+    /**< Keys ordered from most to least recently used. */
+    std::list<std::string> lru;
+    /**< Number of entries holding each payload; the bytes of a payload are charged once. */
+    std::unordered_map<const T*, long> payloadEntries;
+    /**< Loads that have started but not finished yet, shared by every waiter. */
+    std::unordered_map<std::string, std::shared_future<Handle>> inFlight;
+    /**< Worker tasks started by GetAsync, joined on destruction. */
+    std::vector<std::future<void>> workers;
+
+public:
+    /**
+     * @brief Constructs a cache with a default loader.
+     *
+     * @param loader Creates the payload for a key. May throw to signal a failed load.
+     * @param budgetBytes Soft limit on the bytes held by resident resources; only unreferenced
+     *        ones are evicted to meet it.
+     * @param sizer Reports the cost of a payload in bytes. Without it every resource costs 0.
+     */
+    explicit ResourceCache(Loader loader = {},
+                           std::size_t budgetBytes = std::numeric_limits<std::size_t>::max(),
+                           Sizer sizer = {})
+        : loader(std::move(loader)), sizer(std::move(sizer)), budgetBytes(budgetBytes)
+    {
+    }
+
+    ResourceCache(const ResourceCache&) = delete;
+    ResourceCache& operator=(const ResourceCache&) = delete;
+
+    /**
+     * @brief Waits for outstanding async loads so that workers never outlive the cache.
+     */
+    ~ResourceCache()
+    {
+        for (auto& worker : workers)
+        {
+            worker.wait();
+        }
+    }
+
+    /**
+     * @brief Returns the resource for the key, loading it with the default loader if needed.
+     *
+     * @throws Whatever the loader throws if the resource cannot be created.
+     */
+    Handle Get(const std::string& key)
+    {
+        return Get(key, loader);
+    }
+
+    /**
+     * @brief Returns the resource for the key, loading it with the given loader if needed.
+     *
+     * Useful when the loader needs context only known at the call site, such as the renderer.
+     *
+     * @throws std::logic_error If called by a loader running for the same key on this thread.
+     */
+    Handle Get(const std::string& key, const Loader& customLoader)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        if (auto cached = Lookup(key))
+        {
+            return cached;
+        }
+
+        auto pending = inFlight.find(key);
+        if (pending != inFlight.end())
+        {
+            if (IsLoadingOnThisThread(key))
+            {
+                throw std::logic_error("ResourceCache: the loader of '" + key + "' requested its own key");
+            }
+            std::shared_future<Handle> future = pending->second;
+            lock.unlock();
+            return future.get();
+        }
+
+        auto promise = std::make_shared<std::promise<Handle>>();
+        inFlight.emplace(key, promise->get_future().share());
+        lock.unlock();
+
+        return Load(key, customLoader, *promise);
+    }
+
+    /**
+     * @brief Starts loading the resource on a worker thread with the default loader.
+     *
+     * @return A future that becomes ready once the resource is loaded. If the resource is cached
+     *         the future is ready immediately; if it is being loaded the existing future is shared.
+     */
+    std::shared_future<Handle> GetAsync(const std::string& key)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (auto cached = Lookup(key))
+        {
+            std::promise<Handle> ready;
+            ready.set_value(std::move(cached));
+            return ready.get_future().share();
+        }
+
+        auto pending = inFlight.find(key);
+        if (pending != inFlight.end())
+        {
+            return pending->second;
+        }
+
+        auto promise = std::make_shared<std::promise<Handle>>();
+        std::shared_future<Handle> future = promise->get_future().share();
+        inFlight.emplace(key, future);
+
+        PruneFinishedWorkers();
+        workers.push_back(std::async(std::launch::async, [this, key, promise]()
+        {
+            try
+            {
+                Load(key, loader, *promise);
+            }
+            catch (...)
+            {
+                // The exception has already been forwarded to the waiters through the promise.
+            }
+        }));
+
+        return future;
+    }
+
+    /**
+     * @brief Checks whether the resource is resident without loading it.
+     */
+    bool Contains(const std::string& key) const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return entries.find(key) != entries.end();
+    }
+
+    /**
+     * @brief Changes the budget and evicts unreferenced resources until it is respected.
+     */
+    void SetBudget(std::size_t bytes)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        budgetBytes = bytes;
+        Trim();
+    }
+
+    std::size_t Budget() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return budgetBytes;
+    }
+
+    std::size_t ResidentBytes() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return residentBytes;
+    }
+
+    std::size_t Size() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return entries.size();
+    }
+
+    /**
+     * @brief Drops every resource that is no longer referenced by a handle.
+     */
+    void EvictUnused()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (auto it = lru.begin(); it != lru.end();)
+        {
+            auto entry = entries.find(*it++);
+            if (IsUnreferenced(entry->second))
+            {
+                Erase(entry);
+            }
+        }
+    }
+
+private:
+    /**
+     * @brief Returns the cached handle and marks it as most recently used. Requires the lock.
+     */
+    Handle Lookup(const std::string& key)
+    {
+        auto it = entries.find(key);
+        if (it == entries.end())
+        {
+            return Handle();
+        }
+
+        lru.splice(lru.begin(), lru, it->second.lruPosition);
+        return Handle(key, it->second.payload);
+    }
+
+    /**
+     * @brief Keys whose loader is running on the calling thread, innermost last, for every cache.
+     */
+    static std::vector<std::pair<const ResourceCache*, std::string>>& LoadsOnThisThread()
+    {
+        thread_local std::vector<std::pair<const ResourceCache*, std::string>> loads;
+        return loads;
+    }
+
+    bool IsLoadingOnThisThread(const std::string& key) const
+    {
+        for (const auto& load : LoadsOnThisThread())
+        {
+            if (load.first == this && load.second == key)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Runs the loader outside the lock, publishes the result and wakes the waiters.
+     */
+    Handle Load(const std::string& key, const Loader& useLoader, std::promise<Handle>& promise)
+    {
+        std::shared_ptr<const T> payload;
+        try
+        {
+            if (!useLoader)
+            {
+                throw std::bad_function_call();
+            }
+            struct LoadScope
+            {
+                LoadScope(const ResourceCache* cache, const std::string& key) { LoadsOnThisThread().emplace_back(cache, key); }
+                ~LoadScope() { LoadsOnThisThread().pop_back(); }
+            } scope(this, key);
+            payload = useLoader(key);
+        }
+        catch (...)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                inFlight.erase(key);
+            }
+            promise.set_exception(std::current_exception());
+            throw;
+        }
+
+        std::size_t bytes = (sizer && payload) ? sizer(*payload) : 0;
+        Handle handle(key, payload);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            lru.push_front(key);
+            if (payloadEntries[payload.get()]++ == 0)
+            {
+                residentBytes += bytes;
+            }
+            entries[key] = Entry{std::move(payload), bytes, lru.begin()};
+            inFlight.erase(key);
+            Trim();
+        }
+        promise.set_value(handle);
+        return handle;
+    }
+
+    /**
+     * @brief Evicts least recently used, unreferenced resources while over budget. Requires the lock.
+     */
+    void Trim()
+    {
+        for (auto it = lru.end(); residentBytes > budgetBytes && it != lru.begin();)
+        {
+            --it;
+            auto entry = entries.find(*it++);
+            if (IsUnreferenced(entry->second))
+            {
+                Erase(entry);
+            }
+            else
+            {
+                --it;
+            }
+        }
+    }
+
+    /**
+     * @brief True if no handle holds the payload, only cache entries. Requires the lock.
+     */
+    bool IsUnreferenced(const Entry& entry) const
+    {
+        return entry.payload.use_count() == payloadEntries.at(entry.payload.get());
+    }
+
+    /**
+     * @brief Drops an entry, and the charge of its payload with the last entry holding it.
+     */
+    void Erase(typename std::unordered_map<std::string, Entry>::iterator entry)
+    {
+        auto holders = payloadEntries.find(entry->second.payload.get());
+        if (--holders->second == 0)
+        {
+            residentBytes -= entry->second.bytes;
+            payloadEntries.erase(holders);
+        }
+        lru.erase(entry->second.lruPosition);
+        entries.erase(entry);
+    }
+
+    void PruneFinishedWorkers()
+    {
+        for (auto it = workers.begin(); it != workers.end();)
+        {
+            if (it->wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+            {
+                it = workers.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+};
+
+#endif
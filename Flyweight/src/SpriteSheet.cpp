@@ -0,0 +1,126 @@
+#include "SpriteSheet.h"
+
+#include <stdexcept>
+#include <utility>
+
+
+SpriteSheet::SpriteSheet(std::shared_ptr<const TextureFlyweight> sheet, std::vector<SDL_Rect> frames,
+                         std::vector<std::uint16_t> frameDurationsMs)
+    : sheet(std::move(sheet)), frames(std::move(frames)), frameDurationsMs(std::move(frameDurationsMs))
+{
+    if (!this->sheet || this->frames.empty() || this->frames.size() != this->frameDurationsMs.size()
+        || this->frames.size() > UINT16_MAX)
+    {
+        throw std::invalid_argument("Sprite sheet needs a texture and one duration per frame");
+    }
+
+    for (std::uint16_t duration : this->frameDurationsMs)
+    {
+        if (duration == 0)
+        {
+            throw std::invalid_argument("Sprite sheet frame durations must be positive");
+        }
+        loopDurationMs += duration;
+    }
+}
+
+std::shared_ptr<const SpriteSheet> SpriteSheet::FromGrid(std::shared_ptr<const TextureFlyweight> sheet,
+                                                         int frameWidth, int frameHeight, int frameCount,
+                                                         std::uint16_t frameDurationMs)
+{
+    int sheetWidth = 0;
+    if (!sheet || SDL_QueryTexture(sheet->GetTexture(), nullptr, nullptr, &sheetWidth, nullptr) != 0)
+    {
+        throw std::invalid_argument("Sprite sheet texture is not valid");
+    }
+
+    int columns = frameWidth > 0 ? sheetWidth / frameWidth : 0;
+    if (columns == 0)
+    {
+        throw std::invalid_argument("Sprite sheet frame is wider than the sheet");
+    }
+
+    std::vector<SDL_Rect> frames;
+    for (int frame = 0; frame < frameCount; ++frame)
+    {
+        frames.push_back(SDL_Rect{(frame % columns) * frameWidth, (frame / columns) * frameHeight, frameWidth, frameHeight});
+    }
+    std::vector<std::uint16_t> durations(frames.size(), frameDurationMs);
+
+    return std::make_shared<const SpriteSheet>(std::move(sheet), std::move(frames), std::move(durations));
+}
+
+
+AnimationSet::AnimationSet(std::shared_ptr<const SpriteSheet> sheet)
+    : sheet(std::move(sheet))
+{
+}
+
+std::size_t AnimationSet::Add(int x, int y, std::uint32_t startOffsetMs)
+{
+    frames.push_back(0);
+    elapsedMs.push_back(0);
+    positions.push_back(SDL_Point{x, y});
+
+    std::size_t index = frames.size() - 1;
+    if (startOffsetMs != 0)
+    {
+        // Walk the frame table to find the frame the offset lands on.
+        std::uint32_t offset = startOffsetMs % sheet->GetLoopDuration();
+        const std::uint16_t* durations = sheet->GetFrameDurations();
+        std::uint16_t frame = 0;
+        while (offset >= durations[frame])
+        {
+            offset -= durations[frame];
+            ++frame;
+        }
+        frames[index] = frame;
+        elapsedMs[index] = static_cast<std::uint16_t>(offset);
+    }
+    return index;
+}
+
+void AnimationSet::Remove(std::size_t index)
+{
+    frames[index] = frames.back();
+    elapsedMs[index] = elapsedMs.back();
+    positions[index] = positions.back();
+    frames.pop_back();
+    elapsedMs.pop_back();
+    positions.pop_back();
+}
+
+void AnimationSet::Advance(std::uint32_t deltaMs)
+{
+    const std::uint16_t* durations = sheet->GetFrameDurations();
+    const std::uint16_t frameCount = sheet->GetFrameCount();
+
+    // Whole loops bring every instance back to where it was, so only the remainder matters.
+    // This also keeps the elapsed time within a frame duration, which fits 16 bits.
+    const std::uint32_t step = deltaMs % sheet->GetLoopDuration();
+
+    std::uint16_t* frame = frames.data();
+    std::uint16_t* elapsed = elapsedMs.data();
+    const std::size_t count = frames.size();
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        std::uint32_t time = elapsed[i] + step;
+        std::uint16_t current = frame[i];
+        while (time >= durations[current])
+        {
+            time -= durations[current];
+            current = static_cast<std::uint16_t>(current + 1 == frameCount ? 0 : current + 1);
+        }
+        frame[i] = current;
+        elapsed[i] = static_cast<std::uint16_t>(time);
+    }
+}
+
+void AnimationSet::Draw(SDL_Renderer* renderer) const
+{
+    for (std::size_t i = 0; i < frames.size(); ++i)
+    {
+        sheet->DrawFrame(renderer, frames[i], positions[i].x, positions[i].y);
+    }
+}
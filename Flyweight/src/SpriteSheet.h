@@ -0,0 +1,117 @@
+#ifndef SPRITE_SHEET_H
+#define SPRITE_SHEET_H
+
+#include <SDL2/SDL.h>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "Flyweight.h"
+
+/**
+ * @brief Flyweight for an animated sprite: one sheet texture plus an immutable frame table.
+ *
+ * Everything that is the same for every instance of an animation lives here and is shared:
+ * the texture, the region of every frame and how long each frame is shown. Instances only
+ * keep which frame they are on and how long they have been on it (see AnimationSet).
+ */
+class SpriteSheet
+{
+private:
+    std::shared_ptr<const TextureFlyweight> sheet;
+    std::vector<SDL_Rect> frames;
+    std::vector<std::uint16_t> frameDurationsMs;
+    std::uint32_t loopDurationMs = 0;
+
+public:
+    /**
+     * @brief Constructs a sheet from explicit frame regions.
+     *
+     * @param sheet The texture holding every frame.
+     * @param frames Region of each frame inside the sheet, in playback order.
+     * @param frameDurationsMs How long each frame is shown, in milliseconds.
+     * @throws std::invalid_argument If the tables are empty, mismatched or a duration is zero.
+     */
+    SpriteSheet(std::shared_ptr<const TextureFlyweight> sheet, std::vector<SDL_Rect> frames,
+                std::vector<std::uint16_t> frameDurationsMs);
+
+    /**
+     * @brief Builds a sheet whose frames are laid out on a regular grid, left to right, top to bottom.
+     *
+     * @param sheet The texture holding every frame.
+     * @param frameWidth Width of one frame in texels.
+     * @param frameHeight Height of one frame in texels.
+     * @param frameCount Number of frames to take from the grid.
+     * @param frameDurationMs How long every frame is shown, in milliseconds.
+     */
+    static std::shared_ptr<const SpriteSheet> FromGrid(std::shared_ptr<const TextureFlyweight> sheet,
+                                                       int frameWidth, int frameHeight, int frameCount,
+                                                       std::uint16_t frameDurationMs);
+
+    /**
+     * @brief Draws one frame of the animation at the given position.
+     */
+    void DrawFrame(SDL_Renderer* renderer, std::uint16_t frame, int x, int y) const
+    {
+        const SDL_Rect& source = frames[frame];
+        SDL_Rect destination = {x, y, source.w, source.h};
+        sheet->DrawRegion(renderer, source, destination);
+    }
+
+    std::uint16_t GetFrameCount() const { return static_cast<std::uint16_t>(frames.size()); }
+    const std::uint16_t* GetFrameDurations() const { return frameDurationsMs.data(); }
+    std::uint32_t GetLoopDuration() const { return loopDurationMs; }
+};
+
+/**
+ * @brief All instances of one sprite sheet, stored as structure of arrays.
+ *
+ * Per-instance animation state is 4 bytes: the current frame and the time spent on it, each in
+ * its own array. Advance walks both arrays once for every instance, and Draw walks them together
+ * with the positions. Instances are addressed by index; removal swaps with the last one.
+ */
+class AnimationSet
+{
+private:
+    std::shared_ptr<const SpriteSheet> sheet;
+
+    std::vector<std::uint16_t> frames;     /**< Current frame of each instance. */
+    std::vector<std::uint16_t> elapsedMs;  /**< Time each instance has spent on its current frame. */
+    std::vector<SDL_Point> positions;      /**< Extrinsic render position of each instance. */
+
+public:
+    /**< Bytes of animation state per instance, excluding the position. */
+    static constexpr std::size_t StateBytesPerInstance = sizeof(std::uint16_t) + sizeof(std::uint16_t);
+    static_assert(StateBytesPerInstance <= 8, "Per-instance animation state must stay within 8 bytes");
+
+    explicit AnimationSet(std::shared_ptr<const SpriteSheet> sheet);
+
+    /**
+     * @brief Adds an instance, optionally starting part way into the animation.
+     *
+     * @return The index of the new instance.
+     */
+    std::size_t Add(int x, int y, std::uint32_t startOffsetMs = 0);
+
+    /**
+     * @brief Removes an instance by moving the last instance into its slot.
+     */
+    void Remove(std::size_t index);
+
+    /**
+     * @brief Advances every instance by the same time step in a single pass.
+     */
+    void Advance(std::uint32_t deltaMs);
+
+    /**
+     * @brief Draws every instance at its current frame.
+     */
+    void Draw(SDL_Renderer* renderer) const;
+
+    void SetPosition(std::size_t index, int x, int y) { positions[index] = SDL_Point{x, y}; }
+    std::uint16_t GetFrame(std::size_t index) const { return frames[index]; }
+    std::size_t Size() const { return frames.size(); }
+};
+
+#endif
@@ -0,0 +1,245 @@
+#include "StaticLayer.h"
+
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "DirtyRects.h"
+
+namespace
+{
+    bool IsEmpty(const SDL_Rect& rect)
+    {
+        return rect.w <= 0 || rect.h <= 0;
+    }
+}
+
+
+StaticLayer::StaticLayer(LayerInvalidation invalidation)
+    : invalidation(invalidation)
+{
+}
+
+StaticLayer::~StaticLayer()
+{
+    if (target)
+    {
+        SDL_DestroyTexture(target);
+    }
+}
+
+std::size_t StaticLayer::Add(std::shared_ptr<const Flyweight> flyweight, int x, int y)
+{
+    if (!flyweight)
+    {
+        throw std::invalid_argument("StaticLayer instances need a flyweight");
+    }
+
+    std::size_t id;
+    if (!freeSlots.empty())
+    {
+        // A reused slot is drawn in its old position in the order, so the layer must be rebuilt
+        // for the new instance to appear on top.
+        id = freeSlots.back();
+        freeSlots.pop_back();
+        instances[id] = Instance{std::move(flyweight), x, y};
+        needsRebuild = true;
+    }
+    else
+    {
+        id = instances.size();
+        instances.push_back(Instance{std::move(flyweight), x, y});
+        Invalidate(instances[id]);
+    }
+    return id;
+}
+
+StaticLayer::Instance& StaticLayer::LiveInstance(std::size_t id)
+{
+    if (id >= instances.size() || !instances[id].flyweight)
+    {
+        throw std::out_of_range("StaticLayer has no instance " + std::to_string(id));
+    }
+    return instances[id];
+}
+
+void StaticLayer::Move(std::size_t id, int x, int y)
+{
+    Instance& instance = LiveInstance(id);
+    if (instance.x == x && instance.y == y)
+    {
+        return;
+    }
+    Invalidate(instance);
+    instance.x = x;
+    instance.y = y;
+    Invalidate(instance);
+}
+
+void StaticLayer::Replace(std::size_t id, std::shared_ptr<const Flyweight> flyweight)
+{
+    if (!flyweight)
+    {
+        throw std::invalid_argument("StaticLayer instances need a flyweight");
+    }
+    Instance& instance = LiveInstance(id);
+    Invalidate(instance);
+    instance.flyweight = std::move(flyweight);
+    Invalidate(instance);
+}
+
+void StaticLayer::Remove(std::size_t id)
+{
+    Instance& instance = LiveInstance(id);
+    Invalidate(instance);
+    instance.flyweight.reset();
+    freeSlots.push_back(id);
+}
+
+void StaticLayer::Invalidate(const Instance& instance)
+{
+    if (needsRebuild || !instance.flyweight)
+    {
+        return;
+    }
+
+    SDL_Rect bounds = instance.flyweight->GetBounds(instance.x, instance.y);
+    if (invalidation == LayerInvalidation::FullRebuild || IsEmpty(bounds))
+    {
+        needsRebuild = true;
+        dirtyRegions.clear();
+        return;
+    }
+    dirtyRegions.push_back(bounds);
+}
+
+bool StaticLayer::EnsureTarget(SDL_Renderer* renderer)
+{
+    int outputWidth = 0;
+    int outputHeight = 0;
+    if (SDL_GetRendererOutputSize(renderer, &outputWidth, &outputHeight) != 0)
+    {
+        return false;
+    }
+
+    if (target && outputWidth == width && outputHeight == height)
+    {
+        return true;
+    }
+
+    if (target)
+    {
+        SDL_DestroyTexture(target);
+        target = nullptr;
+    }
+
+    SDL_RendererInfo info;
+    if (SDL_GetRendererInfo(renderer, &info) != 0 || !(info.flags & SDL_RENDERER_TARGETTEXTURE))
+    {
+        return false;
+    }
+
+    target = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, outputWidth, outputHeight);
+    if (!target)
+    {
+        return false;
+    }
+    SDL_SetTextureBlendMode(target, SDL_BLENDMODE_BLEND);
+    width = outputWidth;
+    height = outputHeight;
+    needsRebuild = true;
+    return true;
+}
+
+void StaticLayer::Redraw(SDL_Renderer* renderer, const SDL_Rect* region)
+{
+    if (region)
+    {
+        SDL_RenderSetClipRect(renderer, region);
+        SDL_RenderFillRect(renderer, region);
+    }
+    else
+    {
+        SDL_RenderClear(renderer);
+    }
+
+    for (const Instance& instance : instances)
+    {
+        if (!instance.flyweight)
+        {
+            continue;
+        }
+        if (region)
+        {
+            SDL_Rect bounds = instance.flyweight->GetBounds(instance.x, instance.y);
+            if (!IsEmpty(bounds) && !SDL_HasIntersection(&bounds, region))
+            {
+                continue;
+            }
+        }
+        instance.flyweight->Draw(renderer, instance.x, instance.y);
+        ++stats.instancesRedrawn;
+    }
+
+    if (region)
+    {
+        SDL_RenderSetClipRect(renderer, nullptr);
+    }
+}
+
+void StaticLayer::Composite(SDL_Renderer* renderer)
+{
+    stats = StaticLayerStats();
+
+    if (!EnsureTarget(renderer))
+    {
+        // No render-target support: draw the instances directly, every frame.
+        for (const Instance& instance : instances)
+        {
+            if (instance.flyweight)
+            {
+                instance.flyweight->Draw(renderer, instance.x, instance.y);
+                ++stats.instancesRedrawn;
+            }
+        }
+        return;
+    }
+
+    if (needsRebuild || !dirtyRegions.empty())
+    {
+        Uint8 r, g, b, a;
+        SDL_BlendMode blendMode;
+        SDL_GetRenderDrawColor(renderer, &r, &g, &b, &a);
+        SDL_GetRenderDrawBlendMode(renderer, &blendMode);
+        SDL_Texture* previousTarget = SDL_GetRenderTarget(renderer);
+
+        SDL_SetRenderTarget(renderer, target);
+        // Clearing must replace the old pixels with transparency, not blend over them.
+        SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+
+        if (needsRebuild)
+        {
+            Redraw(renderer, nullptr);
+            stats.rebuilt = true;
+        }
+        else
+        {
+            MergeDamageRects(dirtyRegions);
+            for (const SDL_Rect& region : dirtyRegions)
+            {
+                Redraw(renderer, &region);
+            }
+            stats.regionsRedrawn = dirtyRegions.size();
+        }
+
+        SDL_SetRenderTarget(renderer, previousTarget);
+        SDL_SetRenderDrawBlendMode(renderer, blendMode);
+        SDL_SetRenderDrawColor(renderer, r, g, b, a);
+
+        needsRebuild = false;
+        dirtyRegions.clear();
+    }
+
+    SDL_RenderCopy(renderer, target, nullptr, nullptr);
+}
@@ -0,0 +1,109 @@
+#ifndef STATIC_LAYER_H
+#define STATIC_LAYER_H
+
+#include <SDL2/SDL.h>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "Flyweight.h"
+
+/**
+ * @brief How a StaticLayer reacts to a change of one of its instances.
+ */
+enum class LayerInvalidation
+{
+    DirtyRegion,  /**< Clear and redraw only the area the changed instance covered and now covers. */
+    FullRebuild   /**< Redraw the whole layer. */
+};
+
+/**
+ * @brief What the last Composite call of a StaticLayer did.
+ */
+struct StaticLayerStats
+{
+    bool rebuilt = false;                 /**< The whole layer was redrawn. */
+    std::size_t regionsRedrawn = 0;       /**< Dirty regions cleared and redrawn. */
+    std::size_t instancesRedrawn = 0;     /**< Draw calls issued into the layer texture. */
+};
+
+/**
+ * @brief Caches instances that do not move in a render-target texture.
+ *
+ * Static instances are drawn once into an SDL_TEXTUREACCESS_TARGET texture, after which every
+ * frame costs a single SDL_RenderCopy of that texture no matter how many instances it holds.
+ * Moving, replacing, adding or removing an instance invalidates the layer: either just the
+ * affected region, or the whole layer, depending on the LayerInvalidation mode. Instances whose
+ * flyweight cannot report its bounds always cause a full rebuild.
+ *
+ * If the renderer does not support render targets, the layer falls back to drawing every
+ * instance each frame.
+ */
+class StaticLayer
+{
+private:
+    struct Instance
+    {
+        std::shared_ptr<const Flyweight> flyweight;
+        int x;
+        int y;
+    };
+
+    /**< Instances in draw order; removed slots keep a null flyweight and are reused. */
+    std::vector<Instance> instances;
+    std::vector<std::size_t> freeSlots;
+
+    SDL_Texture* target = nullptr;
+    int width = 0;
+    int height = 0;
+
+    LayerInvalidation invalidation;
+    bool needsRebuild = true;
+    std::vector<SDL_Rect> dirtyRegions;
+
+    StaticLayerStats stats;
+
+    Instance& LiveInstance(std::size_t id);
+    void Invalidate(const Instance& instance);
+    bool EnsureTarget(SDL_Renderer* renderer);
+    void Redraw(SDL_Renderer* renderer, const SDL_Rect* region);
+
+public:
+    explicit StaticLayer(LayerInvalidation invalidation = LayerInvalidation::DirtyRegion);
+    ~StaticLayer();
+
+    StaticLayer(const StaticLayer&) = delete;
+    StaticLayer& operator=(const StaticLayer&) = delete;
+
+    /**
+     * @brief Adds a static instance on top of the existing ones.
+     *
+     * @return The id of the instance, valid until it is removed.
+     * @throws std::invalid_argument If the flyweight is null.
+     */
+    std::size_t Add(std::shared_ptr<const Flyweight> flyweight, int x, int y);
+
+    /**
+     * Move, Replace and Remove throw std::out_of_range for an id that was never added or was
+     * removed already, and Replace throws std::invalid_argument for a null flyweight.
+     */
+    void Move(std::size_t id, int x, int y);
+    void Replace(std::size_t id, std::shared_ptr<const Flyweight> flyweight);
+    void Remove(std::size_t id);
+
+    /**
+     * @brief Forces a full rebuild, e.g. after SDL_RENDER_TARGETS_RESET lost the texture contents.
+     */
+    void Invalidate() { needsRebuild = true; }
+
+    void SetInvalidation(LayerInvalidation mode) { invalidation = mode; }
+
+    /**
+     * @brief Brings the cached texture up to date and copies it onto the current render target.
+     */
+    void Composite(SDL_Renderer* renderer);
+
+    const StaticLayerStats& GetStats() const { return stats; }
+};
+
+#endif
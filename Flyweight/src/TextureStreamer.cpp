@@ -0,0 +1,441 @@
+#include "TextureStreamer.h"
+
+#include <SDL2/SDL_image.h>
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <queue>
+#include <stdexcept>
+#include <utility>
+
+#include "PngDecoder.h"
+
+namespace
+{
+    std::size_t TierBytes(int sourceWidth, int sourceHeight, int tier)
+    {
+        return static_cast<std::size_t>(std::max(1, sourceWidth >> tier)) * std::max(1, sourceHeight >> tier) * 4;
+    }
+
+    /**
+     * @brief Halves a 32-bit surface with a 2x2 box filter. Frees the input.
+     */
+    SDL_Surface* Downsample(SDL_Surface* source)
+    {
+        const int width = std::max(1, source->w / 2);
+        const int height = std::max(1, source->h / 2);
+        SDL_Surface* result = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, source->format->format);
+        if (!result)
+        {
+            SDL_FreeSurface(source);
+            return nullptr;
+        }
+
+        for (int y = 0; y < height; ++y)
+        {
+            const int y0 = std::min(2 * y, source->h - 1);
+            const int y1 = std::min(2 * y + 1, source->h - 1);
+            const auto* row0 = static_cast<const std::uint8_t*>(source->pixels) + y0 * source->pitch;
+            const auto* row1 = static_cast<const std::uint8_t*>(source->pixels) + y1 * source->pitch;
+            auto* out = static_cast<std::uint8_t*>(result->pixels) + y * result->pitch;
+            for (int x = 0; x < width; ++x)
+            {
+                const int x0 = std::min(2 * x, source->w - 1) * 4;
+                const int x1 = std::min(2 * x + 1, source->w - 1) * 4;
+                for (int c = 0; c < 4; ++c)
+                {
+                    out[x * 4 + c] = static_cast<std::uint8_t>((row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c] + 2) / 4);
+                }
+            }
+        }
+
+        SDL_FreeSurface(source);
+        return result;
+    }
+
+    /**
+     * @brief Decodes an image in the given 32-bit format. Returns nullptr on failure.
+     */
+    SDL_Surface* DecodeImage(const TextureStreamer::Decoder& decode, const std::string& path, Uint32 format)
+    {
+        SDL_Surface* surface = decode(path);
+        if (!surface || surface->format->format == format)
+        {
+            return surface;
+        }
+        SDL_Surface* converted = SDL_ConvertSurfaceFormat(surface, format, 0);
+        SDL_FreeSurface(surface);
+        return converted;
+    }
+
+    SDL_Surface* ReduceToTier(SDL_Surface* surface, int tier)
+    {
+        for (int i = 0; i < tier && surface; ++i)
+        {
+            surface = Downsample(surface);
+        }
+        return surface;
+    }
+
+    int CountTiers(int width, int height, int coarsestSize)
+    {
+        int tiers = 1;
+        while ((width >> (tiers - 1)) > coarsestSize || (height >> (tiers - 1)) > coarsestSize)
+        {
+            ++tiers;
+        }
+        return tiers;
+    }
+
+    bool IsReady(const std::future<SDL_Surface*>& future)
+    {
+        return future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    }
+}
+
+
+StreamedTexture::~StreamedTexture()
+{
+    SDL_DestroyTexture(coarsest);
+    if (detail)
+    {
+        SDL_DestroyTexture(detail);
+    }
+}
+
+void StreamedTexture::Draw(SDL_Renderer* renderer, int x, int y) const
+{
+    SDL_Rect dstRect = {x, y, width, height};
+    SDL_RenderCopy(renderer, detail ? detail : coarsest, nullptr, &dstRect);
+}
+
+std::size_t StreamedTexture::GetTierBytes(int tier) const
+{
+    return TierBytes(sourceWidth, sourceHeight, tier);
+}
+
+
+TextureStreamer::TextureStreamer(SDL_Renderer* renderer, std::size_t budgetBytes, Decoder decode)
+    : renderer(renderer), decode(std::move(decode)), pixelFormat(GetNativePngFormat(renderer)), budgetBytes(budgetBytes)
+{
+    if (!this->decode)
+    {
+        const Uint32 format = pixelFormat;
+        this->decode = [format](const std::string& path)
+        {
+            if (SDL_Surface* surface = LoadPngSurface(path, format))
+            {
+                return surface;
+            }
+            return IMG_Load(path.c_str());
+        };
+    }
+    SDL_GetRendererOutputSize(renderer, &screenWidth, &screenHeight);
+}
+
+TextureStreamer::~TextureStreamer()
+{
+    for (Entry& entry : entries)
+    {
+        if (entry.pending.valid())
+        {
+            SDL_FreeSurface(entry.pending.get());
+        }
+    }
+}
+
+std::shared_ptr<const StreamedTexture> TextureStreamer::Get(const std::string& path)
+{
+    auto found = entriesByPath.find(path);
+    if (found != entriesByPath.end())
+    {
+        return entries[found->second].texture;
+    }
+
+    SDL_Surface* surface = DecodeImage(decode, path, pixelFormat);
+    if (!surface)
+    {
+        throw std::runtime_error("Failed to load image: " + path);
+    }
+
+    std::shared_ptr<StreamedTexture> texture(new StreamedTexture());
+    texture->sourceWidth = surface->w;
+    texture->sourceHeight = surface->h;
+    texture->width = surface->w / 4;
+    texture->height = surface->h / 4;
+    texture->tierCount = CountTiers(surface->w, surface->h, CoarsestTierSize);
+    texture->opaque = IsFullyOpaque(surface);
+
+    // The coarsest tier that still has a texel per screen pixel of the drawn size.
+    texture->neededTier = 0;
+    while (texture->neededTier + 1 < texture->tierCount
+           && (surface->w >> (texture->neededTier + 1)) >= texture->width
+           && (surface->h >> (texture->neededTier + 1)) >= texture->height)
+    {
+        ++texture->neededTier;
+    }
+
+    surface = ReduceToTier(surface, texture->tierCount - 1);
+    if (!surface)
+    {
+        throw std::runtime_error("Failed to downsample image: " + path);
+    }
+    texture->coarsest = SDL_CreateTextureFromSurface(renderer, surface);
+    SDL_FreeSurface(surface);
+    if (!texture->coarsest)
+    {
+        throw std::runtime_error(std::string("Failed to create texture: ") + SDL_GetError());
+    }
+
+    Entry entry;
+    entry.texture = texture;
+    entry.path = path;
+    entry.targetTier = texture->tierCount - 1;
+    entriesByPath[path] = entries.size();
+    entriesByFlyweight[texture.get()] = entries.size();
+    entries.push_back(std::move(entry));
+    return texture;
+}
+
+void TextureStreamer::AddCoverage(const Flyweight& flyweight, int x, int y)
+{
+    auto found = entriesByFlyweight.find(&flyweight);
+    if (found == entriesByFlyweight.end())
+    {
+        return;
+    }
+
+    SDL_Rect bounds = flyweight.GetBounds(x, y);
+    SDL_Rect screen = {0, 0, screenWidth, screenHeight};
+    SDL_Rect visible;
+    if (SDL_IntersectRect(&bounds, &screen, &visible))
+    {
+        entries[found->second].frameCoverage += static_cast<std::uint64_t>(visible.w) * visible.h;
+    }
+}
+
+void TextureStreamer::AddCoverage(const std::vector<DrawCommand>& commands)
+{
+    for (const DrawCommand& command : commands)
+    {
+        AddCoverage(*command.flyweight, command.x, command.y);
+    }
+}
+
+void TextureStreamer::Update()
+{
+    UploadFinishedLoads();
+
+    for (Entry& entry : entries)
+    {
+        // Decay slowly so that a texture leaving the screen for a few frames keeps its tier.
+        entry.coverage = std::max(entry.frameCoverage, entry.coverage * 7 / 8);
+    }
+
+    AssignTargets();
+    ApplyTargets();
+    UpdateStats();
+
+    for (Entry& entry : entries)
+    {
+        entry.frameCoverage = 0;
+    }
+    SDL_GetRendererOutputSize(renderer, &screenWidth, &screenHeight);
+}
+
+void TextureStreamer::UploadFinishedLoads()
+{
+    for (Entry& entry : entries)
+    {
+        if (!entry.pending.valid() || !IsReady(entry.pending))
+        {
+            continue;
+        }
+
+        SDL_Surface* surface = entry.pending.get();
+        StreamedTexture& texture = *entry.texture;
+        // Only keep the tier if it is still wanted and finer than what is resident.
+        if (surface && entry.targetTier <= entry.pendingTier && entry.pendingTier < texture.GetResidentTier())
+        {
+            if (SDL_Texture* uploaded = SDL_CreateTextureFromSurface(renderer, surface))
+            {
+                if (texture.detail)
+                {
+                    SDL_DestroyTexture(texture.detail);
+                    ++stats.tiersDropped;
+                }
+                texture.detail = uploaded;
+                texture.detailTier = entry.pendingTier;
+                ++stats.loadsCompleted;
+            }
+        }
+        SDL_FreeSurface(surface);
+        entry.pendingTier = -1;
+    }
+}
+
+void TextureStreamer::AssignTargets()
+{
+    std::size_t used = 0;
+    for (Entry& entry : entries)
+    {
+        entry.targetTier = entry.texture->tierCount - 1;
+        used += entry.texture->GetTierBytes(entry.targetTier);
+    }
+
+    struct Upgrade
+    {
+        double priority;
+        std::size_t entry;
+        bool operator<(const Upgrade& other) const { return priority < other.priority; }
+    };
+
+    // Cost of a texture at its target: the coarsest tier plus the detail tier, if any.
+    auto extraBytes = [](const Entry& entry)
+    {
+        const StreamedTexture& texture = *entry.texture;
+        const std::size_t finer = texture.GetTierBytes(entry.targetTier - 1);
+        const bool hasDetail = entry.targetTier < texture.tierCount - 1;
+        return finer - (hasDetail ? texture.GetTierBytes(entry.targetTier) : 0);
+    };
+    auto priority = [&extraBytes](const Entry& entry)
+    {
+        double value = static_cast<double>(entry.coverage) / static_cast<double>(extraBytes(entry));
+        // Keeping a tier that is resident or loading costs no load, so it wins close calls; this
+        // stops textures of similar coverage from trading the same bytes back and forth.
+        const int upgrade = entry.targetTier - 1;
+        if (upgrade >= entry.texture->GetResidentTier() || (entry.pending.valid() && upgrade >= entry.pendingTier))
+        {
+            value *= ResidentBias;
+        }
+        return value;
+    };
+
+    std::priority_queue<Upgrade> upgrades;
+    for (std::size_t i = 0; i < entries.size(); ++i)
+    {
+        if (entries[i].coverage > 0 && entries[i].targetTier > entries[i].texture->neededTier)
+        {
+            upgrades.push(Upgrade{priority(entries[i]), i});
+        }
+    }
+
+    while (!upgrades.empty())
+    {
+        Entry& entry = entries[upgrades.top().entry];
+        upgrades.pop();
+
+        const std::size_t extra = extraBytes(entry);
+        if (used + extra > budgetBytes)
+        {
+            continue;
+        }
+        used += extra;
+        --entry.targetTier;
+        if (entry.targetTier > entry.texture->neededTier)
+        {
+            upgrades.push(Upgrade{priority(entry), static_cast<std::size_t>(&entry - entries.data())});
+        }
+    }
+}
+
+void TextureStreamer::ApplyTargets()
+{
+    // Drop first so that the memory is free before new tiers arrive.
+    for (Entry& entry : entries)
+    {
+        StreamedTexture& texture = *entry.texture;
+        if (texture.detail && texture.detailTier < entry.targetTier)
+        {
+            SDL_DestroyTexture(texture.detail);
+            texture.detail = nullptr;
+            texture.detailTier = -1;
+            ++stats.tiersDropped;
+        }
+    }
+
+    std::size_t inFlight = 0;
+    std::vector<std::size_t> wanted;
+    for (std::size_t i = 0; i < entries.size(); ++i)
+    {
+        const Entry& entry = entries[i];
+        if (entry.pending.valid())
+        {
+            ++inFlight;
+        }
+        else if (entry.targetTier < entry.texture->GetResidentTier())
+        {
+            wanted.push_back(i);
+        }
+    }
+
+    std::sort(wanted.begin(), wanted.end(), [this](std::size_t a, std::size_t b)
+    {
+        return entries[a].coverage > entries[b].coverage;
+    });
+
+    for (std::size_t i : wanted)
+    {
+        if (inFlight >= MaxLoadsInFlight)
+        {
+            break;
+        }
+        Entry& entry = entries[i];
+        entry.pendingTier = entry.targetTier;
+        entry.pending = std::async(std::launch::async, [decode = decode, path = entry.path, format = pixelFormat, tier = entry.targetTier]()
+        {
+            return ReduceToTier(DecodeImage(decode, path, format), tier);
+        });
+        ++inFlight;
+    }
+    stats.loadsInFlight = inFlight;
+}
+
+void TextureStreamer::UpdateStats()
+{
+    stats.textures = entries.size();
+    stats.visibleTextures = 0;
+    stats.residentBytes = 0;
+    stats.fullResolutionBytes = 0;
+    stats.coveredPixels = 0;
+    stats.deficitPixels = 0;
+
+    double weightedDeficit = 0.0;
+    for (const Entry& entry : entries)
+    {
+        const StreamedTexture& texture = *entry.texture;
+        stats.residentBytes += texture.GetTierBytes(texture.tierCount - 1);
+        if (texture.detail)
+        {
+            stats.residentBytes += texture.GetTierBytes(texture.detailTier);
+        }
+        stats.fullResolutionBytes += texture.GetTierBytes(0);
+
+        if (entry.frameCoverage == 0)
+        {
+            continue;
+        }
+        ++stats.visibleTextures;
+        stats.coveredPixels += entry.frameCoverage;
+        const int missingTiers = texture.GetResidentTier() - texture.neededTier;
+        if (missingTiers > 0)
+        {
+            stats.deficitPixels += entry.frameCoverage;
+            weightedDeficit += static_cast<double>(entry.frameCoverage) * missingTiers;
+        }
+    }
+    stats.tierDeficit = stats.coveredPixels > 0 ? weightedDeficit / stats.coveredPixels : 0.0;
+}
+
+void TextureStreamer::PrintReport(std::ostream& out) const
+{
+    const double mebibyte = 1024.0 * 1024.0;
+    out << "Texture streaming: " << stats.residentBytes / mebibyte << " MiB resident of "
+        << stats.fullResolutionBytes / mebibyte << " MiB at full resolution ("
+        << (stats.fullResolutionBytes - stats.residentBytes) / mebibyte << " MiB saved, budget "
+        << budgetBytes / mebibyte << " MiB)" << std::endl;
+    out << "Resolution deficit: " << stats.deficitPixels << " of " << stats.coveredPixels
+        << " covered pixels drawn below the needed tier, " << stats.tierDeficit << " tiers on average; "
+        << stats.visibleTextures << " of " << stats.textures << " textures visible, "
+        << stats.loadsInFlight << " loads in flight" << std::endl;
+}
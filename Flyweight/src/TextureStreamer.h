@@ -0,0 +1,203 @@
+#ifndef TEXTURE_STREAMER_H
+#define TEXTURE_STREAMER_H
+
+#include <SDL2/SDL.h>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Flyweight.h"
+#include "RenderQueue.h"
+
+/**
+ * @brief A texture flyweight whose resolution is chosen by a TextureStreamer.
+ *
+ * The image is available in resolution tiers: tier 0 is the full image and every further tier
+ * halves both dimensions. The coarsest tier is always resident; at most one finer tier is
+ * resident on top of it. Draw uses the finest resident tier, scaled to the same on-screen size
+ * a TextureFlyweight of the image would have, so instances never change size when tiers stream
+ * in or out.
+ */
+class StreamedTexture : public Flyweight
+{
+private:
+    friend class TextureStreamer;
+
+    int width, height;
+    int sourceWidth, sourceHeight;
+
+    /**< Number of tiers; the coarsest is tierCount - 1. */
+    int tierCount;
+
+    /**< Coarsest tier that still has at least one texel per screen pixel. */
+    int neededTier;
+
+    bool opaque = false;
+
+    SDL_Texture* coarsest = nullptr;
+    SDL_Texture* detail = nullptr;
+    int detailTier = -1;
+
+    StreamedTexture() = default;
+
+public:
+    StreamedTexture(const StreamedTexture&) = delete;
+    StreamedTexture& operator=(const StreamedTexture&) = delete;
+    ~StreamedTexture() override;
+
+    void Draw(SDL_Renderer* renderer, int x, int y) const override;
+
+    SDL_Rect GetBounds(int x, int y) const override { return SDL_Rect{x, y, width, height}; }
+
+    bool IsOpaque() const override { return opaque; }
+
+    /**
+     * @brief Returns the finest resident tier.
+     */
+    int GetResidentTier() const { return detail ? detailTier : tierCount - 1; }
+    int GetNeededTier() const { return neededTier; }
+    int GetTierCount() const { return tierCount; }
+
+    /**
+     * @brief Returns the texture memory of a tier.
+     */
+    std::size_t GetTierBytes(int tier) const;
+};
+
+/**
+ * @brief What the streamer kept resident during the last Update, and at what visual cost.
+ */
+struct StreamingStats
+{
+    std::size_t textures = 0;             /**< Streamed textures. */
+    std::size_t visibleTextures = 0;      /**< Textures with on-screen coverage this frame. */
+    std::size_t residentBytes = 0;        /**< Texture memory held by every resident tier. */
+    std::size_t fullResolutionBytes = 0;  /**< Texture memory if every texture were fully resident. */
+    std::uint64_t coveredPixels = 0;      /**< Screen pixels covered by streamed textures. */
+    std::uint64_t deficitPixels = 0;      /**< Covered pixels drawn from a coarser tier than needed. */
+    double tierDeficit = 0.0;             /**< Coverage-weighted mean of missing tiers; 1 is half the resolution. */
+    std::size_t loadsInFlight = 0;        /**< Tier loads running on worker threads. */
+    std::size_t loadsCompleted = 0;       /**< Tiers uploaded since the streamer was created. */
+    std::size_t tiersDropped = 0;         /**< Tiers released since the streamer was created. */
+};
+
+/**
+ * @brief Streams texture resolution tiers by on-screen coverage within a memory budget.
+ *
+ * Each frame the client reports its instances with AddCoverage, and Update then:
+ * 1. uploads the tiers that finished loading in the background;
+ * 2. estimates every texture's coverage (screen pixels its instances cover, smoothed over a few
+ *    frames so textures that briefly leave the screen are not dropped at once);
+ * 3. gives every texture its coarsest tier and spends the rest of the budget on upgrades, one
+ *    tier at a time, in order of coverage per extra byte, never going finer than needed;
+ * 4. drops tiers finer than their target and starts background loads for tiers coarser than it.
+ *
+ * Decoding and downsampling run on worker threads; only texture uploads and releases, which SDL
+ * requires on the render thread, happen in Update. Textures are kept for the lifetime of the
+ * streamer.
+ */
+class TextureStreamer
+{
+public:
+    /**
+     * @brief Decodes the full image of a path. Returns nullptr on failure.
+     *
+     * Runs on worker threads. The returned surface is owned and freed by the streamer.
+     */
+    using Decoder = FlyweightFactory::Decoder;
+
+private:
+    struct Entry
+    {
+        std::shared_ptr<StreamedTexture> texture;
+        std::string path;
+        std::uint64_t frameCoverage = 0;
+        std::uint64_t coverage = 0;
+        int targetTier = 0;
+
+        std::future<SDL_Surface*> pending;
+        int pendingTier = -1;
+    };
+
+    SDL_Renderer* renderer;
+    Decoder decode;
+    Uint32 pixelFormat;
+    std::size_t budgetBytes;
+    int screenWidth = 0;
+    int screenHeight = 0;
+
+    std::vector<Entry> entries;
+    std::unordered_map<std::string, std::size_t> entriesByPath;
+    std::unordered_map<const Flyweight*, std::size_t> entriesByFlyweight;
+
+    StreamingStats stats;
+
+    void UploadFinishedLoads();
+    void AssignTargets();
+    void ApplyTargets();
+    void UpdateStats();
+
+public:
+    /**< Background loads running at once. */
+    static constexpr std::size_t MaxLoadsInFlight = 4;
+
+    /**< Priority multiplier of upgrades to tiers that are already resident or loading. */
+    static constexpr double ResidentBias = 2.0;
+
+    /**< The coarsest tier is the first no larger than this in either dimension. */
+    static constexpr int CoarsestTierSize = 16;
+
+    /**
+     * @brief Constructs a streamer.
+     *
+     * @param renderer The SDL_Renderer the tiers are uploaded to.
+     * @param budgetBytes Texture memory the resident tiers may use. The coarsest tiers are always
+     *                    resident, even if they alone exceed the budget.
+     * @param decode Decodes full images; PNG files go through the built-in decoder and everything
+     *               else through SDL_image if none is given.
+     */
+    TextureStreamer(SDL_Renderer* renderer, std::size_t budgetBytes, Decoder decode = {});
+    ~TextureStreamer();
+
+    TextureStreamer(const TextureStreamer&) = delete;
+    TextureStreamer& operator=(const TextureStreamer&) = delete;
+
+    /**
+     * @brief Returns the streamed texture for a path, loading its coarsest tier on the first request.
+     *
+     * @throws std::runtime_error If the image cannot be decoded.
+     */
+    std::shared_ptr<const StreamedTexture> Get(const std::string& path);
+
+    /**
+     * @brief Reports an instance drawn this frame. Flyweights not created by this streamer are ignored.
+     */
+    void AddCoverage(const Flyweight& flyweight, int x, int y);
+
+    /**
+     * @brief Reports every queued draw of a render queue, before it is flushed.
+     */
+    void AddCoverage(const std::vector<DrawCommand>& commands);
+
+    /**
+     * @brief Applies the coverage reported since the last call; see the class description.
+     */
+    void Update();
+
+    void SetBudget(std::size_t bytes) { budgetBytes = bytes; }
+    std::size_t GetBudget() const { return budgetBytes; }
+
+    const StreamingStats& GetStats() const { return stats; }
+
+    /**
+     * @brief Prints the memory saved against full residency and the resolution deficit it costs.
+     */
+    void PrintReport(std::ostream& out) const;
+};
+
+#endif
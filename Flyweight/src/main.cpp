@@ -24,6 +24,10 @@
  * - **Flyweight Factory**: 
  *   - Implemented by the `FlyweightFactory` class.
  *   - Ensures shared flyweight objects are created only once and reused.
+ * - **Resource Cache**:
+ *   - Implemented by the `ResourceCache<T>` template; textures are one instantiation of it.
+ *   - Adds typed handles, async loading, cross-thread load deduplication and budget-based eviction
+ *     for any shared resource (fonts, sound samples, data blobs).
  * - **Client**:
  *   - The `main` function demonstrates the use of the factory to retrieve shared flyweight objects
  *     and render them efficiently.
@@ -46,135 +50,27 @@
  * ### Example Output:
  * - The program displays multiple crates and metal textures on the screen.
  * - Outputs logs indicating whether a texture was created or reused.
+ * - The rows of crates never move, so they live in a `StaticLayer` rendered once into a target
+ *   texture; pressing M moves one crate and only redraws the affected region.
+ * - Moving sprites go through a `RenderQueue` that radix-sorts them by layer, texture and depth, and
+ *   the demo periodically reports sort time, texture switches per frame and frame time.
+ * - A metal panel in front of them is opaque, so the queue's `OcclusionBuffer` culler skips the
+ *   sprites passing entirely behind it, and the report includes how many were culled per frame.
+ * - Draws health and score readouts with glyphs rasterized once into a shared font atlas.
+ * - Reports how much texture memory content-hash deduplication saved and what hashing cost.
  */
 
 
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_image.h>
 #include <iostream>
-#include <map>
-#include <memory>
 #include <string>
 
-/**
- * @brief Abstract base class representing the Flyweight interface.
- * 
- * Defines the common interface for all flyweight objects. 
- * Flyweights provide shared resources and operations that depend on unique parameters.
- */
-class Flyweight 
-{
-public:
-    /**
-     * @brief Virtual destructor for Flyweight.
-     */
-    virtual void Draw(SDL_Renderer* renderer, int x, int y) const = 0;
-    
-    /**
-     * @brief Renders the flyweight on the screen at the specified position.
-     * 
-     * @param renderer The SDL_Renderer used for rendering.
-     * @param x The x-coordinate for the rendering position.
-     * @param y The y-coordinate for the rendering position.
-     */    
-    virtual ~Flyweight() = default;
-};
-
-/**
- * @brief Concrete implementation of the Flyweight interface for textures.
- * 
- * This class represents a texture that is shared between multiple instances.
- * It handles the loading and rendering of an SDL_Texture.
- */
-class TextureFlyweight : public Flyweight {
-private:
-    /**
-     * 
-     */
-    SDL_Texture* texture;
-
-    int width, height; 
-
-public:
-    /**
-     * @brief Constructs a TextureFlyweight and loads the texture from a file.
-     * 
-     * @param renderer The SDL_Renderer used to create the texture.
-     * @param filePath The file path of the texture to load.
-     * @throws std::runtime_error If the texture cannot be loaded.
-     */
-    TextureFlyweight(SDL_Renderer* renderer, const std::string& filePath) 
-    {
-        SDL_Surface* surface = IMG_Load(filePath.c_str());
-        if (!surface) {
-            throw std::runtime_error("Failed to load image: " + filePath);
-        }
-        texture = SDL_CreateTextureFromSurface(renderer, surface);
-        width = surface->w / 4;
-        height = surface->h / 4;
-        SDL_FreeSurface(surface);
-    }
-
-    /**
-     * @brief Destructor that releases the texture resource.
-     */
-    ~TextureFlyweight() override 
-    {
-        SDL_DestroyTexture(texture);
-    }
-
-    /**
-     * @brief Renders the texture at the specified position.
-     * 
-     * @param renderer The SDL_Renderer used for rendering.
-     * @param x The x-coordinate for the rendering position.
-     * @param y The y-coordinate for the rendering position.
-     */
-    void Draw(SDL_Renderer* renderer, int x, int y) const override 
-    {
-        SDL_Rect dstRect = {x, y, width, height};
-        SDL_RenderCopy(renderer, texture, nullptr, &dstRect);
-    }
-};
-
-/**
- * @brief Factory class for creating and managing Flyweight objects.
- * 
- * This class maintains a cache of flyweight objects to ensure that shared resources are reused
- * and avoids redundant creation of the same flyweights.
- */
-class FlyweightFactory 
-{
-private:
-    /**< Cache of flyweights mapped by file paths. */
-    std::map<std::string, std::shared_ptr<Flyweight>> flyweights;
-
-public:
-    /**
-     * @brief Retrieves a Flyweight object for the given file path.
-     * 
-     * If the flyweight for the file path does not exist, it creates a new one. Otherwise,
-     * it reuses the existing flyweight from the cache.
-     * 
-     * @param renderer The SDL_Renderer used to create new textures if needed.
-     * @param filePath The file path of the texture.
-     * @return A shared pointer to the Flyweight object.
-     */
-    std::shared_ptr<Flyweight> GetFlyweight(SDL_Renderer* renderer, const std::string& filePath) 
-    {
-        if (flyweights.find(filePath) == flyweights.end()) 
-        {
-            std::cout << "Creating new Flyweight for: " << filePath << std::endl;
-            flyweights[filePath] = std::make_shared<TextureFlyweight>(renderer, filePath);
-        } 
-        else 
-        {
-            std::cout << "Reusing existing Flyweight for: " << filePath << std::endl;
-        }
-
-        return flyweights[filePath];
-    }
-};
+#include "Flyweight.h"
+#include "GlyphCache.h"
+#include "OcclusionBuffer.h"
+#include "RenderQueue.h"
+#include "StaticLayer.h"
 
 
 int main(int argc, char* argv[]) 
@@ -214,34 +110,109 @@ int main(int argc, char* argv[])
         return 1;
     }
 
-    FlyweightFactory factory;
-    auto crateTexture = factory.GetFlyweight(renderer, "assets/crate.png");
-    auto metalTexture = factory.GetFlyweight(renderer, "assets/metal.png");
-
-    bool running = true;
-    SDL_Event event;
-
-    while (running) 
+    // Everything holding textures is destroyed before the renderer that owns them.
     {
-        while (SDL_PollEvent(&event)) 
+        FlyweightFactory factory;
+        auto crateTexture = factory.GetFlyweight(renderer, "assets/crate.png");
+        auto metalTexture = factory.GetFlyweight(renderer, "assets/metal.png");
+        // A mod shipping the same crate under a different name shares the already loaded texture.
+        auto moddedCrateTexture = factory.GetFlyweight(renderer, "assets/mods/crate_hd.png");
+        factory.PrintDedupReport(std::cout);
+
+        GlyphCache glyphs(factory, renderer, "assets/font5x7.txt", 3);
+        TextLabel healthLabel;
+        TextLabel scoreLabel;
+        int frame = 0;
+
+        // Nothing in these rows moves, so they are drawn once into a cached layer.
+        StaticLayer staticLayer;
+        for (int i = 0; i < 6; ++i) 
+        {
+            staticLayer.Add(crateTexture, 5 + i * 150, 10 + i);
+            staticLayer.Add(metalTexture, 5 + i * 150, 200 + i);
+            staticLayer.Add(moddedCrateTexture, 5 + i * 150, 400 + i);
+        }
+        int nudge = 0;
+
+        // Drawn back to front, so sprites hidden behind nearer opaque ones can be culled.
+        RenderQueue queue;
+        OcclusionBuffer occlusion;
+        queue.SetSortOrder(SortOrder::ByDepth);
+        queue.SetCuller([&occlusion](SDL_Renderer* target, std::vector<DrawCommand>& commands)
         {
-            if (event.type == SDL_QUIT) 
+            occlusion.Cull(target, commands);
+        });
+        const int reportInterval = 300;
+        double frameSeconds = 0.0;
+        double sortSeconds = 0.0;
+        std::size_t textureSwitches = 0;
+        std::size_t culled = 0;
+
+        bool running = true;
+        SDL_Event event;
+
+        while (running) 
+        {
+            Uint64 frameStart = SDL_GetPerformanceCounter();
+
+            while (SDL_PollEvent(&event)) 
             {
-                running = false;
+                if (event.type == SDL_QUIT) 
+                {
+                    running = false;
+                }
+                else if (event.type == SDL_RENDER_TARGETS_RESET || event.type == SDL_RENDER_DEVICE_RESET)
+                {
+                    staticLayer.Invalidate();
+                }
+                else if (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_m)
+                {
+                    // Moving one static crate only redraws the region it left and the one it entered.
+                    nudge = (nudge + 20) % 100;
+                    staticLayer.Move(0, 5 + nudge, 10);
+                }
             }
-        }
 
-        SDL_SetRenderDrawColor(renderer, 135, 206, 250, 255); 
-        SDL_RenderClear(renderer);
+            SDL_SetRenderDrawColor(renderer, 135, 206, 250, 255); 
+            SDL_RenderClear(renderer);
 
-        
-        for (int i = 0; i < 6; ++i) 
-        {
-            crateTexture->Draw(renderer, 5 + i * 150, 10 + i);  
-            metalTexture->Draw(renderer, 5 + i * 150, 200 + i);  
-        }
+            staticLayer.Composite(renderer);
 
-        SDL_RenderPresent(renderer);
+            // Moving sprites are submitted interleaved on purpose; the queue sorts them by texture.
+            for (int i = 0; i < 3; ++i) 
+            {
+                int x = (frame * 3 + i * 300) % 900;
+                queue.Submit(*crateTexture, x, 590);
+                queue.Submit(*metalTexture, x + 130, 590);
+            }
+            queue.Submit(*metalTexture, 600, 570, 1);
+            queue.Flush(renderer);
+
+            // Labels only lay out again when their text actually changes.
+            ++frame;
+            healthLabel.SetText(glyphs, "HEALTH: " + std::to_string(100 - (frame / 60) % 100));
+            scoreLabel.SetText(glyphs, "SCORE: " + std::to_string((frame / 30) * 10));
+            healthLabel.Draw(renderer, glyphs, 10, 740);
+            scoreLabel.Draw(renderer, glyphs, 500, 740);
+
+            SDL_RenderPresent(renderer);
+
+            frameSeconds += static_cast<double>(SDL_GetPerformanceCounter() - frameStart) / SDL_GetPerformanceFrequency();
+            sortSeconds += queue.GetStats().sortSeconds;
+            textureSwitches += queue.GetStats().textureSwitches;
+            culled += queue.GetStats().culled;
+            if (frame % reportInterval == 0)
+            {
+                std::cout << "Sort: " << sortSeconds * 1e6 / reportInterval << " us, texture switches: "
+                          << static_cast<double>(textureSwitches) / reportInterval << " per frame, culled: "
+                          << static_cast<double>(culled) / reportInterval << " per frame, frame time: "
+                          << frameSeconds * 1000.0 / reportInterval << " ms" << std::endl;
+                frameSeconds = 0.0;
+                sortSeconds = 0.0;
+                textureSwitches = 0;
+                culled = 0;
+            }
+        }
     }
 
     SDL_DestroyRenderer(renderer);
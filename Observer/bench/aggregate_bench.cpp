@@ -0,0 +1,205 @@
+/**
+ * @file aggregate_bench.cpp
+ * @brief Cost and accuracy of AggregateObserver, fed by several publishing threads while snapshots are taken.
+ *
+ * Each publisher thread notifies its own AggregateObserver of a skewed stream of values, where a
+ * few values are very frequent, through its own Subject. Meanwhile an exporter thread keeps
+ * requesting, taking and merging snapshots. The cost per event is compared with an observer
+ * that only sums. At the end the merged aggregates are checked against exact ones computed from
+ * every value: count, sum, min and max must match, quantiles must be within the sketch's rank
+ * error, and the most frequent values must be found.
+ *
+ * Build and run from the Observer directory:
+ * @code
+ * make bench && ./bench/aggregate_bench
+ * @endcode
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "Aggregates.h"
+
+namespace
+{
+    constexpr int PublisherCount = 4;
+    constexpr int ValuesPerPublisher = 1000000;
+    constexpr int HotValues = 8;
+
+    class SumObserver : public Observer
+    {
+    public:
+        std::int64_t sum = 0;
+
+        void onNotify(int value) override
+        {
+            sum += value;
+        }
+    };
+
+    double millisecondsSince(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    /**
+     * @brief Values for one publisher: one in four is one of a few hot values, the rest spread widely.
+     */
+    std::vector<int> makeStream(unsigned seed)
+    {
+        std::mt19937 random(seed);
+        std::uniform_int_distribution<int> spread(0, 1000000);
+        std::geometric_distribution<int> hot(0.3);
+        std::vector<int> values(ValuesPerPublisher);
+        for (int& value : values)
+        {
+            value = random() % 4 == 0 ? 1000 * std::min(hot(random), HotValues - 1) : spread(random);
+        }
+        return values;
+    }
+
+    /**
+     * @brief Milliseconds for every publisher thread to notify its observer of its whole stream.
+     */
+    double publishAll(const std::vector<std::vector<int>>& streams, const std::vector<std::shared_ptr<Observer>>& observers)
+    {
+        std::vector<std::thread> publishers;
+        auto start = std::chrono::steady_clock::now();
+        for (int p = 0; p < PublisherCount; ++p)
+        {
+            publishers.emplace_back([&streams, &observers, p]()
+            {
+                std::cout.setstate(std::ios::failbit);
+                Subject subject;
+                subject.addObserver(observers[p]);
+                for (int value : streams[p])
+                {
+                    subject.setState(value);
+                }
+            });
+        }
+        for (std::thread& publisher : publishers)
+        {
+            publisher.join();
+        }
+        std::cout.clear();
+        return millisecondsSince(start);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    (void)argc;
+    (void)argv;
+
+    std::vector<std::vector<int>> streams;
+    for (int p = 0; p < PublisherCount; ++p)
+    {
+        streams.push_back(makeStream(1234u + p));
+    }
+    const double events = static_cast<double>(PublisherCount) * ValuesPerPublisher;
+
+    std::vector<std::shared_ptr<Observer>> sums;
+    for (int p = 0; p < PublisherCount; ++p)
+    {
+        sums.push_back(std::make_shared<SumObserver>());
+    }
+    const double sumTime = publishAll(streams, sums);
+
+    std::vector<std::shared_ptr<AggregateObserver>> aggregators;
+    std::vector<std::shared_ptr<Observer>> observers;
+    for (int p = 0; p < PublisherCount; ++p)
+    {
+        aggregators.push_back(std::make_shared<AggregateObserver>());
+        observers.push_back(aggregators.back());
+    }
+
+    // Snapshots are taken and merged all along, as an exporter would.
+    std::atomic<bool> publishing{true};
+    int snapshots = 0;
+    std::thread exporter([&]()
+    {
+        while (publishing.load())
+        {
+            Aggregates merged;
+            for (const auto& aggregator : aggregators)
+            {
+                aggregator->requestSnapshot();
+                merged.merge(aggregator->snapshot());
+            }
+            ++snapshots;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    });
+    const double aggregateTime = publishAll(streams, observers);
+    publishing.store(false);
+    exporter.join();
+
+    std::cout << "publishers: " << PublisherCount << ", values: " << static_cast<long long>(events) << std::endl;
+    std::cout << "sum observer:       " << sumTime * 1e6 / events << " ns per event" << std::endl;
+    std::cout << "aggregate observer: " << aggregateTime * 1e6 / events << " ns per event, " << snapshots
+              << " merged snapshots taken meanwhile" << std::endl;
+
+    // The publishers are done, so this thread may flush their observers.
+    Aggregates merged;
+    for (const auto& aggregator : aggregators)
+    {
+        aggregator->flush();
+        merged.merge(aggregator->snapshot());
+    }
+
+    std::vector<int> all;
+    std::unordered_map<int, std::uint64_t> frequencies;
+    for (const auto& stream : streams)
+    {
+        all.insert(all.end(), stream.begin(), stream.end());
+    }
+    for (int value : all)
+    {
+        ++frequencies[value];
+    }
+    std::sort(all.begin(), all.end());
+
+    std::int64_t sum = 0;
+    for (int value : all)
+    {
+        sum += value;
+    }
+    bool correct = merged.stats.count == all.size() && merged.stats.sum == sum && merged.stats.min == all.front()
+                   && merged.stats.max == all.back();
+
+    // The rank error of a quantile: how far q * count lies outside the ranks of the value returned.
+    double worstRankError = 0.0;
+    for (double q : {0.01, 0.1, 0.25, 0.5, 0.75, 0.9, 0.99})
+    {
+        const int value = merged.quantiles.quantile(q);
+        const double low = std::lower_bound(all.begin(), all.end(), value) - all.begin();
+        const double high = std::upper_bound(all.begin(), all.end(), value) - all.begin();
+        const double rank = q * all.size();
+        const double error = rank < low ? low - rank : (rank > high ? rank - high : 0.0);
+        worstRankError = std::max(worstRankError, error / all.size());
+    }
+    correct = correct && worstRankError < 0.02;
+
+    std::cout << "quantiles: worst rank error " << worstRankError * 100 << "% with " << merged.quantiles.retained()
+              << " values kept" << std::endl;
+    for (const auto& [value, count] : merged.heavyHitters.top(HotValues / 2))
+    {
+        const std::uint64_t exact = frequencies[value];
+        const bool hot = value % 1000 == 0;
+        correct = correct && hot && count <= exact && exact - count <= merged.heavyHitters.getMaxError();
+        std::cout << "heavy hitter " << value << ": " << count << " counted, " << exact << " exact" << std::endl;
+    }
+    std::cout << "heavy hitters: counts at most " << merged.heavyHitters.getMaxError() << " short" << std::endl;
+
+    std::cout << "aggregates " << (correct ? "correct" : "WRONG") << std::endl;
+    return correct ? 0 : 1;
+}
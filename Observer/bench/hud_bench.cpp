@@ -0,0 +1,147 @@
+/**
+ * @file hud_bench.cpp
+ * @brief Benchmark of the retained-mode Hud against repainting and presenting every frame.
+ *
+ * Eight counter widgets on an off-screen software renderer go through 600 frames in which one
+ * of them changes every 30 frames. In immediate mode every widget is repainted and the frame
+ * presented every time; in retained mode only the changed widget is repainted, and only frames
+ * with a change are presented. Then each mode idles for a second: immediate mode keeps drawing at
+ * 60 frames per second, retained mode sleeps in SDL_WaitEventTimeout. The CPU time of the process
+ * is reported for both.
+ *
+ * Build and run from the Observer directory:
+ * @code
+ * make bench && ./bench/hud_bench
+ * @endcode
+ */
+
+#include <SDL2/SDL.h>
+#include <ctime>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include "Hud.h"
+
+namespace
+{
+    constexpr int FrameCount = 600;
+    constexpr int ChangeInterval = 30;
+    constexpr int WidgetCount = 8;
+    constexpr Uint32 FrameMs = 16;
+
+    class CounterWidget : public HudWidget
+    {
+    private:
+        int value_ = 0;
+
+    protected:
+        void paint(SDL_Renderer* renderer) override
+        {
+            SDL_Rect bar = {0, 8, value_ % 200, 24};
+            SDL_SetRenderDrawColor(renderer, 200, 40, 40, 255);
+            SDL_RenderFillRect(renderer, &bar);
+            SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+            drawNumber(renderer, value_, getWidth(), 4, 32);
+        }
+
+    public:
+        CounterWidget() : HudWidget(320, 40) {}
+
+        void onNotify(int value) override
+        {
+            value_ = value;
+            markDirty();
+        }
+    };
+
+    double cpuSecondsSince(std::clock_t start)
+    {
+        return static_cast<double>(std::clock() - start) / CLOCKS_PER_SEC;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    (void)argc;
+    (void)argv;
+
+    if (SDL_Init(SDL_INIT_EVENTS) != 0)
+    {
+        std::cerr << "SDL_Init Error: " << SDL_GetError() << std::endl;
+        return 1;
+    }
+
+    SDL_Surface* screen = SDL_CreateRGBSurfaceWithFormat(0, 640, 480, 32, SDL_PIXELFORMAT_ARGB8888);
+    SDL_Renderer* renderer = screen ? SDL_CreateSoftwareRenderer(screen) : nullptr;
+    if (!renderer)
+    {
+        std::cerr << "SDL_CreateSoftwareRenderer Error: " << SDL_GetError() << std::endl;
+        SDL_Quit();
+        return 1;
+    }
+
+    std::cout << "mode  presents  repaints  cpu per frame(ms)  cpu per update frame(ms)  idle cpu(%)" << std::endl;
+    for (int retained = 0; retained < 2; ++retained)
+    {
+        Hud hud;
+        std::vector<std::shared_ptr<CounterWidget>> widgets;
+        for (int i = 0; i < WidgetCount; ++i)
+        {
+            widgets.push_back(std::make_shared<CounterWidget>());
+            hud.add(widgets.back(), 10, 10 + i * 56);
+        }
+        hud.render(renderer);
+
+        int updates = 0;
+        std::clock_t start = std::clock();
+        for (int frame = 1; frame <= FrameCount; ++frame)
+        {
+            if (frame % ChangeInterval == 0)
+            {
+                widgets[(frame / ChangeInterval) % WidgetCount]->onNotify(frame);
+                ++updates;
+            }
+            if (!retained)
+            {
+                hud.invalidate(true);
+            }
+            if (hud.needsPresent())
+            {
+                hud.render(renderer);
+            }
+        }
+        const double busy = cpuSecondsSince(start);
+
+        // A second without changes, at 60 frames per second.
+        start = std::clock();
+        const Uint32 idleStart = SDL_GetTicks();
+        while (SDL_GetTicks() - idleStart < 1000)
+        {
+            if (!retained)
+            {
+                hud.invalidate(true);
+            }
+            if (hud.needsPresent())
+            {
+                hud.render(renderer);
+                SDL_Delay(FrameMs);
+            }
+            else
+            {
+                SDL_Event event;
+                SDL_WaitEventTimeout(&event, 50);
+            }
+        }
+        const double idle = cpuSecondsSince(start) / ((SDL_GetTicks() - idleStart) / 1000.0);
+
+        const HudStats& stats = hud.getStats();
+        std::cout << (retained ? "retained" : "immediate") << "  " << stats.framesPresented << "  " << stats.widgetsRasterized << "  "
+                  << busy * 1000.0 / FrameCount << "  " << busy * 1000.0 / updates << "  " << idle * 100.0 << std::endl;
+    }
+
+    SDL_DestroyRenderer(renderer);
+    SDL_FreeSurface(screen);
+    SDL_Quit();
+    return 0;
+}
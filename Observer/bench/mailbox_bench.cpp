@@ -0,0 +1,114 @@
+/**
+ * @file mailbox_bench.cpp
+ * @brief Benchmark of Mailbox delivery policies for a fast publisher and a slow observer.
+ *
+ * A subject publishes in bursts of 500 values per frame (a third of the frames) to an observer
+ * whose handler takes a few microseconds, like re-rasterizing HUD text. Ten simulated seconds at
+ * 60 frames per second are run with the observer subscribed directly and behind a mailbox with
+ * each policy, reporting the handler calls made and avoided and the time spent publishing and
+ * delivering. Every policy except debounce must leave the observer with the last value.
+ *
+ * Build and run from the Observer directory:
+ * @code
+ * make bench && ./bench/mailbox_bench
+ * @endcode
+ */
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "Mailbox.h"
+
+namespace
+{
+    constexpr int FrameCount = 600;
+    constexpr std::uint64_t FrameMs = 16;
+    constexpr int ValuesPerBurst = 500;
+
+    class SlowObserver : public Observer
+    {
+    public:
+        int last = -1;
+        std::uint64_t calls = 0;
+        double work = 0.0;
+
+        void onNotify(int value) override
+        {
+            last = value;
+            ++calls;
+            for (int i = 0; i < 2000; ++i)
+            {
+                work += std::sqrt(static_cast<double>(value + i));
+            }
+        }
+    };
+
+    double millisecondsSince(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    (void)argc;
+    (void)argv;
+
+    struct Case
+    {
+        std::string name;
+        bool direct;
+        DeliveryPolicy policy;
+    };
+    const Case cases[] = {
+        {"direct", true, DeliveryPolicy::everyEvent()},
+        {"every event", false, DeliveryPolicy::everyEvent()},
+        {"latest per frame", false, DeliveryPolicy::latestPerFrame()},
+        {"max 10/s", false, DeliveryPolicy::maxRate(10.0)},
+        {"debounce 100ms", false, DeliveryPolicy::debounce(100)},
+    };
+
+    Subject subject;
+    bool correct = true;
+    std::cout << "policy  handler calls  avoided  publish(ms)  deliver(ms)  last value" << std::endl;
+    for (const Case& test : cases)
+    {
+        auto observer = std::make_shared<SlowObserver>();
+        MailboxSet mailboxes;
+        std::shared_ptr<Observer> subscribed = test.direct ? std::shared_ptr<Observer>(observer) : mailboxes.add(observer, test.policy);
+        subject.addObserver(subscribed);
+
+        int value = 0;
+        double publishTime = 0.0;
+        double deliverTime = 0.0;
+        for (int frame = 0; frame < FrameCount; ++frame)
+        {
+            auto start = std::chrono::steady_clock::now();
+            if (frame % 60 < 20)
+            {
+                for (int i = 0; i < ValuesPerBurst; ++i)
+                {
+                    subject.setState(++value);
+                }
+            }
+            publishTime += millisecondsSince(start);
+
+            start = std::chrono::steady_clock::now();
+            mailboxes.deliver(frame * FrameMs);
+            deliverTime += millisecondsSince(start);
+        }
+
+        subject.removeObserver(subscribed);
+
+        const DeliveryStats stats = mailboxes.getStats();
+        const bool lastSeen = observer->last == value;
+        correct = correct && (lastSeen || test.policy.mode == DeliveryPolicy::Debounce);
+        std::cout << test.name << "  " << observer->calls << "  " << (test.direct ? 0 : stats.replaced) << "  "
+                  << publishTime << "  " << deliverTime << "  " << (lastSeen ? "latest" : "stale") << std::endl;
+    }
+
+    return correct ? 0 : 1;
+}
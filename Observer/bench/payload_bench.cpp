@@ -0,0 +1,258 @@
+/**
+ * @file payload_bench.cpp
+ * @brief Benchmark of arena-backed event payloads against copying them and against shared_ptr.
+ *
+ * Every frame, 2000 collision events with a 400-byte manifold are published to 8 observers, which
+ * queue them and handle them at the end of the frame. The payload travels three ways: by value, so
+ * each observer keeps its own copy; allocated with make_shared and passed as shared_ptr; and
+ * allocated in a FrameArena and passed as ArenaRef, the arena being reset after the frame. All
+ * must produce the same checksum. Finally a payload kept past its frame is used, which debug
+ * builds must catch.
+ *
+ * Build and run from the Observer directory (add -DNDEBUG to time without generation checks):
+ * @code
+ * make bench && ./bench/payload_bench
+ * @endcode
+ */
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include "FrameArena.h"
+#include "PayloadSubject.h"
+
+namespace
+{
+    constexpr int FrameCount = 200;
+    constexpr int EventsPerFrame = 2000;
+    constexpr int ObserverCount = 8;
+
+    struct Contact
+    {
+        float position[3];
+        float normal[3];
+        float depth;
+    };
+
+    struct Manifold
+    {
+        std::uint32_t first;
+        std::uint32_t second;
+        std::uint32_t contactCount;
+        Contact contacts[14];
+    };
+
+    Manifold makeManifold(int event)
+    {
+        Manifold manifold = {};
+        manifold.first = static_cast<std::uint32_t>(event);
+        manifold.second = static_cast<std::uint32_t>(event * 7);
+        manifold.contactCount = static_cast<std::uint32_t>(event % 14 + 1);
+        for (std::uint32_t i = 0; i < manifold.contactCount; ++i)
+        {
+            manifold.contacts[i].depth = static_cast<float>(i + event % 5);
+        }
+        return manifold;
+    }
+
+    double read(const Manifold& manifold)
+    {
+        return manifold.first + manifold.contacts[manifold.contactCount - 1].depth;
+    }
+
+    // Observers keep what they receive until the end of the frame, when they process it, like
+    // systems that queue events during the update and handle them afterwards.
+    class CopyObserver
+    {
+    public:
+        std::vector<Manifold> queue;
+        double total = 0.0;
+        virtual ~CopyObserver() = default;
+        virtual void onEvent(Manifold payload) { queue.push_back(payload); }
+        void endFrame()
+        {
+            for (const Manifold& payload : queue)
+            {
+                total += read(payload);
+            }
+            queue.clear();
+        }
+    };
+
+    class SharedObserver
+    {
+    public:
+        std::vector<std::shared_ptr<const Manifold>> queue;
+        double total = 0.0;
+        virtual ~SharedObserver() = default;
+        virtual void onEvent(std::shared_ptr<const Manifold> payload) { queue.push_back(std::move(payload)); }
+        void endFrame()
+        {
+            for (const auto& payload : queue)
+            {
+                total += read(*payload);
+            }
+            queue.clear();
+        }
+    };
+
+    class ArenaObserver : public PayloadObserver<Manifold>
+    {
+    public:
+        std::vector<ArenaRef<Manifold>> queue;
+        double total = 0.0;
+        void onEvent(ArenaRef<Manifold> payload) override { queue.push_back(payload); }
+        void endFrame()
+        {
+            for (const auto& payload : queue)
+            {
+                total += read(*payload);
+            }
+            queue.clear();
+        }
+    };
+
+    /**
+     * @brief Same dispatch as PayloadSubject: observers held weakly, locked for each event.
+     */
+    template <typename ObserverType, typename Payload>
+    void publish(const std::vector<std::weak_ptr<ObserverType>>& observers, const Payload& payload)
+    {
+        for (const auto& entry : observers)
+        {
+            if (auto observer = entry.lock())
+            {
+                observer->onEvent(payload);
+            }
+        }
+    }
+
+    double millisecondsSince(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    (void)argc;
+    (void)argv;
+
+    constexpr double Events = static_cast<double>(FrameCount) * EventsPerFrame;
+    double checksums[3] = {0.0, 0.0, 0.0};
+    double times[3] = {0.0, 0.0, 0.0};
+
+    {
+        std::vector<std::shared_ptr<CopyObserver>> observers;
+        std::vector<std::weak_ptr<CopyObserver>> subject;
+        for (int i = 0; i < ObserverCount; ++i)
+        {
+            observers.push_back(std::make_shared<CopyObserver>());
+            subject.push_back(observers.back());
+        }
+        auto start = std::chrono::steady_clock::now();
+        for (int frame = 0; frame < FrameCount; ++frame)
+        {
+            for (int event = 0; event < EventsPerFrame; ++event)
+            {
+                publish(subject, makeManifold(event));
+            }
+            for (const auto& observer : observers)
+            {
+                observer->endFrame();
+            }
+        }
+        times[0] = millisecondsSince(start);
+        for (const auto& observer : observers)
+        {
+            checksums[0] += observer->total;
+        }
+    }
+
+    {
+        std::vector<std::shared_ptr<SharedObserver>> observers;
+        std::vector<std::weak_ptr<SharedObserver>> subject;
+        for (int i = 0; i < ObserverCount; ++i)
+        {
+            observers.push_back(std::make_shared<SharedObserver>());
+            subject.push_back(observers.back());
+        }
+        auto start = std::chrono::steady_clock::now();
+        for (int frame = 0; frame < FrameCount; ++frame)
+        {
+            for (int event = 0; event < EventsPerFrame; ++event)
+            {
+                publish(subject, std::make_shared<const Manifold>(makeManifold(event)));
+            }
+            for (const auto& observer : observers)
+            {
+                observer->endFrame();
+            }
+        }
+        times[1] = millisecondsSince(start);
+        for (const auto& observer : observers)
+        {
+            checksums[1] += observer->total;
+        }
+    }
+
+    FrameArena arena;
+    {
+        PayloadSubject<Manifold> subject;
+        std::vector<std::shared_ptr<ArenaObserver>> observers;
+        for (int i = 0; i < ObserverCount; ++i)
+        {
+            observers.push_back(std::make_shared<ArenaObserver>());
+            subject.addObserver(observers.back());
+        }
+        auto start = std::chrono::steady_clock::now();
+        for (int frame = 0; frame < FrameCount; ++frame)
+        {
+            for (int event = 0; event < EventsPerFrame; ++event)
+            {
+                subject.publish(arena.make<Manifold>(makeManifold(event)));
+            }
+            for (const auto& observer : observers)
+            {
+                observer->endFrame();
+            }
+            arena.reset();
+        }
+        times[2] = millisecondsSince(start);
+        for (const auto& observer : observers)
+        {
+            checksums[2] += observer->total;
+        }
+    }
+
+    std::cout << "payload: " << sizeof(Manifold) << " bytes, events: " << Events << ", observers: " << ObserverCount << std::endl;
+    std::cout << "copy per observer: " << times[0] * 1e6 / Events << " ns per event" << std::endl;
+    std::cout << "shared_ptr:        " << times[1] * 1e6 / Events << " ns per event" << std::endl;
+    std::cout << "frame arena:       " << times[2] * 1e6 / Events << " ns per event, "
+              << arena.capacity() / 1024 << " KiB of blocks reused every frame" << std::endl;
+
+    const bool match = checksums[0] == checksums[1] && checksums[1] == checksums[2];
+    std::cout << "results " << (match ? "match" : "DIFFER") << std::endl;
+
+    ArenaRef<Manifold> kept = arena.make<Manifold>(makeManifold(1));
+    arena.reset();
+    bool caught = false;
+    (void)caught;
+    try
+    {
+        (void)kept->first;
+    }
+    catch (const std::logic_error&)
+    {
+        caught = true;
+    }
+#ifndef NDEBUG
+    std::cout << "use after reset: " << (caught ? "caught" : "NOT CAUGHT") << std::endl;
+    return match && caught ? 0 : 1;
+#else
+    std::cout << "use after reset: not checked (NDEBUG)" << std::endl;
+    return match ? 0 : 1;
+#endif
+}
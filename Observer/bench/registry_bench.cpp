@@ -0,0 +1,177 @@
+/**
+ * @file registry_bench.cpp
+ * @brief Benchmark of resolving an event type to its subscribers: EventBus ids against type_index maps.
+ *
+ * 32 event types with one observer each are published in turn, through an EventBus indexing its
+ * subscriber lists by compile-time id and through the same lists kept in an unordered_map keyed
+ * by std::type_index. The lookup alone is timed too, by resolving each type's list and reading
+ * its size. Both ways must make the same calls.
+ *
+ * Build and run from the Observer directory:
+ * @code
+ * make bench && ./bench/registry_bench
+ * @endcode
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <typeindex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "EventRegistry.h"
+
+namespace
+{
+    constexpr int Rounds = 200000;
+    constexpr std::size_t TypeCount = 32;
+
+    template <std::size_t I>
+    struct BenchEvent
+    {
+        int value;
+    };
+
+    template <std::size_t... I>
+    EventList<BenchEvent<I>...> makeList(std::index_sequence<I...>);
+
+    using BenchEvents = decltype(makeList(std::make_index_sequence<TypeCount>()));
+    static_assert(BenchEvents::size == TypeCount, "every bench event type must be registered");
+    static_assert(BenchEvents::idOf<BenchEvent<0>>() == 0 && BenchEvents::idOf<BenchEvent<TypeCount - 1>>() == TypeCount - 1,
+                  "ids must be dense");
+
+    std::uint64_t total = 0;
+
+    template <std::size_t I>
+    class BenchObserver : public EventObserver<BenchEvent<I>>
+    {
+    public:
+        void onEvent(const BenchEvent<I>& event) override
+        {
+            total += static_cast<std::uint64_t>(event.value) + I;
+        }
+    };
+
+    /**
+     * @brief The usual run-time alternative: subscriber lists in a map keyed by type_index.
+     */
+    class TypeIndexBus
+    {
+    private:
+        std::unordered_map<std::type_index, std::vector<std::weak_ptr<void>>> observers_;
+
+    public:
+        template <typename E>
+        void addObserver(const std::shared_ptr<EventObserver<E>>& observer)
+        {
+            observers_[std::type_index(typeid(E))].push_back(observer);
+        }
+
+        template <typename E>
+        void publish(const E& event)
+        {
+            auto found = observers_.find(std::type_index(typeid(E)));
+            if (found == observers_.end()) return;
+            for (std::size_t i = 0; i < found->second.size(); ++i)
+            {
+                if (auto observer = found->second[i].lock())
+                {
+                    static_cast<EventObserver<E>*>(observer.get())->onEvent(event);
+                }
+            }
+        }
+
+        template <typename E>
+        std::size_t size() const
+        {
+            auto found = observers_.find(std::type_index(typeid(E)));
+            return found == observers_.end() ? 0 : found->second.size();
+        }
+    };
+
+    double millisecondsSince(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    template <typename Bus, std::size_t... I>
+    void subscribeAll(Bus& bus, std::vector<std::shared_ptr<void>>& keep, std::index_sequence<I...>)
+    {
+        (..., [&]()
+        {
+            auto observer = std::make_shared<BenchObserver<I>>();
+            bus.template addObserver<BenchEvent<I>>(observer);
+            keep.push_back(observer);
+        }());
+    }
+
+    template <typename Bus, std::size_t... I>
+    void publishAll(Bus& bus, int value, std::index_sequence<I...>)
+    {
+        (..., bus.publish(BenchEvent<I>{value}));
+    }
+
+    template <typename Bus, std::size_t... I>
+    std::size_t lookupAll(const Bus& bus, std::index_sequence<I...>)
+    {
+        return (std::size_t{0} + ... + bus.template size<BenchEvent<I>>());
+    }
+
+    /**
+     * @brief Milliseconds to run every round of publishing or looking up all types through bus.
+     */
+    template <typename Bus>
+    double timeRounds(Bus& bus, bool lookupOnly)
+    {
+        volatile std::size_t sink = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int round = 0; round < Rounds; ++round)
+        {
+            if (lookupOnly)
+            {
+                sink = sink + lookupAll(bus, std::make_index_sequence<TypeCount>());
+            }
+            else
+            {
+                publishAll(bus, round, std::make_index_sequence<TypeCount>());
+            }
+        }
+        return millisecondsSince(start);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    (void)argc;
+    (void)argv;
+
+    std::vector<std::shared_ptr<void>> keep;
+    EventBus<BenchEvents> bus;
+    TypeIndexBus mapBus;
+    subscribeAll(bus, keep, std::make_index_sequence<TypeCount>());
+    subscribeAll(mapBus, keep, std::make_index_sequence<TypeCount>());
+
+    const double lookups = static_cast<double>(Rounds) * TypeCount;
+    std::cout << "event types: " << TypeCount << ", rounds: " << Rounds << std::endl;
+
+    const double busLookup = timeRounds(bus, true);
+    const double mapLookup = timeRounds(mapBus, true);
+    std::cout << "lookup:  event ids " << busLookup * 1e6 / lookups << " ns, type_index map " << mapLookup * 1e6 / lookups
+              << " ns" << std::endl;
+
+    total = 0;
+    const double busPublish = timeRounds(bus, false);
+    const std::uint64_t busTotal = total;
+    total = 0;
+    const double mapPublish = timeRounds(mapBus, false);
+    const std::uint64_t mapTotal = total;
+    std::cout << "publish: event ids " << busPublish * 1e6 / lookups << " ns, type_index map " << mapPublish * 1e6 / lookups
+              << " ns, " << mapPublish / busPublish << "x" << std::endl;
+
+    const bool consistent = busTotal == mapTotal && busTotal > 0;
+    std::cout << "results " << (consistent ? "match" : "DIFFER") << std::endl;
+    return consistent ? 0 : 1;
+}
@@ -0,0 +1,125 @@
+/**
+ * @file shard_bench.cpp
+ * @brief Scaling benchmark of ShardedSubject by thread count, against Subject.
+ *
+ * 50k observers, each doing a little work per event like a component reacting to "tick", are
+ * notified 200 times through Subject and through ShardedSubject with 1, 2, 4 and 8 threads (the
+ * caller plus workers). Every run must deliver every event to every observer once. Speedups
+ * above the number of hardware threads reported at the top are not expected.
+ *
+ * Build and run from the Observer directory:
+ * @code
+ * make bench && ./bench/shard_bench
+ * @endcode
+ */
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "ShardedSubject.h"
+
+namespace
+{
+    constexpr int ObserverCount = 50000;
+    constexpr int EventCount = 200;
+
+    class TickObserver : public Observer
+    {
+    public:
+        std::uint64_t ticks = 0;
+        double phase = 0.0;
+
+        void onNotify(int value) override
+        {
+            ++ticks;
+            for (int i = 0; i < 4; ++i)
+            {
+                phase = std::sin(phase + value * 0.001 + i);
+            }
+        }
+    };
+
+    double millisecondsSince(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    (void)argc;
+    (void)argv;
+
+    std::vector<std::shared_ptr<TickObserver>> observers;
+    for (int i = 0; i < ObserverCount; ++i)
+    {
+        observers.push_back(std::make_shared<TickObserver>());
+    }
+    auto delivered = [&observers]()
+    {
+        std::uint64_t total = 0;
+        for (const auto& observer : observers)
+        {
+            total += observer->ticks;
+            observer->ticks = 0;
+        }
+        return total;
+    };
+    const std::uint64_t expected = static_cast<std::uint64_t>(ObserverCount) * EventCount;
+
+    std::cout << "hardware threads: " << std::thread::hardware_concurrency() << ", observers: " << ObserverCount
+              << ", events: " << EventCount << std::endl;
+
+    bool complete = true;
+    double subjectTime = 0.0;
+    {
+        std::cout.setstate(std::ios::failbit);
+        Subject subject;
+        std::cout.clear();
+        for (const auto& observer : observers)
+        {
+            subject.addObserver(observer);
+        }
+        auto start = std::chrono::steady_clock::now();
+        for (int event = 0; event < EventCount; ++event)
+        {
+            subject.setState(event);
+        }
+        subjectTime = millisecondsSince(start);
+        complete = complete && delivered() == expected;
+        std::cout << "subject:        " << subjectTime / EventCount << " ms per event" << std::endl;
+        std::cout.setstate(std::ios::failbit);
+    }
+    std::cout.clear();
+
+    double singleTime = 0.0;
+    for (int threads : {1, 2, 4, 8})
+    {
+        ShardedSubject subject(0, threads - 1);
+        for (const auto& observer : observers)
+        {
+            subject.addObserver(observer);
+        }
+        auto start = std::chrono::steady_clock::now();
+        for (int event = 0; event < EventCount; ++event)
+        {
+            subject.setState(event);
+        }
+        const double time = millisecondsSince(start);
+        if (threads == 1)
+        {
+            singleTime = time;
+        }
+        complete = complete && delivered() == expected;
+        std::cout << "sharded, " << threads << " thread" << (threads > 1 ? "s: " : ":  ") << time / EventCount << " ms per event, "
+                  << singleTime / time << "x over 1 thread, " << subjectTime / time << "x over subject ("
+                  << subject.getShardCount() << " shards)" << std::endl;
+    }
+
+    std::cout << "deliveries " << (complete ? "complete" : "INCOMPLETE") << std::endl;
+    return complete ? 0 : 1;
+}
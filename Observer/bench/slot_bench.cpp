@@ -0,0 +1,142 @@
+/**
+ * @file slot_bench.cpp
+ * @brief Benchmark of the per-hop cost of SlotTable generation checks against weak_ptr::lock.
+ *
+ * The same observers are notified through Subject (a linked list of weak_ptr), through a vector
+ * of weak_ptr locked one by one, and through a SlotSubject checking generations, for a small and
+ * a large number of observers, with one observer in ten dead. Every way must make the same calls.
+ *
+ * Build and run from the Observer directory:
+ * @code
+ * make bench && ./bench/slot_bench
+ * @endcode
+ */
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include "Observer.h"
+#include "SlotTable.h"
+
+namespace
+{
+    constexpr std::uint64_t HopsPerCase = 20000000;
+
+    class CountingObserver : public Observer
+    {
+    public:
+        std::uint64_t total = 0;
+
+        void onNotify(int value) override
+        {
+            total += static_cast<std::uint64_t>(value);
+        }
+    };
+
+    double millisecondsSince(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    (void)argc;
+    (void)argv;
+
+    bool consistent = true;
+    std::cout << "observers  subject(ns/hop)  weak_ptr vector(ns/hop)  slot table(ns/hop)  speedup" << std::endl;
+    for (int count : {1000, 100000})
+    {
+        const int rounds = static_cast<int>(HopsPerCase / count);
+        std::vector<std::shared_ptr<CountingObserver>> observers;
+        for (int i = 0; i < count; ++i)
+        {
+            observers.push_back(std::make_shared<CountingObserver>());
+        }
+
+        SlotTable table;
+        std::vector<std::unique_ptr<SlotRegistration>> registrations;
+        std::cout.setstate(std::ios::failbit);
+        Subject subject;
+        std::cout.clear();
+        std::vector<std::weak_ptr<Observer>> weakObservers;
+        SlotSubject slotSubject(table);
+        for (const auto& observer : observers)
+        {
+            subject.addObserver(observer);
+            weakObservers.push_back(observer);
+            registrations.push_back(std::make_unique<SlotRegistration>(table, observer.get()));
+            slotSubject.addObserver(registrations.back()->handle());
+        }
+
+        // One in ten dies. Subject's chain runs through the observers themselves, so a dead one
+        // would cut it off: it has to be removed from Subject first.
+        for (int i = 0; i < count; i += 10)
+        {
+            subject.removeObserver(observers[i]);
+            registrations[i].reset();
+            observers[i].reset();
+        }
+
+        auto total = [&observers]()
+        {
+            std::uint64_t sum = 0;
+            for (const auto& observer : observers)
+            {
+                if (observer)
+                {
+                    sum += observer->total;
+                    observer->total = 0;
+                }
+            }
+            return sum;
+        };
+
+        double times[3];
+        std::uint64_t sums[3];
+
+        auto start = std::chrono::steady_clock::now();
+        for (int round = 0; round < rounds; ++round)
+        {
+            subject.setState(round);
+        }
+        times[0] = millisecondsSince(start);
+        sums[0] = total();
+
+        start = std::chrono::steady_clock::now();
+        for (int round = 0; round < rounds; ++round)
+        {
+            for (const auto& entry : weakObservers)
+            {
+                if (auto observer = entry.lock())
+                {
+                    observer->onNotify(round);
+                }
+            }
+        }
+        times[1] = millisecondsSince(start);
+        sums[1] = total();
+
+        start = std::chrono::steady_clock::now();
+        for (int round = 0; round < rounds; ++round)
+        {
+            slotSubject.setState(round);
+        }
+        times[2] = millisecondsSince(start);
+        sums[2] = total();
+
+        consistent = consistent && sums[0] == sums[1] && sums[1] == sums[2];
+        const double hops = static_cast<double>(rounds) * count;
+        std::cout << count << "  " << times[0] * 1e6 / hops << "  " << times[1] * 1e6 / hops << "  " << times[2] * 1e6 / hops
+                  << "  " << times[1] / times[2] << "x" << std::endl;
+
+        std::cout.setstate(std::ios::failbit);
+    }
+    std::cout.clear();
+
+    std::cout << "results " << (consistent ? "match" : "DIFFER") << std::endl;
+    return consistent ? 0 : 1;
+}
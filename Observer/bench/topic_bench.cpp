@@ -0,0 +1,214 @@
+/**
+ * @file topic_bench.cpp
+ * @brief Benchmark of TopicSubject routing against testing every subscription's pattern.
+ *
+ * 100k subscriptions (per-entity patterns such as `player.42.health`, shared ones such as
+ * `enemy.*.death`, `npc.7.#` and a few catch-all loggers) receive a stream of publishes over a
+ * few thousand distinct topics. Each publish is routed by scanning all the patterns, by walking the
+ * trie, and by walking the trie behind the per-topic cache; all three must notify the same
+ * observers the same number of times.
+ *
+ * Build and run from the Observer directory:
+ * @code
+ * make bench && ./bench/topic_bench
+ * @endcode
+ */
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "TopicSubject.h"
+
+namespace
+{
+    constexpr int PlayerCount = 50000;
+    constexpr int EnemyCount = 39900;
+    constexpr int DeathWatchers = 200;
+    constexpr int NpcWatchers = 9890;
+    constexpr int LoggerCount = 10;
+    constexpr int TopicCount = 4000;
+    constexpr int PublishCount = 100000;
+    constexpr int ScanPublishCount = 200;
+
+    class CountingObserver : public Observer
+    {
+    public:
+        std::uint64_t calls = 0;
+
+        void onNotify(int) override
+        {
+            ++calls;
+        }
+    };
+
+    std::vector<std::string> split(const std::string& name)
+    {
+        std::vector<std::string> segments;
+        std::size_t begin = 0;
+        while (true)
+        {
+            std::size_t end = name.find('.', begin);
+            segments.push_back(name.substr(begin, end == std::string::npos ? std::string::npos : end - begin));
+            if (end == std::string::npos) break;
+            begin = end + 1;
+        }
+        return segments;
+    }
+
+    /**
+     * @brief Straightforward pattern test, what a subject without an index does per subscription.
+     */
+    bool matches(const std::vector<std::string>& pattern, const std::vector<std::string>& topic)
+    {
+        std::size_t i = 0;
+        for (; i < pattern.size(); ++i)
+        {
+            if (pattern[i] == "#") return true;
+            if (i == topic.size() || (pattern[i] != "*" && pattern[i] != topic[i])) return false;
+        }
+        return i == topic.size();
+    }
+
+    double millisecondsSince(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    (void)argc;
+    (void)argv;
+
+    std::vector<std::string> patterns;
+    for (int i = 0; i < PlayerCount; ++i)
+    {
+        patterns.push_back("player." + std::to_string(i) + ".health");
+    }
+    for (int i = 0; i < EnemyCount; ++i)
+    {
+        patterns.push_back("enemy." + std::to_string(i) + ".#");
+    }
+    for (int i = 0; i < DeathWatchers; ++i)
+    {
+        patterns.push_back("enemy.*.death");
+    }
+    for (int i = 0; i < NpcWatchers; ++i)
+    {
+        patterns.push_back("npc." + std::to_string(i % 1000) + ".*.moved");
+    }
+    for (int i = 0; i < LoggerCount; ++i)
+    {
+        patterns.push_back("#");
+    }
+
+    std::mt19937 random(3);
+    std::vector<std::string> topics;
+    for (int i = 0; i < TopicCount; ++i)
+    {
+        switch (random() % 4)
+        {
+            case 0: topics.push_back("player." + std::to_string(random() % PlayerCount) + ".health"); break;
+            case 1: topics.push_back("enemy." + std::to_string(random() % EnemyCount) + ".death"); break;
+            case 2: topics.push_back("npc." + std::to_string(random() % 1000) + ".legs.moved"); break;
+            default: topics.push_back("ui.button." + std::to_string(random() % 100) + ".click"); break;
+        }
+    }
+    std::vector<int> stream(PublishCount);
+    for (int& topic : stream)
+    {
+        topic = static_cast<int>(random() % TopicCount);
+    }
+
+    std::vector<std::shared_ptr<CountingObserver>> observers;
+    for (std::size_t i = 0; i < patterns.size(); ++i)
+    {
+        observers.push_back(std::make_shared<CountingObserver>());
+    }
+    auto totalCalls = [&observers]()
+    {
+        std::uint64_t total = 0;
+        for (const auto& observer : observers)
+        {
+            total += observer->calls;
+            observer->calls = 0;
+        }
+        return total;
+    };
+
+    // Scan: every publish tests every subscription.
+    std::vector<std::pair<std::vector<std::string>, std::weak_ptr<Observer>>> scanned;
+    for (std::size_t i = 0; i < patterns.size(); ++i)
+    {
+        scanned.emplace_back(split(patterns[i]), observers[i]);
+    }
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < ScanPublishCount; ++i)
+    {
+        const std::vector<std::string> topic = split(topics[stream[i]]);
+        for (const auto& subscription : scanned)
+        {
+            if (matches(subscription.first, topic))
+            {
+                if (auto observer = subscription.second.lock())
+                {
+                    observer->onNotify(i);
+                }
+            }
+        }
+    }
+    const double scanTime = millisecondsSince(start) / ScanPublishCount;
+    const std::uint64_t scanCalls = totalCalls();
+
+    TopicSubject subject;
+    start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < patterns.size(); ++i)
+    {
+        subject.subscribe(patterns[i], observers[i]);
+    }
+    const double subscribeTime = millisecondsSince(start);
+
+    std::cout << "subscriptions: " << patterns.size() << " (added in " << subscribeTime << " ms), topics: " << TopicCount
+              << ", publishes: " << PublishCount << std::endl;
+    std::cout << "scan:         " << scanTime * 1000.0 << " us per publish, " << scanCalls / ScanPublishCount << " notifications" << std::endl;
+
+    bool consistent = true;
+    double times[2] = {0.0, 0.0};
+    std::uint64_t calls[2] = {0, 0};
+    for (int caching = 0; caching < 2; ++caching)
+    {
+        subject.setCaching(caching == 1);
+        subject.resetStats();
+
+        // The scan's publishes first, to compare against it.
+        for (int i = 0; i < ScanPublishCount; ++i)
+        {
+            subject.publish(topics[stream[i]], i);
+        }
+        consistent = consistent && totalCalls() == scanCalls;
+
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < PublishCount; ++i)
+        {
+            subject.publish(topics[stream[i]], i);
+        }
+        times[caching] = millisecondsSince(start) / PublishCount;
+        calls[caching] = totalCalls();
+
+        const TopicStats& stats = subject.getStats();
+        std::cout << (caching ? "trie + cache: " : "trie:         ") << times[caching] * 1000.0 << " us per publish, "
+                  << stats.notifications / stats.publishes << " notifications, "
+                  << stats.nodesVisited / stats.publishes << " trie nodes visited per publish, "
+                  << stats.cacheHits * 100 / stats.publishes << "% cache hits" << std::endl;
+    }
+    consistent = consistent && calls[0] == calls[1];
+
+    std::cout << "speedup over scan: " << scanTime / times[0] << "x (trie), " << scanTime / times[1] << "x (trie + cache), "
+              << "results " << (consistent ? "match" : "DIFFER") << std::endl;
+
+    return consistent ? 0 : 1;
+}
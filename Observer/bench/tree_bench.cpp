@@ -0,0 +1,150 @@
+/**
+ * @file tree_bench.cpp
+ * @brief Benchmark of EventTree propagation against a Subject per node linked by parent pointers.
+ *
+ * 100 trees of 1000 nodes each, grown so that most nodes hang below the previous few (depth in
+ * the hundreds, like long attachment chains), with a bubble listener on every eighth node and a
+ * capture listener on each root. Events are sent to random nodes: EventTree walks the cached path,
+ * the baseline walks parent pointers and notifies each node's Subject. Both must make the same
+ * listener calls.
+ *
+ * Build and run from the Observer directory:
+ * @code
+ * make bench && ./bench/tree_bench
+ * @endcode
+ */
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "EventTree.h"
+#include "Observer.h"
+
+namespace
+{
+    constexpr int TreeCount = 100;
+    constexpr int TreeSize = 1000;
+    constexpr int ListenerSpacing = 8;
+    constexpr int EventCount = 100000;
+
+    class CountingObserver : public Observer
+    {
+    public:
+        std::uint64_t* total;
+
+        explicit CountingObserver(std::uint64_t* total) : total(total) {}
+
+        void onNotify(int value) override
+        {
+            *total += static_cast<std::uint64_t>(value);
+        }
+    };
+
+    struct SubjectNode
+    {
+        SubjectNode* parent = nullptr;
+        std::unique_ptr<Subject> subject;
+    };
+
+    double millisecondsSince(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    (void)argc;
+    (void)argv;
+
+    std::mt19937 random(11);
+    std::vector<int> parents(TreeCount * TreeSize, -1);
+    for (int tree = 0; tree < TreeCount; ++tree)
+    {
+        const int root = tree * TreeSize;
+        for (int i = 1; i < TreeSize; ++i)
+        {
+            parents[root + i] = root + std::max(0, i - 1 - static_cast<int>(random() % 3));
+        }
+    }
+    std::vector<int> targets(EventCount);
+    for (int& target : targets)
+    {
+        target = static_cast<int>(random() % parents.size());
+    }
+
+    // EventTree.
+    std::uint64_t treeTotal = 0;
+    EventTree tree;
+    for (int parent : parents)
+    {
+        tree.addNode(parent < 0 ? EventTree::None : static_cast<EventTree::NodeId>(parent));
+    }
+    for (EventTree::NodeId node = 0; node < tree.size(); ++node)
+    {
+        if (parents[node] < 0)
+        {
+            tree.addListener(node, true, [&treeTotal](TreeEvent& event) { treeTotal += static_cast<std::uint64_t>(event.value); });
+        }
+        if (node % ListenerSpacing == 0)
+        {
+            tree.addListener(node, false, [&treeTotal](TreeEvent& event) { treeTotal += static_cast<std::uint64_t>(event.value); });
+        }
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < EventCount; ++i)
+    {
+        tree.dispatch(static_cast<EventTree::NodeId>(targets[i]), i);
+    }
+    const double treeTime = millisecondsSince(start);
+
+    // A Subject per node, bubbling by parent pointer. Subjects announce their construction.
+    std::uint64_t subjectTotal = 0;
+    double subjectTime = 0.0;
+    std::uint64_t hops = 0;
+    {
+        std::cout.setstate(std::ios::failbit);
+        std::vector<std::unique_ptr<SubjectNode>> nodes;
+        std::vector<std::shared_ptr<CountingObserver>> observers;
+        for (std::size_t node = 0; node < parents.size(); ++node)
+        {
+            nodes.push_back(std::make_unique<SubjectNode>());
+            nodes.back()->subject = std::make_unique<Subject>();
+            if (parents[node] >= 0)
+            {
+                nodes.back()->parent = nodes[parents[node]].get();
+            }
+            const int listeners = (parents[node] < 0 ? 1 : 0) + (node % ListenerSpacing == 0 ? 1 : 0);
+            for (int i = 0; i < listeners; ++i)
+            {
+                observers.push_back(std::make_shared<CountingObserver>(&subjectTotal));
+                nodes.back()->subject->addObserver(observers.back());
+            }
+        }
+        std::cout.clear();
+
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < EventCount; ++i)
+        {
+            for (SubjectNode* node = nodes[targets[i]].get(); node; node = node->parent)
+            {
+                node->subject->setState(i);
+                ++hops;
+            }
+        }
+        subjectTime = millisecondsSince(start);
+        std::cout.setstate(std::ios::failbit);
+    }
+    std::cout.clear();
+
+    std::cout << "nodes: " << parents.size() << ", events: " << EventCount << ", average depth: " << hops / EventCount << std::endl;
+    std::cout << "subject per node: " << subjectTime * 1000.0 / EventCount << " us per event" << std::endl;
+    std::cout << "event tree:       " << treeTime * 1000.0 / EventCount << " us per event" << std::endl;
+    std::cout << "speedup: " << subjectTime / treeTime << "x, results " << (treeTotal == subjectTotal ? "match" : "DIFFER") << std::endl;
+
+    return treeTotal == subjectTotal ? 0 : 1;
+}
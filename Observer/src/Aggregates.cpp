@@ -0,0 +1,259 @@
+#include "Aggregates.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+void RunningStats::add(int value)
+{
+    min = count == 0 ? value : std::min(min, value);
+    max = count == 0 ? value : std::max(max, value);
+    sum += value;
+    ++count;
+}
+
+void RunningStats::merge(const RunningStats& other)
+{
+    if (other.count == 0) return;
+
+    min = count == 0 ? other.min : std::min(min, other.min);
+    max = count == 0 ? other.max : std::max(max, other.max);
+    sum += other.sum;
+    count += other.count;
+}
+
+QuantileSketch::QuantileSketch(std::size_t k) : k_(std::max<std::size_t>(k, 8))
+{
+    levels_.emplace_back();
+    updateCapacities();
+}
+
+void QuantileSketch::updateCapacities()
+{
+    // Each level below the top gets two thirds of the room of the one above it, down to a
+    // minimum that keeps the bottom levels from compacting at almost every value.
+    capacities_.resize(levels_.size());
+    maxRetained_ = 0;
+    for (std::size_t level = 0; level < levels_.size(); ++level)
+    {
+        const std::size_t depth = levels_.size() - 1 - level;
+        capacities_[level] = std::max<std::size_t>(8, static_cast<std::size_t>(std::ceil(k_ * std::pow(2.0 / 3.0, depth))));
+        maxRetained_ += capacities_[level];
+    }
+}
+
+void QuantileSketch::compress()
+{
+    for (std::size_t level = 0; level < levels_.size(); ++level)
+    {
+        if (levels_[level].size() < capacities_[level]) continue;
+
+        if (level + 1 == levels_.size())
+        {
+            levels_.emplace_back();
+            updateCapacities();
+        }
+        std::vector<int>& items = levels_[level];
+        std::sort(items.begin(), items.end());
+
+        // With an odd count the smallest value stays behind; of the others, those at odd or at
+        // even positions move up, at random so that the error does not drift one way.
+        const std::size_t first = items.size() % 2;
+        random_ ^= random_ << 13;
+        random_ ^= random_ >> 17;
+        random_ ^= random_ << 5;
+        for (std::size_t i = first + (random_ & 1); i < items.size(); i += 2)
+        {
+            levels_[level + 1].push_back(items[i]);
+        }
+        retained_ -= (items.size() - first) / 2;
+        items.resize(first);
+        return;
+    }
+}
+
+void QuantileSketch::add(int value)
+{
+    levels_[0].push_back(value);
+    ++count_;
+    if (++retained_ >= maxRetained_)
+    {
+        compress();
+    }
+}
+
+void QuantileSketch::merge(const QuantileSketch& other)
+{
+    if (other.levels_.size() > levels_.size())
+    {
+        levels_.resize(other.levels_.size());
+    }
+    for (std::size_t level = 0; level < other.levels_.size(); ++level)
+    {
+        levels_[level].insert(levels_[level].end(), other.levels_[level].begin(), other.levels_[level].end());
+    }
+    count_ += other.count_;
+    retained_ += other.retained_;
+    updateCapacities();
+    while (retained_ >= maxRetained_)
+    {
+        compress();
+    }
+}
+
+int QuantileSketch::quantile(double q) const
+{
+    if (count_ == 0) return 0;
+
+    std::vector<std::pair<int, std::uint64_t>> weighted;
+    weighted.reserve(retained_);
+    for (std::size_t level = 0; level < levels_.size(); ++level)
+    {
+        for (int value : levels_[level])
+        {
+            weighted.emplace_back(value, std::uint64_t{1} << level);
+        }
+    }
+    std::sort(weighted.begin(), weighted.end());
+
+    const double rank = std::clamp(q, 0.0, 1.0) * count_;
+    std::uint64_t seen = 0;
+    for (const auto& [value, weight] : weighted)
+    {
+        seen += weight;
+        if (seen >= rank) return value;
+    }
+    return weighted.back().first;
+}
+
+HeavyHitters::HeavyHitters(std::size_t capacity) : capacity_(std::max<std::size_t>(capacity, 1))
+{
+    counters_.reserve(capacity_ + 1);
+}
+
+void HeavyHitters::decrementBy(std::uint64_t amount)
+{
+    for (auto it = counters_.begin(); it != counters_.end();)
+    {
+        if (it->second <= amount)
+        {
+            it = counters_.erase(it);
+        }
+        else
+        {
+            it->second -= amount;
+            ++it;
+        }
+    }
+    maxError_ += amount;
+}
+
+void HeavyHitters::add(int value)
+{
+    auto found = counters_.find(value);
+    if (found != counters_.end())
+    {
+        ++found->second;
+    }
+    else if (counters_.size() < capacity_)
+    {
+        counters_.emplace(value, 1);
+    }
+    else
+    {
+        // The new value is dropped along with one count of every other.
+        decrementBy(1);
+    }
+}
+
+void HeavyHitters::merge(const HeavyHitters& other)
+{
+    for (const auto& [value, count] : other.counters_)
+    {
+        counters_[value] += count;
+    }
+    maxError_ += other.maxError_;
+    if (counters_.size() <= capacity_) return;
+
+    // Dropping every counter by the one ranked just past capacity leaves at most capacity of them.
+    std::vector<std::uint64_t> counts;
+    counts.reserve(counters_.size());
+    for (const auto& entry : counters_)
+    {
+        counts.push_back(entry.second);
+    }
+    std::nth_element(counts.begin(), counts.begin() + capacity_, counts.end(), std::greater<std::uint64_t>());
+    decrementBy(counts[capacity_]);
+}
+
+std::vector<std::pair<int, std::uint64_t>> HeavyHitters::top(std::size_t k) const
+{
+    std::vector<std::pair<int, std::uint64_t>> entries(counters_.begin(), counters_.end());
+    std::sort(entries.begin(), entries.end(), [](const auto& a, const auto& b)
+    {
+        return a.second != b.second ? a.second > b.second : a.first < b.first;
+    });
+    if (entries.size() > k)
+    {
+        entries.resize(k);
+    }
+    return entries;
+}
+
+void Aggregates::add(int value)
+{
+    stats.add(value);
+    quantiles.add(value);
+    heavyHitters.add(value);
+}
+
+void Aggregates::merge(const Aggregates& other)
+{
+    stats.merge(other.stats);
+    quantiles.merge(other.quantiles);
+    heavyHitters.merge(other.heavyHitters);
+}
+
+void Aggregates::printReport(const char* name, std::size_t topCount) const
+{
+    std::cout << "[Aggregates] " << name << ": " << stats.count << " values, mean " << stats.mean() << ", min " << stats.min
+              << ", max " << stats.max << ", p50 " << quantiles.quantile(0.5) << ", p90 " << quantiles.quantile(0.9)
+              << ", p99 " << quantiles.quantile(0.99) << ", most frequent:";
+    for (const auto& [value, count] : heavyHitters.top(topCount))
+    {
+        std::cout << " " << value << " (" << count << "+)";
+    }
+    std::cout << std::endl;
+}
+
+void AggregateObserver::publish(bool wait)
+{
+    std::unique_lock<std::mutex> lock(snapshotMutex_, std::defer_lock);
+    if (wait)
+    {
+        lock.lock();
+    }
+    else if (!lock.try_lock())
+    {
+        return;
+    }
+
+    published_ = live_;
+    sincePublish_ = 0;
+    requested_.store(false, std::memory_order_relaxed);
+}
+
+void AggregateObserver::onNotify(int value)
+{
+    live_.add(value);
+    if (++sincePublish_ >= publishInterval_ || requested_.load(std::memory_order_relaxed))
+    {
+        publish(false);
+    }
+}
+
+Aggregates AggregateObserver::snapshot() const
+{
+    std::lock_guard<std::mutex> lock(snapshotMutex_);
+    return published_;
+}
@@ -0,0 +1,165 @@
+#ifndef AGGREGATES_H
+#define AGGREGATES_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "Observer.h"
+
+/**
+ * @struct RunningStats
+ * @brief Count, sum, minimum and maximum of a stream of values.
+ */
+struct RunningStats
+{
+    std::uint64_t count = 0;
+    std::int64_t sum = 0;
+    int min = 0;
+    int max = 0;
+
+    void add(int value);
+    void merge(const RunningStats& other);
+
+    double mean() const { return count > 0 ? static_cast<double>(sum) / count : 0.0; }
+};
+
+/**
+ * @class QuantileSketch
+ * @brief KLL sketch: approximate quantiles of a stream in memory bounded by its accuracy parameter.
+ *
+ * Values enter a stack of compactors. When a level fills up it is sorted and every other value
+ * moves up one level, where it stands for twice as many values. Lower levels get less room than
+ * the top one, so about 3k values are kept however long the stream, and the rank error of
+ * quantile() is around 1.7 / k of the count. An insertion costs O(log k) amortized.
+ */
+class QuantileSketch
+{
+private:
+    std::size_t k_;
+    std::vector<std::vector<int>> levels_;
+    std::vector<std::size_t> capacities_;
+    std::uint64_t count_ = 0;
+    std::size_t retained_ = 0;
+    std::size_t maxRetained_ = 0;
+    std::uint32_t random_ = 0x9E3779B9u;
+
+    void updateCapacities();
+    void compress();
+
+public:
+    explicit QuantileSketch(std::size_t k = 200);
+
+    void add(int value);
+
+    /**
+     * @brief Adds the values of another sketch, as if this one had seen both streams.
+     */
+    void merge(const QuantileSketch& other);
+
+    /**
+     * @brief Approximate value of rank q * count, for q between 0 and 1. 0 if nothing was added.
+     */
+    int quantile(double q) const;
+
+    std::uint64_t count() const { return count_; }
+    std::size_t retained() const { return retained_; }
+};
+
+/**
+ * @class HeavyHitters
+ * @brief Misra-Gries summary: the most frequent values of a stream, with a bounded number of counters.
+ *
+ * When a new value finds every counter taken, all counters drop by one instead. A count is thus
+ * underestimated by at most getMaxError(), no more than count / (capacity + 1), and any value seen
+ * more often than that is sure to have a counter. Each drop is paid for by earlier increments, so
+ * add() costs O(1) amortized.
+ */
+class HeavyHitters
+{
+private:
+    std::size_t capacity_;
+    std::unordered_map<int, std::uint64_t> counters_;
+    std::uint64_t maxError_ = 0;
+
+    void decrementBy(std::uint64_t amount);
+
+public:
+    explicit HeavyHitters(std::size_t capacity = 64);
+
+    void add(int value);
+    void merge(const HeavyHitters& other);
+
+    /**
+     * @brief The k values with the highest counts, highest first, with their underestimated counts.
+     */
+    std::vector<std::pair<int, std::uint64_t>> top(std::size_t k) const;
+
+    std::uint64_t getMaxError() const { return maxError_; }
+};
+
+/**
+ * @struct Aggregates
+ * @brief Every aggregate kept over one stream of values, mergeable with those of other streams.
+ */
+struct Aggregates
+{
+    RunningStats stats;
+    QuantileSketch quantiles;
+    HeavyHitters heavyHitters;
+
+    void add(int value);
+    void merge(const Aggregates& other);
+
+    void printReport(const char* name, std::size_t topCount = 3) const;
+};
+
+/**
+ * @class AggregateObserver
+ * @brief Observer keeping running aggregates of the values it is notified of, instead of logging them.
+ *
+ * It is updated by the thread notifying it; other threads read it through snapshot(). Every
+ * publishInterval values, or at the first value after requestSnapshot(), the notifying thread
+ * copies its aggregates into a snapshot. It only tries to lock the snapshot, skipping the copy
+ * until the next value if a reader holds it, so it never waits. Observers fed by different threads
+ * are combined by merging their snapshots.
+ */
+class AggregateObserver : public Observer
+{
+private:
+    Aggregates live_;
+    std::size_t publishInterval_;
+    std::size_t sincePublish_ = 0;
+    std::atomic<bool> requested_{false};
+
+    mutable std::mutex snapshotMutex_;
+    Aggregates published_;
+
+    void publish(bool wait);
+
+public:
+    explicit AggregateObserver(std::size_t publishInterval = 1024) : publishInterval_(publishInterval) {}
+
+    void onNotify(int value) override;
+
+    /**
+     * @brief Makes the notifying thread publish a snapshot at its next value.
+     */
+    void requestSnapshot() { requested_.store(true, std::memory_order_relaxed); }
+
+    /**
+     * @brief Publishes a snapshot of every value so far. Only call it from the notifying thread.
+     */
+    void flush() { publish(true); }
+
+    /**
+     * @brief Copy of the latest snapshot, from any thread.
+     */
+    Aggregates snapshot() const;
+};
+
+#endif
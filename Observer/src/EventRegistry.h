@@ -0,0 +1,148 @@
+#ifndef EVENT_REGISTRY_H
+#define EVENT_REGISTRY_H
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace detail
+{
+    /**
+     * @brief Index of the first of Events that is E, or sizeof...(Events) if none is.
+     */
+    template <typename E, typename... Events>
+    constexpr std::size_t indexOf()
+    {
+        constexpr bool matches[] = {std::is_same_v<E, Events>..., false};
+        for (std::size_t i = 0; i < sizeof...(Events); ++i)
+        {
+            if (matches[i]) return i;
+        }
+        return sizeof...(Events);
+    }
+
+    /**
+     * @brief Whether the id of every one of Events is distinct, which fails if a type is listed twice.
+     */
+    template <typename... Events>
+    constexpr bool idsAreUnique()
+    {
+        constexpr std::size_t ids[] = {indexOf<Events, Events...>()..., 0};
+        for (std::size_t i = 0; i < sizeof...(Events); ++i)
+        {
+            for (std::size_t j = i + 1; j < sizeof...(Events); ++j)
+            {
+                if (ids[i] == ids[j]) return false;
+            }
+        }
+        return true;
+    }
+
+    // The check itself, on lists with and without a repeated type.
+    static_assert(idsAreUnique<int, float, char>(), "distinct types must get distinct ids");
+    static_assert(!idsAreUnique<int, float, int>(), "a repeated type must be caught");
+}
+
+/**
+ * @class EventList
+ * @brief Compile-time registry of event types, each given a dense id: its position in the list.
+ *
+ * Ids are constant expressions, so resolving an event type to its subscribers is an array index
+ * fixed at compile time, with no typeid, hashing or map lookup at run time. Listing a type twice
+ * does not compile, nor does asking for the id of a type that is not listed.
+ */
+template <typename... Events>
+class EventList
+{
+    static_assert(sizeof...(Events) > 0, "an EventList needs at least one event type");
+    static_assert(detail::idsAreUnique<Events...>(), "each event type must be listed once");
+
+public:
+    static constexpr std::size_t size = sizeof...(Events);
+
+    template <typename E>
+    static constexpr bool contains = detail::indexOf<E, Events...>() < size;
+
+    template <typename E>
+    static constexpr std::size_t idOf()
+    {
+        static_assert(contains<E>, "event type is not in this EventList");
+        return detail::indexOf<E, Events...>();
+    }
+};
+
+/**
+ * @class EventObserver
+ * @brief Observer of typed events of type E. A class may observe several types by deriving from each.
+ */
+template <typename E>
+class EventObserver
+{
+public:
+    virtual ~EventObserver() = default;
+
+    virtual void onEvent(const E& event) = 0;
+};
+
+/**
+ * @class EventBus
+ * @brief Subject for every event type of an EventList, with one subscriber list per event id.
+ *
+ * Subscriber lists sit in an array indexed by event id. Each list only ever holds observers of
+ * its own type, so they are stored type-erased and cast back without a check. Observers are
+ * held weakly, like Subject does.
+ */
+template <typename List>
+class EventBus
+{
+private:
+    std::array<std::vector<std::weak_ptr<void>>, List::size> observers_;
+
+public:
+    template <typename E>
+    void addObserver(const std::shared_ptr<EventObserver<E>>& observer)
+    {
+        observers_[List::template idOf<E>()].push_back(observer);
+    }
+
+    template <typename E>
+    void removeObserver(const std::shared_ptr<EventObserver<E>>& observer)
+    {
+        auto& observers = observers_[List::template idOf<E>()];
+        for (std::size_t i = 0; i < observers.size(); ++i)
+        {
+            if (observers[i].lock() == observer)
+            {
+                observers.erase(observers.begin() + i);
+                return;
+            }
+        }
+    }
+
+    /**
+     * @brief Notifies every observer of events of type E.
+     */
+    template <typename E>
+    void publish(const E& event)
+    {
+        auto& observers = observers_[List::template idOf<E>()];
+        // By index: observers may subscribe while being notified.
+        for (std::size_t i = 0; i < observers.size(); ++i)
+        {
+            if (auto observer = observers[i].lock())
+            {
+                static_cast<EventObserver<E>*>(observer.get())->onEvent(event);
+            }
+        }
+    }
+
+    template <typename E>
+    std::size_t size() const
+    {
+        return observers_[List::template idOf<E>()].size();
+    }
+};
+
+#endif
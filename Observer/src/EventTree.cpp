@@ -0,0 +1,231 @@
+#include "EventTree.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+/**
+ * @brief Counts a dispatch in progress for as long as it runs, even if a listener throws, and
+ *        releases the listeners removed meanwhile when the outermost one ends.
+ */
+struct EventTree::DispatchScope
+{
+    EventTree& tree;
+
+    explicit DispatchScope(EventTree& tree) : tree(tree) { ++tree.dispatchDepth_; }
+
+    ~DispatchScope()
+    {
+        if (--tree.dispatchDepth_ == 0)
+        {
+            for (ListenerId id : tree.removedListeners_)
+            {
+                tree.listeners_[id].listener = nullptr;
+            }
+            tree.removedListeners_.clear();
+        }
+    }
+};
+
+EventTree::NodeId EventTree::addNode(NodeId parent)
+{
+    if (parent != None && parent >= parents_.size())
+    {
+        throw std::invalid_argument("EventTree: parent node does not exist");
+    }
+
+    const NodeId node = static_cast<NodeId>(parents_.size());
+    parents_.push_back(parent);
+    firstListeners_[0].push_back(None);
+    firstListeners_[1].push_back(None);
+    listening_.push_back(0);
+
+    if (pathsValid_)
+    {
+        // A new node has no listeners, so its path is its parent's, which is already cached.
+        if (pathStarts_.empty())
+        {
+            pathStarts_.push_back(0);
+        }
+        if (parent != None)
+        {
+            for (std::uint32_t i = pathStarts_[parent]; i < pathStarts_[parent + 1]; ++i)
+            {
+                pathNodes_.push_back(pathNodes_[i]);
+            }
+        }
+        pathStarts_.push_back(static_cast<std::uint32_t>(pathNodes_.size()));
+    }
+    return node;
+}
+
+void EventTree::setParent(NodeId node, NodeId parent)
+{
+    if (node >= parents_.size() || (parent != None && parent >= parents_.size()))
+    {
+        throw std::invalid_argument("EventTree: node does not exist");
+    }
+    for (NodeId ancestor = parent; ancestor != None; ancestor = parents_[ancestor])
+    {
+        if (ancestor == node)
+        {
+            throw std::invalid_argument("EventTree: a node cannot move under its own subtree");
+        }
+    }
+
+    parents_[node] = parent;
+    pathsValid_ = false;
+}
+
+void EventTree::buildPaths()
+{
+    pathStarts_.assign(1, 0);
+    pathNodes_.clear();
+    for (NodeId node = 0; node < parents_.size(); ++node)
+    {
+        const std::size_t start = pathNodes_.size();
+        for (NodeId ancestor = node; ancestor != None; ancestor = parents_[ancestor])
+        {
+            if (listening_[ancestor])
+            {
+                pathNodes_.push_back(ancestor);
+            }
+        }
+        std::reverse(pathNodes_.begin() + start, pathNodes_.end());
+        pathStarts_.push_back(static_cast<std::uint32_t>(pathNodes_.size()));
+    }
+    pathsValid_ = true;
+}
+
+EventTree::ListenerId EventTree::addListener(NodeId node, bool capture, Listener listener)
+{
+    if (node >= parents_.size())
+    {
+        throw std::invalid_argument("EventTree: node does not exist");
+    }
+
+    const int phase = capture ? 0 : 1;
+    const ListenerId id = static_cast<ListenerId>(listeners_.size());
+    listeners_.push_back(ListenerEntry{std::move(listener), firstListeners_[phase][node]});
+    firstListeners_[phase][node] = id;
+    if (!listening_[node])
+    {
+        // The node joins the paths of its whole subtree.
+        pathsValid_ = false;
+    }
+    listening_[node] |= static_cast<std::uint8_t>(1 << phase);
+    return id;
+}
+
+void EventTree::removeListener(ListenerId id)
+{
+    if (id >= listeners_.size() || listeners_[id].removed)
+    {
+        return;
+    }
+    listeners_[id].removed = true;
+    if (dispatchDepth_ > 0)
+    {
+        // The listener may be the one running: destroying it now would free its captures under it.
+        removedListeners_.push_back(id);
+    }
+    else
+    {
+        listeners_[id].listener = nullptr;
+    }
+}
+
+bool EventTree::runListeners(TreeEvent& event, NodeId node, int phase)
+{
+    event.current = node;
+    for (ListenerId id = firstListeners_[phase][node]; id != None; id = listeners_[id].next)
+    {
+        if (!listeners_[id].removed && listeners_[id].listener)
+        {
+            listeners_[id].listener(event);
+        }
+    }
+    return !event.stopped;
+}
+
+void EventTree::collectPath(NodeId target, std::vector<NodeId>& path) const
+{
+    path.clear();
+    for (NodeId node = target; node != None; node = parents_[node])
+    {
+        if (listening_[node])
+        {
+            path.push_back(node);
+        }
+    }
+    std::reverse(path.begin(), path.end());
+}
+
+bool EventTree::dispatch(NodeId target, int value)
+{
+    if (target >= parents_.size())
+    {
+        throw std::invalid_argument("EventTree: node does not exist");
+    }
+
+    // Paths are only rebuilt outside of dispatches, as a running dispatch reads them by offset.
+    // A dispatch started by a listener after the tree changed walks the parent links instead.
+    if (!pathsValid_ && dispatchDepth_ == 0)
+    {
+        buildPaths();
+    }
+    if (!pathsValid_)
+    {
+        std::vector<NodeId> path;
+        collectPath(target, path);
+        return propagate(target, value, path, 0, static_cast<std::uint32_t>(path.size()));
+    }
+    return propagate(target, value, pathNodes_, pathStarts_[target], pathStarts_[target + 1]);
+}
+
+bool EventTree::propagate(NodeId target, int value, const std::vector<NodeId>& path, std::uint32_t first, std::uint32_t last)
+{
+    // The path holds the target's ancestors that have listeners, and the target itself if it has
+    // any. Indices rather than pointers: listeners may add nodes, which appends to the path arrays.
+    TreeEvent event{value, target, target, TreeEvent::Capture};
+    DispatchScope scope(*this);
+    const bool targetListens = last > first && path[last - 1] == target;
+    const std::uint32_t ancestors = targetListens ? last - 1 : last;
+
+    bool propagating = true;
+    for (std::uint32_t i = first; i < ancestors && propagating; ++i)
+    {
+        const NodeId node = path[i];
+        if (listening_[node] & 1)
+        {
+            propagating = runListeners(event, node, 0);
+        }
+    }
+
+    if (propagating && targetListens)
+    {
+        // Both lists of the target belong to one node, so stopping in the first does not skip
+        // the second; it only keeps the event from bubbling.
+        event.phase = TreeEvent::Target;
+        if (listening_[target] & 1)
+        {
+            runListeners(event, target, 0);
+        }
+        if (listening_[target] & 2)
+        {
+            runListeners(event, target, 1);
+        }
+        propagating = !event.stopped;
+    }
+
+    event.phase = TreeEvent::Bubble;
+    for (std::uint32_t i = ancestors; i-- > first && propagating;)
+    {
+        const NodeId node = path[i];
+        if (listening_[node] & 2)
+        {
+            propagating = runListeners(event, node, 1);
+        }
+    }
+
+    return propagating;
+}
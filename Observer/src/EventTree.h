@@ -0,0 +1,125 @@
+#ifndef EVENT_TREE_H
+#define EVENT_TREE_H
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <vector>
+
+/**
+ * @struct TreeEvent
+ * @brief Event travelling through an EventTree, handed to every listener on its way.
+ */
+struct TreeEvent
+{
+    enum Phase
+    {
+        Capture, /**< From the root down to the target's parent */
+        Target,  /**< At the target itself */
+        Bubble   /**< From the target's parent up to the root */
+    };
+
+    int value;
+    std::uint32_t target;
+    std::uint32_t current; /**< Node whose listeners are running */
+    Phase phase;
+    bool stopped = false;
+
+    /**
+     * @brief Stops the event once the listeners of the current node have run.
+     */
+    void stopPropagation() { stopped = true; }
+};
+
+/**
+ * @class EventTree
+ * @brief Parent/child hierarchy of entities through which events are captured and bubbled.
+ *
+ * Nodes are indices into flat arrays. For each node, the ancestors on its path from the root that
+ * have listeners are cached contiguously, so a dispatch reads one short array instead of chasing
+ * parent links through nodes nobody listens to. Listeners of a node are chained by index in a
+ * single array. The cache is rebuilt on the first dispatch after a node moved or got its first
+ * listener.
+ *
+ * A dispatch runs the capture listeners from the root down to the target's parent, then the
+ * target's capture and bubble listeners, then the bubble listeners from its parent up to the root,
+ * unless a listener stops propagation. Listeners of a node run most recently added first, like
+ * Subject's observers.
+ */
+class EventTree
+{
+public:
+    using NodeId = std::uint32_t;
+    using ListenerId = std::uint32_t;
+    using Listener = std::function<void(TreeEvent& event)>;
+
+    static constexpr NodeId None = ~NodeId(0);
+
+private:
+    struct ListenerEntry
+    {
+        Listener listener;
+        std::uint32_t next;
+        bool removed = false;
+    };
+
+    struct DispatchScope;
+
+    std::vector<NodeId> parents_;
+    std::vector<std::uint32_t> firstListeners_[2]; /**< Per node, for capture and for bubble */
+    std::vector<std::uint8_t> listening_;          /**< Per node: bit 0 capture, bit 1 bubble */
+    std::deque<ListenerEntry> listeners_;          /**< A deque, so listeners can be added by running ones */
+
+    /**< Listening nodes on the path of node i from the root, ending with i if it listens, are
+         pathNodes_[pathStarts_[i] .. pathStarts_[i + 1]). */
+    std::vector<std::uint32_t> pathStarts_;
+    std::vector<NodeId> pathNodes_;
+    bool pathsValid_ = true;
+    int dispatchDepth_ = 0;
+    std::vector<ListenerId> removedListeners_;     /**< Removed during a dispatch, released after it */
+
+    void buildPaths();
+    void collectPath(NodeId target, std::vector<NodeId>& path) const;
+    bool propagate(NodeId target, int value, const std::vector<NodeId>& path, std::uint32_t first, std::uint32_t last);
+    bool runListeners(TreeEvent& event, NodeId node, int phase);
+
+public:
+    /**
+     * @brief Adds a node under a parent, or a new root when the parent is None.
+     * @throws std::invalid_argument If the parent does not exist.
+     */
+    NodeId addNode(NodeId parent = None);
+
+    /**
+     * @brief Moves a node and its subtree under another parent, or makes it a root.
+     * @throws std::invalid_argument If a node does not exist or the move would create a cycle.
+     */
+    void setParent(NodeId node, NodeId parent);
+
+    NodeId getParent(NodeId node) const { return parents_[node]; }
+
+    /**
+     * @brief Adds a listener to a node, for the capture phase or for the bubble phase.
+     * @throws std::invalid_argument If the node does not exist.
+     */
+    ListenerId addListener(NodeId node, bool capture, Listener listener);
+
+    /**
+     * @brief Disables a listener. Its slot in the chain is kept.
+     *
+     * During a dispatch, the listener is only released once the outermost dispatch returns, so
+     * that a listener may remove itself while it runs.
+     */
+    void removeListener(ListenerId id);
+
+    /**
+     * @brief Sends an event to a node through its ancestors.
+     * @return False if a listener stopped propagation.
+     * @throws std::invalid_argument If the node does not exist.
+     */
+    bool dispatch(NodeId target, int value);
+
+    std::size_t size() const { return parents_.size(); }
+};
+
+#endif
@@ -0,0 +1,63 @@
+#include "FrameArena.h"
+
+#include <algorithm>
+
+FrameArena::FrameArena(std::size_t blockSize)
+    : blockSize_(std::max<std::size_t>(blockSize, 256))
+{
+}
+
+FrameArena::~FrameArena()
+{
+    reset();
+}
+
+void* FrameArena::allocate(std::size_t size, std::size_t alignment)
+{
+    while (current_ < blocks_.size())
+    {
+        Block& block = blocks_[current_];
+        const std::uintptr_t base = reinterpret_cast<std::uintptr_t>(block.data.get());
+        const std::size_t start = ((base + offset_ + alignment - 1) & ~(std::uintptr_t(alignment) - 1)) - base;
+        if (start + size <= block.size)
+        {
+            bytesUsed_ += start + size - offset_;
+            offset_ = start + size;
+            return block.data.get() + start;
+        }
+        ++current_;
+        offset_ = 0;
+    }
+
+    // No kept block has room: add one, large enough for oversized payloads too.
+    const std::size_t blockSize = std::max(blockSize_, size + alignment);
+    blocks_.push_back(Block{std::unique_ptr<unsigned char[]>(new unsigned char[blockSize]), blockSize});
+    current_ = blocks_.size() - 1;
+    offset_ = 0;
+    return allocate(size, alignment);
+}
+
+void FrameArena::reset()
+{
+    // Reverse order of construction, like the end of a scope.
+    for (auto it = destructors_.rbegin(); it != destructors_.rend(); ++it)
+    {
+        it->destroy(it->object);
+    }
+    destructors_.clear();
+
+    current_ = 0;
+    offset_ = 0;
+    bytesUsed_ = 0;
+    ++generation_;
+}
+
+std::size_t FrameArena::capacity() const
+{
+    std::size_t total = 0;
+    for (const Block& block : blocks_)
+    {
+        total += block.size;
+    }
+    return total;
+}
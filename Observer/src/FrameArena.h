@@ -0,0 +1,133 @@
+#ifndef FRAME_ARENA_H
+#define FRAME_ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+template <typename T>
+class ArenaRef;
+
+/**
+ * @class FrameArena
+ * @brief Bump allocator for event payloads that live until the end of the frame.
+ *
+ * Payloads are constructed in large blocks and handed out as ArenaRef, which every observer
+ * reads in place instead of receiving a copy. reset(), called once per frame, destroys them all at
+ * once and rewinds the blocks, which are kept for the next frame.
+ *
+ * Each reset starts a new generation. In debug builds (without NDEBUG) an ArenaRef remembers the
+ * generation it was created in and throws when used after its frame ended.
+ */
+class FrameArena
+{
+private:
+    struct Block
+    {
+        std::unique_ptr<unsigned char[]> data;
+        std::size_t size;
+    };
+
+    struct Destructor
+    {
+        void (*destroy)(void*);
+        void* object;
+    };
+
+    std::vector<Block> blocks_;
+    std::size_t blockSize_;
+    std::size_t current_ = 0; /**< Block being filled */
+    std::size_t offset_ = 0;  /**< Bytes used in the current block */
+    std::size_t bytesUsed_ = 0;
+    std::vector<Destructor> destructors_;
+    std::uint32_t generation_ = 1;
+
+    void* allocate(std::size_t size, std::size_t alignment);
+
+public:
+    explicit FrameArena(std::size_t blockSize = 64 * 1024);
+    ~FrameArena();
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    /**
+     * @brief Constructs a payload in the arena. It lives until the next reset().
+     */
+    template <typename T, typename... Args>
+    ArenaRef<T> make(Args&&... args);
+
+    /**
+     * @brief Destroys every payload and starts a new generation. Blocks are kept.
+     */
+    void reset();
+
+    std::uint32_t generation() const { return generation_; }
+    std::size_t bytesUsed() const { return bytesUsed_; }
+    std::size_t capacity() const;
+};
+
+/**
+ * @class ArenaRef
+ * @brief Read-only reference to a payload in a FrameArena, checked against its generation in debug builds.
+ */
+template <typename T>
+class ArenaRef
+{
+private:
+    const T* object_ = nullptr;
+#ifndef NDEBUG
+    const FrameArena* arena_ = nullptr;
+    std::uint32_t generation_ = 0;
+#endif
+
+    friend class FrameArena;
+
+    ArenaRef(const T* object, const FrameArena& arena)
+        : object_(object)
+#ifndef NDEBUG
+        , arena_(&arena), generation_(arena.generation())
+#endif
+    {
+        (void)arena;
+    }
+
+public:
+    ArenaRef() = default;
+
+    /**
+     * @throws std::logic_error In debug builds, if the frame the payload belonged to has ended.
+     */
+    const T* get() const
+    {
+#ifndef NDEBUG
+        if (arena_ && arena_->generation() != generation_)
+        {
+            throw std::logic_error("ArenaRef: payload used after its frame arena was reset");
+        }
+#endif
+        return object_;
+    }
+
+    const T& operator*() const { return *get(); }
+    const T* operator->() const { return get(); }
+    explicit operator bool() const { return object_ != nullptr; }
+};
+
+template <typename T, typename... Args>
+ArenaRef<T> FrameArena::make(Args&&... args)
+{
+    T* object = new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    if (!std::is_trivially_destructible<T>::value)
+    {
+        destructors_.push_back(Destructor{[](void* pointer) { static_cast<T*>(pointer)->~T(); }, object});
+    }
+    return ArenaRef<T>(object, *this);
+}
+
+#endif
@@ -0,0 +1,159 @@
+#include "Hud.h"
+
+#include <algorithm>
+
+namespace
+{
+    // Segments a to g (top, top right, bottom right, bottom, bottom left, top left, middle) of 0-9.
+    const std::uint8_t DigitSegments[10] = {0x3F, 0x06, 0x5B, 0x4F, 0x66, 0x6D, 0x7D, 0x07, 0x7F, 0x6F};
+
+    void drawDigit(SDL_Renderer* renderer, int digit, int x, int y, int height)
+    {
+        const int width = height / 2;
+        const int thickness = std::max(1, height / 10);
+        const int half = height / 2;
+        const SDL_Rect segments[7] = {
+            {x, y, width, thickness},
+            {x + width - thickness, y, thickness, half},
+            {x + width - thickness, y + half, thickness, height - half},
+            {x, y + height - thickness, width, thickness},
+            {x, y + half, thickness, height - half},
+            {x, y, thickness, half},
+            {x, y + half - thickness / 2, width, thickness},
+        };
+
+        SDL_Rect lit[7];
+        int count = 0;
+        for (int segment = 0; segment < 7; ++segment)
+        {
+            if (DigitSegments[digit] & (1 << segment))
+            {
+                lit[count++] = segments[segment];
+            }
+        }
+        SDL_RenderFillRects(renderer, lit, count);
+    }
+}
+
+void drawNumber(SDL_Renderer* renderer, int value, int right, int y, int digitHeight)
+{
+    const int advance = digitHeight / 2 + std::max(2, digitHeight / 6);
+    int x = right - digitHeight / 2;
+    value = std::max(0, value);
+    do
+    {
+        drawDigit(renderer, value % 10, x, y, digitHeight);
+        value /= 10;
+        x -= advance;
+    } while (value > 0);
+}
+
+HudWidget::~HudWidget()
+{
+    releaseTexture();
+}
+
+void HudWidget::releaseTexture()
+{
+    if (texture_)
+    {
+        SDL_DestroyTexture(texture_);
+        texture_ = nullptr;
+    }
+    dirty_ = true;
+}
+
+bool HudWidget::rasterize(SDL_Renderer* renderer)
+{
+    if (!dirty_) return false;
+
+    if (!texture_)
+    {
+        texture_ = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, width_, height_);
+        if (!texture_)
+        {
+            // Retrying every frame would keep needsPresent() true and the loop from ever sleeping;
+            // the next change or invalidate() tries again.
+            dirty_ = false;
+            return false;
+        }
+        SDL_SetTextureBlendMode(texture_, SDL_BLENDMODE_BLEND);
+    }
+
+    SDL_Texture* previous = SDL_GetRenderTarget(renderer);
+    SDL_SetRenderTarget(renderer, texture_);
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+    SDL_RenderClear(renderer);
+    paint(renderer);
+    SDL_SetRenderTarget(renderer, previous);
+    dirty_ = false;
+    return true;
+}
+
+void HudWidget::draw(SDL_Renderer* renderer, int x, int y) const
+{
+    if (!texture_) return;
+
+    SDL_Rect destination = {x, y, width_, height_};
+    SDL_RenderCopy(renderer, texture_, nullptr, &destination);
+}
+
+void Hud::add(const std::shared_ptr<HudWidget>& widget, int x, int y)
+{
+    widgets_.push_back(Entry{widget, x, y});
+    presentPending_ = true;
+}
+
+bool Hud::needsPresent() const
+{
+    if (presentPending_) return true;
+
+    return std::any_of(widgets_.begin(), widgets_.end(), [](const Entry& entry)
+    {
+        return entry.widget->isDirty();
+    });
+}
+
+void Hud::invalidate(bool targetsLost)
+{
+    presentPending_ = true;
+    if (!targetsLost) return;
+
+    for (const Entry& entry : widgets_)
+    {
+        entry.widget->invalidate();
+    }
+}
+
+void Hud::releaseTextures()
+{
+    presentPending_ = true;
+    for (const Entry& entry : widgets_)
+    {
+        entry.widget->releaseTexture();
+    }
+}
+
+void Hud::render(SDL_Renderer* renderer)
+{
+    Uint64 start = SDL_GetPerformanceCounter();
+    for (const Entry& entry : widgets_)
+    {
+        if (entry.widget->rasterize(renderer))
+        {
+            ++stats_.widgetsRasterized;
+        }
+    }
+
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+    SDL_RenderClear(renderer);
+    for (const Entry& entry : widgets_)
+    {
+        entry.widget->draw(renderer, entry.x, entry.y);
+    }
+    stats_.drawSeconds += static_cast<double>(SDL_GetPerformanceCounter() - start) / SDL_GetPerformanceFrequency();
+
+    SDL_RenderPresent(renderer);
+    presentPending_ = false;
+    ++stats_.framesPresented;
+}
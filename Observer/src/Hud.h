@@ -0,0 +1,140 @@
+#ifndef HUD_H
+#define HUD_H
+
+#include <SDL2/SDL.h>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "Observer.h"
+
+/**
+ * @brief Draws a non-negative number in seven-segment digits, right-aligned against right.
+ * @param digitHeight Height of a digit; digits are half as wide.
+ */
+void drawNumber(SDL_Renderer* renderer, int value, int right, int y, int digitHeight);
+
+/**
+ * @class HudWidget
+ * @brief Observer drawn as part of the HUD, rasterized into its own texture.
+ *
+ * A widget paints itself once into a target texture and is then composed from that texture
+ * every time the HUD is drawn. Concrete widgets call markDirty() from onNotify when what they show
+ * changes, which is the only time they are painted again.
+ */
+class HudWidget : public Observer
+{
+private:
+    int width_;
+    int height_;
+    bool dirty_ = true;
+    SDL_Texture* texture_ = nullptr;
+
+protected:
+    /**
+     * @brief Paints the widget into the area (0, 0, width, height) of the current render target.
+     */
+    virtual void paint(SDL_Renderer* renderer) = 0;
+
+    void markDirty() { dirty_ = true; }
+
+public:
+    HudWidget(int width, int height) : width_(width), height_(height) {}
+    ~HudWidget() override;
+
+    HudWidget(const HudWidget&) = delete;
+    HudWidget& operator=(const HudWidget&) = delete;
+
+    bool isDirty() const { return dirty_; }
+
+    /**
+     * @brief Paints the widget into its texture if it is dirty, creating the texture first if needed.
+     *
+     * If the texture cannot be created, the widget is left undrawn and no longer dirty until it
+     * changes again or is invalidated.
+     * @return True if the widget was painted.
+     */
+    bool rasterize(SDL_Renderer* renderer);
+
+    /**
+     * @brief Copies the widget's texture to the current render target.
+     */
+    void draw(SDL_Renderer* renderer, int x, int y) const;
+
+    /**
+     * @brief Forgets the texture's content, for when the renderer lost its render targets.
+     */
+    void invalidate() { dirty_ = true; }
+
+    /**
+     * @brief Destroys the texture, which the next rasterize() creates again. Must be called
+     * before the renderer is destroyed, and when it lost its device.
+     */
+    void releaseTexture();
+
+    int getWidth() const { return width_; }
+    int getHeight() const { return height_; }
+};
+
+/**
+ * @struct HudStats
+ * @brief What a Hud drew and what it cost.
+ */
+struct HudStats
+{
+    std::uint64_t framesPresented = 0;
+    std::uint64_t widgetsRasterized = 0;
+    double drawSeconds = 0.0; /**< Rasterizing and composing, present excluded */
+};
+
+/**
+ * @class Hud
+ * @brief Retained-mode HUD: widgets at fixed positions, drawn only when one of them changed.
+ *
+ * The frame loop asks needsPresent() and only then calls render(); otherwise there is nothing new
+ * to show, and the loop can sleep in SDL_WaitEventTimeout instead of presenting the same frame.
+ */
+class Hud
+{
+private:
+    struct Entry
+    {
+        std::shared_ptr<HudWidget> widget;
+        int x;
+        int y;
+    };
+
+    std::vector<Entry> widgets_;
+    bool presentPending_ = true;
+    HudStats stats_;
+
+public:
+    void add(const std::shared_ptr<HudWidget>& widget, int x, int y);
+
+    /**
+     * @brief True if a widget changed or the window needs its content again.
+     */
+    bool needsPresent() const;
+
+    /**
+     * @brief Requests a present, for instance when the window was exposed.
+     * @param targetsLost True if the renderer lost its render targets, so every widget is repainted.
+     */
+    void invalidate(bool targetsLost);
+
+    /**
+     * @brief Destroys the widgets' textures, to be recreated at the next render(): on
+     * SDL_RENDER_DEVICE_RESET, when they are no longer valid, and before the renderer is destroyed,
+     * as widgets may outlive it.
+     */
+    void releaseTextures();
+
+    /**
+     * @brief Repaints the dirty widgets, composes all of them and presents.
+     */
+    void render(SDL_Renderer* renderer);
+
+    const HudStats& getStats() const { return stats_; }
+};
+
+#endif
@@ -0,0 +1,106 @@
+#include "Mailbox.h"
+
+#include <algorithm>
+
+void Mailbox::onNotify(int value)
+{
+    ++stats_.received;
+    if (policy_.mode == DeliveryPolicy::EveryEvent)
+    {
+        if (auto target = target_.lock())
+        {
+            ++stats_.delivered;
+            target->onNotify(value);
+        }
+        return;
+    }
+
+    if (pending_)
+    {
+        ++stats_.replaced;
+    }
+    latest_ = value;
+    pending_ = true;
+    arrived_ = true;
+}
+
+void Mailbox::deliver(std::uint64_t nowMs)
+{
+    if (arrived_)
+    {
+        arrived_ = false;
+        lastArrival_ = nowMs;
+    }
+    if (!pending_) return;
+
+    switch (policy_.mode)
+    {
+        case DeliveryPolicy::MaxRate:
+            if (delivered_ && policy_.perSecond > 0.0 && (nowMs - lastDelivery_) * policy_.perSecond < 1000.0) return;
+            break;
+        case DeliveryPolicy::Debounce:
+            if (nowMs - lastArrival_ < policy_.quietMs) return;
+            break;
+        default:
+            break;
+    }
+
+    // Cleared first: the observer may publish again while handling the value.
+    pending_ = false;
+    delivered_ = true;
+    lastDelivery_ = nowMs;
+    if (auto target = target_.lock())
+    {
+        ++stats_.delivered;
+        target->onNotify(latest_);
+    }
+}
+
+std::shared_ptr<Mailbox> MailboxSet::add(const std::shared_ptr<Observer>& target, DeliveryPolicy policy)
+{
+    auto mailbox = std::make_shared<Mailbox>(target, policy);
+    mailboxes_.push_back(mailbox);
+    return mailbox;
+}
+
+void MailboxSet::deliver(std::uint64_t nowMs)
+{
+    // By index: observers may add mailboxes while handling a value.
+    for (std::size_t i = 0; i < mailboxes_.size(); ++i)
+    {
+        mailboxes_[i]->deliver(nowMs);
+    }
+
+    auto expired = std::partition(mailboxes_.begin(), mailboxes_.end(), [](const std::shared_ptr<Mailbox>& mailbox)
+    {
+        return !mailbox->expired();
+    });
+    for (auto it = expired; it != mailboxes_.end(); ++it)
+    {
+        const DeliveryStats& stats = (*it)->getStats();
+        dropped_.received += stats.received;
+        dropped_.delivered += stats.delivered;
+        dropped_.replaced += stats.replaced;
+    }
+    mailboxes_.erase(expired, mailboxes_.end());
+}
+
+DeliveryStats MailboxSet::getStats() const
+{
+    DeliveryStats total = dropped_;
+    for (const auto& mailbox : mailboxes_)
+    {
+        const DeliveryStats& stats = mailbox->getStats();
+        total.received += stats.received;
+        total.delivered += stats.delivered;
+        total.replaced += stats.replaced;
+    }
+    return total;
+}
+
+void MailboxSet::printReport() const
+{
+    const DeliveryStats stats = getStats();
+    std::cout << "[Mailboxes] " << stats.received << " values received, " << stats.delivered << " handler calls, "
+              << stats.replaced << " avoided" << std::endl;
+}
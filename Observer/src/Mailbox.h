@@ -0,0 +1,113 @@
+#ifndef MAILBOX_H
+#define MAILBOX_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "Observer.h"
+
+/**
+ * @struct DeliveryPolicy
+ * @brief How often a Mailbox hands the values it receives to its observer.
+ */
+struct DeliveryPolicy
+{
+    enum Mode
+    {
+        EveryEvent,     /**< Every value, as soon as it is published */
+        LatestPerFrame, /**< The latest value, once per deliver() call */
+        MaxRate,        /**< The latest value, at most perSecond times per second */
+        Debounce        /**< The latest value, once no value arrived for quietMs */
+    };
+
+    Mode mode = EveryEvent;
+    double perSecond = 0.0;
+    std::uint64_t quietMs = 0;
+
+    static DeliveryPolicy everyEvent() { return DeliveryPolicy(); }
+    static DeliveryPolicy latestPerFrame() { DeliveryPolicy policy; policy.mode = LatestPerFrame; return policy; }
+    static DeliveryPolicy maxRate(double perSecond) { DeliveryPolicy policy; policy.mode = MaxRate; policy.perSecond = perSecond; return policy; }
+    static DeliveryPolicy debounce(std::uint64_t quietMs) { DeliveryPolicy policy; policy.mode = Debounce; policy.quietMs = quietMs; return policy; }
+};
+
+/**
+ * @struct DeliveryStats
+ * @brief Values received by mailboxes and handler calls made for them.
+ */
+struct DeliveryStats
+{
+    std::uint64_t received = 0;  /**< onNotify calls on the mailboxes */
+    std::uint64_t delivered = 0; /**< onNotify calls on the observers behind them */
+    std::uint64_t replaced = 0;  /**< Values overwritten by a newer one before delivery: handler calls avoided */
+};
+
+/**
+ * @class Mailbox
+ * @brief Observer standing between a subject and another observer, delivering to it by policy.
+ *
+ * Except under DeliveryPolicy::EveryEvent, onNotify only stores the value, replacing any value not
+ * delivered yet, so a publisher never waits on the observer behind the mailbox however often it
+ * publishes. The observer gets the latest value from deliver(), which the owner calls once per
+ * frame. Timing is measured in frames: an event counts as arriving at the next deliver() call.
+ */
+class Mailbox : public Observer
+{
+private:
+    std::weak_ptr<Observer> target_;
+    DeliveryPolicy policy_;
+    DeliveryStats stats_;
+
+    int latest_ = 0;
+    bool pending_ = false;
+    bool arrived_ = false;         /**< A value arrived since the previous deliver() */
+    bool delivered_ = false;       /**< At least one value was delivered */
+    std::uint64_t lastArrival_ = 0;
+    std::uint64_t lastDelivery_ = 0;
+
+public:
+    Mailbox(const std::shared_ptr<Observer>& target, DeliveryPolicy policy) : target_(target), policy_(policy) {}
+
+    void onNotify(int value) override;
+
+    /**
+     * @brief Hands the pending value to the observer if the policy allows it at this time.
+     * @param nowMs Current time in milliseconds, from any monotonic clock.
+     */
+    void deliver(std::uint64_t nowMs);
+
+    bool expired() const { return target_.expired(); }
+    const DeliveryPolicy& getPolicy() const { return policy_; }
+    const DeliveryStats& getStats() const { return stats_; }
+};
+
+/**
+ * @class MailboxSet
+ * @brief Owns the mailboxes of a frame loop and delivers all of them once per frame.
+ */
+class MailboxSet
+{
+private:
+    std::vector<std::shared_ptr<Mailbox>> mailboxes_;
+    DeliveryStats dropped_; /**< Stats of the mailboxes already dropped */
+
+public:
+    /**
+     * @brief Creates a mailbox for the observer. Subscribe the returned mailbox in its place.
+     */
+    std::shared_ptr<Mailbox> add(const std::shared_ptr<Observer>& target, DeliveryPolicy policy);
+
+    /**
+     * @brief Delivers every mailbox and drops those whose observer no longer exists.
+     */
+    void deliver(std::uint64_t nowMs);
+
+    /**
+     * @brief Totals over every mailbox the set has held.
+     */
+    DeliveryStats getStats() const;
+
+    void printReport() const;
+};
+
+#endif
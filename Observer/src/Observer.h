@@ -0,0 +1,119 @@
+#ifndef OBSERVER_H
+#define OBSERVER_H
+
+#include <iostream>
+#include <memory>
+
+/**
+ * @class Observer
+ * @brief Abstract base class for all observers in the observer pattern.
+ *
+ * Defines the interface for objects that need to be notified when the state of the subject changes.
+ */
+class Observer : public std::enable_shared_from_this<Observer> 
+{
+    friend class Subject;
+
+public:
+    Observer() = default;
+    virtual ~Observer() = default;
+
+    /**
+     * @brief Virtual function to handle state notifications.
+     * @param value The updated state value.
+     */
+    virtual void onNotify(int value) = 0;
+
+private:
+    /**< Pointer to the next observer in the chain */
+    std::weak_ptr<Observer> next_;
+};
+
+/**
+ * @class Subject
+ * @brief Represents the subject in the observer pattern.
+ *
+ * Manages a list of observers and notifies them of state changes.
+ */
+class Subject 
+{
+private:
+    std::weak_ptr<Observer> head_; /**< Head of the linked list of observers */
+    int state_; /**< Current state value of the subject */
+
+public:
+    Subject() : state_(0) 
+    {
+        std::cout << "Subject constructor called" << std::endl;
+    }
+
+    ~Subject() 
+    {
+        std::cout << "Subject destructor called" << std::endl;
+    }
+
+    /**
+     * @brief Adds a new observer to the subject.
+     * @param observer Shared pointer to the observer to be added.
+     */
+    void addObserver(const std::shared_ptr<Observer>& observer) 
+    {
+        if (auto currentHead = head_.lock()) 
+        {
+            observer->next_ = currentHead;
+        }
+        head_ = observer;
+    }
+
+    /**
+     * @brief Removes an observer from the subject.
+     * @param observer Shared pointer to the observer to be removed.
+     */
+    void removeObserver(const std::shared_ptr<Observer>& observer) 
+    {
+        auto currentHead = head_.lock();
+        if (!currentHead) return;
+
+        if (currentHead == observer) 
+        {
+            head_ = currentHead->next_;
+            return;
+        }
+
+        auto current = currentHead;
+        while (current) 
+        {
+            if (auto next = current->next_.lock(); next == observer) 
+            {
+                current->next_ = next->next_;
+                return;
+            }
+            current = current->next_.lock();
+        }
+    }
+
+    /**
+     * @brief Sets the state of the subject and notifies all observers.
+     * @param newState The new state value.
+     */
+    void setState(int newState) 
+    {
+        state_ = newState;
+        notifyObservers();
+    }
+
+    /**
+     * @brief Notifies all observers of the current state.
+     */
+    void notifyObservers() 
+    {
+        auto current = head_.lock();
+        while (current) 
+        {
+            current->onNotify(state_);
+            current = current->next_.lock();
+        }
+    }
+};
+
+#endif
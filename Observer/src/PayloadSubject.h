@@ -0,0 +1,70 @@
+#ifndef PAYLOAD_SUBJECT_H
+#define PAYLOAD_SUBJECT_H
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "FrameArena.h"
+
+/**
+ * @class PayloadObserver
+ * @brief Observer of events carrying a payload of type T, allocated in a FrameArena.
+ */
+template <typename T>
+class PayloadObserver
+{
+public:
+    virtual ~PayloadObserver() = default;
+
+    /**
+     * @brief Handles an event. The payload is shared with every other observer, not copied, and
+     * may be kept until the end of the frame.
+     */
+    virtual void onEvent(ArenaRef<T> payload) = 0;
+};
+
+/**
+ * @class PayloadSubject
+ * @brief Subject whose events carry a payload of type T instead of an int.
+ *
+ * Every observer receives a reference to the same payload, so publishing costs the same whatever
+ * the payload size. Observers are held weakly, like Subject does.
+ */
+template <typename T>
+class PayloadSubject
+{
+private:
+    std::vector<std::weak_ptr<PayloadObserver<T>>> observers_;
+
+public:
+    void addObserver(const std::shared_ptr<PayloadObserver<T>>& observer)
+    {
+        observers_.push_back(observer);
+    }
+
+    void removeObserver(const std::shared_ptr<PayloadObserver<T>>& observer)
+    {
+        observers_.erase(std::remove_if(observers_.begin(), observers_.end(), [&observer](const std::weak_ptr<PayloadObserver<T>>& entry)
+        {
+            return entry.expired() || entry.lock() == observer;
+        }), observers_.end());
+    }
+
+    /**
+     * @brief Notifies every observer of an event whose payload lives in a frame arena.
+     */
+    void publish(ArenaRef<T> payload)
+    {
+        // By index: observers may subscribe while being notified.
+        for (std::size_t i = 0; i < observers_.size(); ++i)
+        {
+            if (auto observer = observers_[i].lock())
+            {
+                observer->onEvent(payload);
+            }
+        }
+    }
+};
+
+#endif
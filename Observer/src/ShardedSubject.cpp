@@ -0,0 +1,121 @@
+#include "ShardedSubject.h"
+
+#include <algorithm>
+
+ShardedSubject::ShardedSubject(std::size_t shardCount, int workerCount, std::size_t parallelThreshold)
+    : parallelThreshold_(parallelThreshold)
+{
+    const int hardwareThreads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    const int workers = workerCount >= 0 ? workerCount : hardwareThreads - 1;
+    shards_ = std::vector<Shard>(shardCount > 0 ? shardCount : 4 * static_cast<std::size_t>(std::max(hardwareThreads, workers + 1)));
+    for (int i = 0; i < workers; ++i)
+    {
+        workers_.emplace_back(&ShardedSubject::runWorker, this);
+    }
+}
+
+ShardedSubject::~ShardedSubject()
+{
+    {
+        std::lock_guard<std::mutex> lock(controlMutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    for (std::thread& worker : workers_)
+    {
+        worker.join();
+    }
+}
+
+void ShardedSubject::addObserver(const std::shared_ptr<Observer>& observer)
+{
+    Shard& shard = shards_[nextSubscription_.fetch_add(1, std::memory_order_relaxed) % shards_.size()];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    shard.observers.push_back(observer);
+    observerCount_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void ShardedSubject::removeObserver(const std::shared_ptr<Observer>& observer)
+{
+    for (Shard& shard : shards_)
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto found = std::find_if(shard.observers.begin(), shard.observers.end(), [&observer](const std::weak_ptr<Observer>& entry)
+        {
+            return !entry.owner_before(observer) && !observer.owner_before(entry);
+        });
+        if (found != shard.observers.end())
+        {
+            *found = std::move(shard.observers.back());
+            shard.observers.pop_back();
+            observerCount_.fetch_sub(1, std::memory_order_relaxed);
+            return;
+        }
+    }
+}
+
+void ShardedSubject::runShards()
+{
+    // Shards are handed out one at a time, so threads that finish early take more of them.
+    while (true)
+    {
+        const std::size_t index = nextShard_.fetch_add(1, std::memory_order_relaxed);
+        if (index >= shards_.size()) return;
+
+        Shard& shard = shards_[index];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        for (const auto& entry : shard.observers)
+        {
+            if (auto observer = entry.lock())
+            {
+                observer->onNotify(state_);
+            }
+        }
+    }
+}
+
+void ShardedSubject::runWorker()
+{
+    std::uint64_t seen = 0;
+    std::unique_lock<std::mutex> lock(controlMutex_);
+    while (true)
+    {
+        wake_.wait(lock, [this, seen]() { return stopping_ || round_ != seen; });
+        if (stopping_) return;
+        seen = round_;
+
+        lock.unlock();
+        runShards();
+        lock.lock();
+
+        if (--busyWorkers_ == 0)
+        {
+            done_.notify_one();
+        }
+    }
+}
+
+void ShardedSubject::setState(int newState)
+{
+    std::lock_guard<std::mutex> dispatch(dispatchMutex_);
+    state_ = newState;
+    nextShard_.store(0, std::memory_order_relaxed);
+
+    if (workers_.empty() || size() < parallelThreshold_)
+    {
+        runShards();
+        return;
+    }
+
+    // The control mutex publishes the state and the reset shard counter to the workers.
+    {
+        std::lock_guard<std::mutex> lock(controlMutex_);
+        ++round_;
+        busyWorkers_ = workers_.size();
+    }
+    wake_.notify_all();
+    runShards();
+
+    std::unique_lock<std::mutex> lock(controlMutex_);
+    done_.wait(lock, [this]() { return busyWorkers_ == 0; });
+}
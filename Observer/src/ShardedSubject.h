@@ -0,0 +1,84 @@
+#ifndef SHARDED_SUBJECT_H
+#define SHARDED_SUBJECT_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Observer.h"
+
+/**
+ * @class ShardedSubject
+ * @brief Subject for global events with tens of thousands of observers, notified in parallel.
+ *
+ * Observers are spread round-robin over shards, each with its own lock and list on its own cache
+ * lines, so subscribing only contends with the shard it lands in. A notification is shared out
+ * shard by shard between the calling thread and a pool of worker threads, and returns once every
+ * shard is done. Below a threshold of observers it runs on the calling thread alone, where waking
+ * the workers would cost more than it saves.
+ *
+ * Each observer is notified on one thread, but different observers are notified concurrently:
+ * they must not share unsynchronized state, nor notify this subject from onNotify.
+ */
+class ShardedSubject
+{
+private:
+    static constexpr std::size_t CacheLineSize = 64;
+
+    struct alignas(CacheLineSize) Shard
+    {
+        std::mutex mutex;
+        std::vector<std::weak_ptr<Observer>> observers;
+    };
+
+    std::vector<Shard> shards_;
+    std::atomic<std::size_t> nextSubscription_{0};
+    std::atomic<std::size_t> observerCount_{0};
+    std::size_t parallelThreshold_;
+
+    std::vector<std::thread> workers_;
+    std::mutex dispatchMutex_;  /**< One notification at a time */
+    std::mutex controlMutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    std::uint64_t round_ = 0;
+    std::size_t busyWorkers_ = 0;
+    bool stopping_ = false;
+
+    alignas(CacheLineSize) std::atomic<std::size_t> nextShard_{0};
+    int state_ = 0;
+
+    void runWorker();
+    void runShards();
+
+public:
+    /**
+     * @param shardCount Number of shards; 0 picks four per thread.
+     * @param workerCount Worker threads besides the caller; -1 picks one less than the hardware threads.
+     * @param parallelThreshold Observers below which notifications stay on the calling thread.
+     */
+    explicit ShardedSubject(std::size_t shardCount = 0, int workerCount = -1, std::size_t parallelThreshold = 4096);
+    ~ShardedSubject();
+
+    ShardedSubject(const ShardedSubject&) = delete;
+    ShardedSubject& operator=(const ShardedSubject&) = delete;
+
+    void addObserver(const std::shared_ptr<Observer>& observer);
+    void removeObserver(const std::shared_ptr<Observer>& observer);
+
+    /**
+     * @brief Sets the state and notifies every observer, returning once all of them were notified.
+     */
+    void setState(int newState);
+
+    std::size_t size() const { return observerCount_.load(std::memory_order_relaxed); }
+    std::size_t getShardCount() const { return shards_.size(); }
+    std::size_t getWorkerCount() const { return workers_.size(); }
+};
+
+#endif
@@ -0,0 +1,209 @@
+#include "Signal.h"
+
+#include <stdexcept>
+#include <utility>
+
+SignalGraph::NodeId SignalGraph::addNode(std::uint8_t flags, double value, Compute compute)
+{
+    if (firstInputs_.empty())
+    {
+        firstInputs_.push_back(0);
+    }
+    values_.push_back(value);
+    changedEpochs_.push_back(epoch_);
+    computedEpochs_.push_back(0);
+    visitMarks_.push_back(0);
+    flags_.push_back(flags);
+    computes_.push_back(std::move(compute));
+    firstInputs_.push_back(static_cast<std::uint32_t>(inputs_.size()));
+    return static_cast<NodeId>(values_.size() - 1);
+}
+
+SignalGraph::NodeId SignalGraph::addSource(double value)
+{
+    return addNode(Source | Evaluated, value, Compute());
+}
+
+SignalGraph::NodeId SignalGraph::addComputed(const std::vector<NodeId>& inputs, Compute compute)
+{
+    for (NodeId input : inputs)
+    {
+        if (input >= values_.size())
+        {
+            throw std::invalid_argument("SignalGraph: input node does not exist");
+        }
+    }
+
+    inputs_.insert(inputs_.end(), inputs.begin(), inputs.end());
+    return addNode(Stale, 0.0, std::move(compute));
+}
+
+void SignalGraph::buildDependents()
+{
+    const std::size_t count = values_.size();
+    firstDependents_.assign(count + 1, 0);
+    for (NodeId input : inputs_)
+    {
+        ++firstDependents_[input + 1];
+    }
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        firstDependents_[i + 1] += firstDependents_[i];
+    }
+
+    dependents_.resize(inputs_.size());
+    std::vector<std::uint32_t> next(firstDependents_.begin(), firstDependents_.end() - 1);
+    for (std::size_t node = 0; node < count; ++node)
+    {
+        for (std::uint32_t i = firstInputs_[node]; i < firstInputs_[node + 1]; ++i)
+        {
+            dependents_[next[inputs_[i]]++] = static_cast<NodeId>(node);
+        }
+    }
+}
+
+void SignalGraph::set(NodeId source, double value)
+{
+    if (source >= values_.size() || !(flags_[source] & Source))
+    {
+        throw std::invalid_argument("SignalGraph: only source nodes can be set");
+    }
+    if (values_[source] == value) return;
+
+    values_[source] = value;
+    changedEpochs_[source] = ++epoch_;
+    if (flags_[source] & HasEffect)
+    {
+        pendingEffects_.push_back(source);
+    }
+    markDependents(source);
+}
+
+void SignalGraph::markDependents(NodeId node)
+{
+    if (firstDependents_.size() != values_.size() + 1)
+    {
+        buildDependents();
+    }
+
+    // Stops at nodes that are already stale: everything below them is stale too.
+    stack_.assign(1, node);
+    while (!stack_.empty())
+    {
+        const NodeId current = stack_.back();
+        stack_.pop_back();
+        for (std::uint32_t i = firstDependents_[current]; i < firstDependents_[current + 1]; ++i)
+        {
+            const NodeId dependent = dependents_[i];
+            std::uint8_t& flags = flags_[dependent];
+            if (flags & Stale) continue;
+
+            flags |= Stale;
+            ++stats_.nodesMarked;
+            if (flags & HasEffect)
+            {
+                pendingEffects_.push_back(dependent);
+            }
+            stack_.push_back(dependent);
+        }
+    }
+}
+
+double SignalGraph::get(NodeId node)
+{
+    if (flags_[node] & Stale)
+    {
+        refresh(node);
+    }
+    return values_[node];
+}
+
+void SignalGraph::refresh(NodeId node)
+{
+    // Depth-first search over the stale ancestors of the node, emitting every node after all of
+    // its inputs (post-order), which is a topological order. Fresh nodes are up to date, and so is
+    // everything above them.
+    ++pullMark_;
+    collected_.clear();
+    walk_.assign(1, WalkStep{node, firstInputs_[node]});
+    visitMarks_[node] = pullMark_;
+    while (!walk_.empty())
+    {
+        WalkStep& step = walk_.back();
+        if (step.nextInput == firstInputs_[step.node + 1])
+        {
+            collected_.push_back(step.node);
+            walk_.pop_back();
+            continue;
+        }
+
+        const NodeId input = inputs_[step.nextInput++];
+        if ((flags_[input] & Stale) && visitMarks_[input] != pullMark_)
+        {
+            visitMarks_[input] = pullMark_;
+            walk_.push_back(WalkStep{input, firstInputs_[input]});
+        }
+    }
+
+    for (NodeId current : collected_)
+    {
+        ++stats_.nodesVisited;
+        const std::uint32_t first = firstInputs_[current];
+        const std::uint32_t last = firstInputs_[current + 1];
+
+        bool inputsChanged = !(flags_[current] & Evaluated);
+        for (std::uint32_t i = first; i < last && !inputsChanged; ++i)
+        {
+            inputsChanged = changedEpochs_[inputs_[i]] > computedEpochs_[current];
+        }
+
+        if (inputsChanged)
+        {
+            arguments_.resize(last - first);
+            for (std::uint32_t i = first; i < last; ++i)
+            {
+                arguments_[i - first] = values_[inputs_[i]];
+            }
+            const double value = computes_[current](arguments_.data(), arguments_.size());
+            ++stats_.recomputations;
+
+            if (!(flags_[current] & Evaluated) || value != values_[current])
+            {
+                values_[current] = value;
+                changedEpochs_[current] = epoch_;
+            }
+            flags_[current] |= Evaluated;
+        }
+        computedEpochs_[current] = epoch_;
+        flags_[current] &= static_cast<std::uint8_t>(~Stale);
+    }
+}
+
+void SignalGraph::addEffect(NodeId node, Effect effect)
+{
+    flags_[node] |= HasEffect;
+    effects_.push_back(EffectEntry{node, std::move(effect), 0});
+    pendingEffects_.push_back(node);
+}
+
+void SignalGraph::flush()
+{
+    if (pendingEffects_.empty()) return;
+
+    // Pull every pending node before running any effect, so that effects see a consistent graph.
+    for (NodeId node : pendingEffects_)
+    {
+        get(node);
+    }
+    pendingEffects_.clear();
+
+    for (EffectEntry& entry : effects_)
+    {
+        if (changedEpochs_[entry.node] > entry.seenEpoch)
+        {
+            entry.seenEpoch = changedEpochs_[entry.node];
+            entry.effect(values_[entry.node]);
+            ++stats_.effectsRun;
+        }
+    }
+}
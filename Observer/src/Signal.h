@@ -0,0 +1,171 @@
+#ifndef SIGNAL_H
+#define SIGNAL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "Observer.h"
+
+/**
+ * @struct SignalStats
+ * @brief Work done by a SignalGraph since the last resetStats().
+ */
+struct SignalStats
+{
+    std::uint64_t recomputations = 0; /**< Compute functions called */
+    std::uint64_t nodesVisited = 0;   /**< Stale nodes checked while pulling a value */
+    std::uint64_t nodesMarked = 0;    /**< Nodes marked stale by a source change */
+    std::uint64_t effectsRun = 0;     /**< Effect callbacks called */
+};
+
+/**
+ * @class SignalGraph
+ * @brief Graph of source values and values derived from them, recomputed lazily and incrementally.
+ *
+ * Sources hold plain values. Computed nodes derive their value from other nodes, which must
+ * already exist when the node is added: the graph is acyclic by construction, and node ids are a
+ * topological order.
+ *
+ * Changing a source only marks the nodes downstream of it as stale, nothing is recomputed. Reading
+ * a stale node with get() collects its stale ancestors and brings them up to date inputs first, so
+ * every node is computed at most once per change and only after all of its inputs: derived values
+ * never observe a mix of old and new inputs (no glitches). A node whose inputs all kept their
+ * value is not recomputed, and a recomputed node that produces the same value does not cause its
+ * dependents to be recomputed.
+ *
+ * Effects are callbacks attached to nodes. They run in flush(), once per changed node, after all
+ * the changes made since the previous flush.
+ */
+class SignalGraph
+{
+public:
+    using NodeId = std::uint32_t;
+
+    /**
+     * @brief Computes a node from the current values of its inputs, in the order they were given.
+     */
+    using Compute = std::function<double(const double* inputs, std::size_t count)>;
+
+    using Effect = std::function<void(double value)>;
+
+private:
+    enum Flags : std::uint8_t
+    {
+        Source = 1,
+        Stale = 2,
+        Evaluated = 4,
+        HasEffect = 8
+    };
+
+    struct EffectEntry
+    {
+        NodeId node;
+        Effect effect;
+        std::uint64_t seenEpoch;
+    };
+
+    struct WalkStep
+    {
+        NodeId node;
+        std::uint32_t nextInput;
+    };
+
+    // Per-node state is kept in parallel arrays so that marking and pulling, which touch tens of
+    // thousands of nodes, only load the fields they need.
+    std::vector<double> values_;
+    std::vector<std::uint64_t> changedEpochs_;  /**< Epoch of the last change of the value */
+    std::vector<std::uint64_t> computedEpochs_; /**< Epoch the value was last verified at */
+    std::vector<std::uint32_t> visitMarks_;     /**< Pull that last collected the node */
+    std::vector<std::uint8_t> flags_;
+    std::vector<Compute> computes_;
+
+    /**< Inputs of node i are inputs_[firstInputs_[i] .. firstInputs_[i + 1]). */
+    std::vector<std::uint32_t> firstInputs_;
+    std::vector<NodeId> inputs_;
+
+    /**< Dependents in the same layout, rebuilt on the first change after nodes were added. */
+    std::vector<std::uint32_t> firstDependents_;
+    std::vector<NodeId> dependents_;
+
+    std::vector<EffectEntry> effects_;
+    std::vector<NodeId> pendingEffects_;
+
+    std::uint64_t epoch_ = 1;
+    std::uint32_t pullMark_ = 0;
+
+    /**< Scratch buffers reused by every change and pull. */
+    std::vector<NodeId> stack_;
+    std::vector<WalkStep> walk_;
+    std::vector<NodeId> collected_;
+    std::vector<double> arguments_;
+
+    SignalStats stats_;
+
+    NodeId addNode(std::uint8_t flags, double value, Compute compute);
+    void buildDependents();
+    void markDependents(NodeId node);
+    void refresh(NodeId node);
+
+public:
+    /**
+     * @brief Adds a source node holding a value.
+     */
+    NodeId addSource(double value);
+
+    /**
+     * @brief Adds a node computed from existing nodes. It is first computed when read.
+     * @throws std::invalid_argument If an input does not exist.
+     */
+    NodeId addComputed(const std::vector<NodeId>& inputs, Compute compute);
+
+    /**
+     * @brief Changes a source. Dependents become stale but are not recomputed.
+     * @throws std::invalid_argument If the node is not a source.
+     */
+    void set(NodeId source, double value);
+
+    /**
+     * @brief Returns the current value of a node, recomputing whatever it depends on that is stale.
+     */
+    double get(NodeId node);
+
+    /**
+     * @brief Calls the effect with the node's value whenever flush() finds that the value changed.
+     */
+    void addEffect(NodeId node, Effect effect);
+
+    /**
+     * @brief Brings every node with an effect up to date and runs the effects whose node changed.
+     */
+    void flush();
+
+    std::size_t size() const { return values_.size(); }
+
+    const SignalStats& getStats() const { return stats_; }
+    void resetStats() { stats_ = SignalStats(); }
+};
+
+/**
+ * @class SubjectSource
+ * @brief Observer that feeds every state of a Subject into a source node of a SignalGraph.
+ */
+class SubjectSource : public Observer
+{
+private:
+    SignalGraph& graph_;
+    SignalGraph::NodeId node_;
+
+public:
+    SubjectSource(SignalGraph& graph, double initial) : graph_(graph), node_(graph.addSource(initial)) {}
+
+    SignalGraph::NodeId node() const { return node_; }
+
+    void onNotify(int value) override
+    {
+        graph_.set(node_, value);
+    }
+};
+
+#endif
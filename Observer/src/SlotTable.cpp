@@ -0,0 +1,88 @@
+#include "SlotTable.h"
+
+#include <algorithm>
+#include <limits>
+
+SlotHandle SlotTable::add(Observer* observer)
+{
+    std::uint32_t index;
+    if (!free_.empty())
+    {
+        index = free_.back();
+        free_.pop_back();
+    }
+    else
+    {
+        index = static_cast<std::uint32_t>(slots_.size());
+        slots_.emplace_back();
+    }
+
+    slots_[index].observer = observer;
+    ++alive_;
+    return SlotHandle{index, slots_[index].generation};
+}
+
+void SlotTable::remove(SlotHandle handle)
+{
+    if (handle.index >= slots_.size() || slots_[handle.index].generation != handle.generation) return;
+
+    Slot& slot = slots_[handle.index];
+    slot.observer = nullptr;
+    --alive_;
+    if (slot.generation == std::numeric_limits<std::uint32_t>::max())
+    {
+        // Reusing the slot would make the oldest handles valid again.
+        slot.generation = 0;
+        return;
+    }
+    ++slot.generation;
+    free_.push_back(handle.index);
+}
+
+void SlotSubject::removeObserver(SlotHandle handle)
+{
+    // Only marked here: the slot's generation is never 0, so the next notification drops it.
+    // Erasing now would shift the handles under a notification in progress.
+    for (SlotHandle& observer : observers_)
+    {
+        if (observer.index == handle.index && observer.generation == handle.generation)
+        {
+            observer.generation = 0;
+        }
+    }
+}
+
+void SlotSubject::notifyObservers()
+{
+    // Restores notifying_ on every way out, including an observer throwing.
+    struct NotifyingScope
+    {
+        bool& flag;
+        bool outer;
+        explicit NotifyingScope(bool& flag) : flag(flag), outer(!flag) { flag = true; }
+        ~NotifyingScope() { if (outer) flag = false; }
+    } scope(notifying_);
+
+    // By index: observers may add observers while being notified, which may reallocate. Nothing
+    // moves until the loop is over, so a notification made by an observer sees the same array.
+    bool sawDead = false;
+    for (std::size_t i = 0; i < observers_.size(); ++i)
+    {
+        Observer* observer = table_.resolve(observers_[i]);
+        if (!observer)
+        {
+            sawDead = true;
+            continue;
+        }
+        observer->onNotify(state_);
+    }
+
+    // Dead handles are dropped by the outermost notification only, once no loop is walking them.
+    if (sawDead && scope.outer)
+    {
+        observers_.erase(std::remove_if(observers_.begin(), observers_.end(), [this](SlotHandle handle)
+        {
+            return table_.resolve(handle) == nullptr;
+        }), observers_.end());
+    }
+}
@@ -0,0 +1,117 @@
+#ifndef SLOT_TABLE_H
+#define SLOT_TABLE_H
+
+#include <cstdint>
+#include <vector>
+
+#include "Observer.h"
+
+/**
+ * @struct SlotHandle
+ * @brief Weak reference to an observer registered in a SlotTable: a slot index and its generation.
+ */
+struct SlotHandle
+{
+    std::uint32_t index = 0;
+    std::uint32_t generation = 0; /**< Never 0 for a registered observer */
+};
+
+/**
+ * @class SlotTable
+ * @brief Central table tracking which observers are still alive, without shared_ptr control blocks.
+ *
+ * An observer registers to get a slot; when it dies its slot's generation is bumped and the slot
+ * reused. A handle whose generation no longer matches its slot refers to a dead observer, so
+ * checking one is a plain load and compare, where weak_ptr::lock does two atomic operations.
+ * Slots whose generation would wrap around are retired instead of reused. Not thread-safe: like
+ * Subject, it is meant for the thread running the frame loop.
+ */
+class SlotTable
+{
+private:
+    struct Slot
+    {
+        Observer* observer = nullptr;
+        std::uint32_t generation = 1;
+    };
+
+    std::vector<Slot> slots_;
+    std::vector<std::uint32_t> free_;
+    std::size_t alive_ = 0;
+
+public:
+    SlotHandle add(Observer* observer);
+
+    /**
+     * @brief Marks the observer dead: every handle to it stops resolving. Stale handles are ignored.
+     */
+    void remove(SlotHandle handle);
+
+    /**
+     * @brief The observer, or nullptr if it was removed.
+     */
+    Observer* resolve(SlotHandle handle) const
+    {
+        const Slot& slot = slots_[handle.index];
+        return slot.generation == handle.generation ? slot.observer : nullptr;
+    }
+
+    std::size_t size() const { return alive_; }
+};
+
+/**
+ * @class SlotRegistration
+ * @brief Keeps an observer registered in a SlotTable for as long as the registration lives.
+ *
+ * Declared as the last member of an observer (or next to it), it removes the observer from the
+ * table as the observer is destroyed.
+ */
+class SlotRegistration
+{
+private:
+    SlotTable& table_;
+    SlotHandle handle_;
+
+public:
+    SlotRegistration(SlotTable& table, Observer* observer) : table_(table), handle_(table.add(observer)) {}
+    ~SlotRegistration() { table_.remove(handle_); }
+
+    SlotRegistration(const SlotRegistration&) = delete;
+    SlotRegistration& operator=(const SlotRegistration&) = delete;
+
+    SlotHandle handle() const { return handle_; }
+};
+
+/**
+ * @class SlotSubject
+ * @brief Subject whose observers are SlotTable handles in a contiguous array.
+ *
+ * Notifying resolves each handle with a generation check; handles of dead observers are dropped
+ * at the end of the outermost pass.
+ */
+class SlotSubject
+{
+private:
+    const SlotTable& table_;
+    std::vector<SlotHandle> observers_;
+    int state_ = 0;
+    bool notifying_ = false;
+
+public:
+    explicit SlotSubject(const SlotTable& table) : table_(table) {}
+
+    void addObserver(SlotHandle handle) { observers_.push_back(handle); }
+    void removeObserver(SlotHandle handle);
+
+    void setState(int newState)
+    {
+        state_ = newState;
+        notifyObservers();
+    }
+
+    void notifyObservers();
+
+    std::size_t size() const { return observers_.size(); }
+};
+
+#endif
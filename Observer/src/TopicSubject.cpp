@@ -0,0 +1,212 @@
+#include "TopicSubject.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+TopicSubject::TopicSubject()
+    : nodes_(1)
+{
+}
+
+std::uint32_t TopicSubject::child(std::uint32_t node, const std::string& segment)
+{
+    if (segment == "*" || segment == "#")
+    {
+        std::uint32_t next = segment == "*" ? nodes_[node].star : nodes_[node].hash;
+        if (next == None)
+        {
+            next = static_cast<std::uint32_t>(nodes_.size());
+            (segment == "*" ? nodes_[node].star : nodes_[node].hash) = next;
+            nodes_.emplace_back();
+        }
+        return next;
+    }
+
+    auto segmentId = segments_.emplace(segment, static_cast<std::uint32_t>(segments_.size())).first->second;
+    auto edge = edges_.emplace(std::uint64_t(node) << 32 | segmentId, static_cast<std::uint32_t>(nodes_.size()));
+    if (edge.second)
+    {
+        nodes_.emplace_back();
+    }
+    return edge.first->second;
+}
+
+TopicSubject::SubscriptionId TopicSubject::subscribe(const std::string& pattern, const std::shared_ptr<Observer>& observer)
+{
+    // Validate the whole pattern before adding anything to the trie.
+    std::size_t begin = 0;
+    while (true)
+    {
+        std::size_t end = pattern.find('.', begin);
+        std::size_t last = end == std::string::npos ? pattern.size() : end;
+        if (last == begin)
+        {
+            throw std::invalid_argument("TopicSubject: empty segment in pattern '" + pattern + "'");
+        }
+        if (pattern.compare(begin, last - begin, "#") == 0 && end != std::string::npos)
+        {
+            throw std::invalid_argument("TopicSubject: '#' must be the last segment of '" + pattern + "'");
+        }
+        if (end == std::string::npos) break;
+        begin = end + 1;
+    }
+
+    std::uint32_t node = 0;
+    begin = 0;
+    while (true)
+    {
+        std::size_t end = pattern.find('.', begin);
+        node = child(node, pattern.substr(begin, end == std::string::npos ? std::string::npos : end - begin));
+        if (end == std::string::npos) break;
+        begin = end + 1;
+    }
+
+    const SubscriptionId id = static_cast<SubscriptionId>(subscriptions_.size());
+    subscriptions_.push_back(Subscription{observer, node, true});
+    nodes_[node].subscriptions.push_back(id);
+    invalidate();
+    return id;
+}
+
+void TopicSubject::unsubscribe(SubscriptionId id)
+{
+    if (id >= subscriptions_.size() || !subscriptions_[id].active) return;
+
+    Subscription& subscription = subscriptions_[id];
+    subscription.active = false;
+    subscription.observer.reset();
+    std::vector<SubscriptionId>& list = nodes_[subscription.node].subscriptions;
+    list.erase(std::find(list.begin(), list.end(), id));
+    invalidate();
+}
+
+void TopicSubject::match(std::uint32_t node, std::size_t depth)
+{
+    ++stats_.nodesVisited;
+    const TrieNode& current = nodes_[node];
+
+    // A trailing '#' matches whatever is left of the topic, including nothing.
+    if (current.hash != None)
+    {
+        ++stats_.nodesVisited;
+        const std::vector<SubscriptionId>& rest = nodes_[current.hash].subscriptions;
+        matches_.insert(matches_.end(), rest.begin(), rest.end());
+    }
+
+    if (depth == topicSegments_.size())
+    {
+        matches_.insert(matches_.end(), current.subscriptions.begin(), current.subscriptions.end());
+        return;
+    }
+
+    if (topicSegments_[depth] != None)
+    {
+        auto edge = edges_.find(std::uint64_t(node) << 32 | topicSegments_[depth]);
+        if (edge != edges_.end())
+        {
+            match(edge->second, depth + 1);
+        }
+    }
+    if (current.star != None)
+    {
+        match(current.star, depth + 1);
+    }
+}
+
+void TopicSubject::resolve(const std::string& topic)
+{
+    // Segments nobody subscribed to by name can still match '*' and '#', so they are kept as None.
+    topicSegments_.clear();
+    std::string segment;
+    std::size_t begin = 0;
+    while (true)
+    {
+        std::size_t end = topic.find('.', begin);
+        segment.assign(topic, begin, end == std::string::npos ? std::string::npos : end - begin);
+        auto found = segments_.find(segment);
+        topicSegments_.push_back(found == segments_.end() ? None : found->second);
+        if (end == std::string::npos) break;
+        begin = end + 1;
+    }
+
+    // Every pattern leads to a single trie node, visited at most once per topic, so the
+    // matches contain no duplicates.
+    matches_.clear();
+    match(0, 0);
+}
+
+void TopicSubject::invalidate()
+{
+    // Cached lists may be in the middle of being notified; they are dropped once that is over.
+    if (publishDepth_ > 0)
+    {
+        cacheStale_ = true;
+        return;
+    }
+    cache_.clear();
+}
+
+void TopicSubject::publish(const std::string& topic, int value)
+{
+    ++stats_.publishes;
+
+    // Uncached matches are moved out of the scratch buffer, which a nested publish would reuse.
+    std::vector<SubscriptionId> uncached;
+    const std::vector<SubscriptionId>* targets = nullptr;
+    auto cached = caching_ ? cache_.find(topic) : cache_.end();
+    if (cached != cache_.end())
+    {
+        ++stats_.cacheHits;
+        targets = &cached->second;
+    }
+    else
+    {
+        resolve(topic);
+        if (caching_ && !cacheStale_ && (cache_.size() < MaxCachedTopics || publishDepth_ == 0))
+        {
+            if (cache_.size() >= MaxCachedTopics)
+            {
+                cache_.clear();
+            }
+            targets = &cache_.emplace(topic, matches_).first->second;
+        }
+        else
+        {
+            uncached.swap(matches_);
+            targets = &uncached;
+        }
+    }
+
+    ++publishDepth_;
+    for (SubscriptionId id : *targets)
+    {
+        if (auto observer = subscriptions_[id].observer.lock())
+        {
+            observer->onNotify(value);
+            ++stats_.notifications;
+        }
+    }
+    --publishDepth_;
+
+    if (publishDepth_ == 0 && cacheStale_)
+    {
+        cacheStale_ = false;
+        cache_.clear();
+    }
+    if (!uncached.empty() && matches_.capacity() < uncached.capacity())
+    {
+        matches_.swap(uncached);
+    }
+}
+
+std::size_t TopicSubject::countMatches(const std::string& topic)
+{
+    resolve(topic);
+    return matches_.size();
+}
+
+void TopicSubject::setCaching(bool enabled)
+{
+    caching_ = enabled;
+    invalidate();
+}
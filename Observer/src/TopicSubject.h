@@ -0,0 +1,117 @@
+#ifndef TOPIC_SUBJECT_H
+#define TOPIC_SUBJECT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Observer.h"
+
+/**
+ * @struct TopicStats
+ * @brief Work done by a TopicSubject since the last resetStats().
+ */
+struct TopicStats
+{
+    std::uint64_t publishes = 0;     /**< Calls to publish() */
+    std::uint64_t cacheHits = 0;     /**< Publishes resolved from the match cache */
+    std::uint64_t nodesVisited = 0;  /**< Trie nodes visited by cache misses */
+    std::uint64_t notifications = 0; /**< onNotify calls made */
+};
+
+/**
+ * @class TopicSubject
+ * @brief Subject that routes events by dot-separated topic names such as `player.3.health`.
+ *
+ * Observers subscribe with a pattern of the same form, in which `*` matches exactly one segment
+ * and `#`, allowed only as the last segment, matches any number of segments including none:
+ * `enemy.*.death` matches `enemy.7.death`, `player.#` matches `player` and `player.3.health`.
+ *
+ * Patterns are stored in a trie keyed by segment, so a publish only visits the trie nodes on the
+ * paths that can match its topic instead of testing every subscription. The subscriptions a topic
+ * resolves to are cached per topic, and the cache is cleared whenever subscriptions change.
+ * Like Subject, it holds observers weakly: expired ones are skipped.
+ */
+class TopicSubject
+{
+public:
+    using SubscriptionId = std::uint32_t;
+
+private:
+    static constexpr std::uint32_t None = ~std::uint32_t(0);
+
+    struct TrieNode
+    {
+        std::uint32_t star = None;   /**< Child for a `*` segment */
+        std::uint32_t hash = None;   /**< Child for a trailing `#` segment */
+        std::vector<SubscriptionId> subscriptions;
+    };
+
+    struct Subscription
+    {
+        std::weak_ptr<Observer> observer;
+        std::uint32_t node;
+        bool active;
+    };
+
+    std::vector<TrieNode> nodes_;
+    std::unordered_map<std::string, std::uint32_t> segments_; /**< Interned literal segments */
+    std::unordered_map<std::uint64_t, std::uint32_t> edges_;  /**< (node << 32 | segment) -> child */
+    std::vector<Subscription> subscriptions_;
+
+    std::unordered_map<std::string, std::vector<SubscriptionId>> cache_;
+    bool caching_ = true;
+    bool cacheStale_ = false;  /**< Subscriptions changed during a publish */
+    int publishDepth_ = 0;     /**< Publishes in progress, more than one when observers publish */
+
+    /**< Scratch buffers reused by every cache miss. */
+    std::vector<std::uint32_t> topicSegments_;
+    std::vector<SubscriptionId> matches_;
+
+    TopicStats stats_;
+
+    std::uint32_t child(std::uint32_t node, const std::string& segment);
+    void match(std::uint32_t node, std::size_t depth);
+    void resolve(const std::string& topic);
+    void invalidate();
+
+public:
+    /** Topics in the cache before it is cleared, bounding its memory. */
+    static constexpr std::size_t MaxCachedTopics = 4096;
+
+    TopicSubject();
+
+    /**
+     * @brief Notifies the observer of every topic the pattern matches.
+     * @throws std::invalid_argument If the pattern has an empty segment or a `#` before the end.
+     */
+    SubscriptionId subscribe(const std::string& pattern, const std::shared_ptr<Observer>& observer);
+
+    /**
+     * @brief Removes a subscription. Unknown or already removed ids are ignored.
+     */
+    void unsubscribe(SubscriptionId id);
+
+    /**
+     * @brief Notifies every observer subscribed to a pattern that matches the topic.
+     */
+    void publish(const std::string& topic, int value);
+
+    /**
+     * @brief Number of active subscriptions matching the topic.
+     */
+    std::size_t countMatches(const std::string& topic);
+
+    /**
+     * @brief Enables or disables the per-topic match cache (enabled by default).
+     */
+    void setCaching(bool enabled);
+
+    const TopicStats& getStats() const { return stats_; }
+    void resetStats() { stats_ = TopicStats(); }
+};
+
+#endif
@@ -10,6 +10,16 @@
  * - The `Subject` class maintains a list of observers and notifies them when the state changes.
  * - The `Observer` class defines an abstract interface for all concrete observers.
  * - Concrete observers, such as `HealthUI`, `ScoreUI`, and `EventLogger`, implement the `onNotify` method to respond to state changes.
+ * - `SignalGraph` derives values from observed state lazily and incrementally; `SubjectSource` feeds a subject into it.
+ * - `Mailbox` stands between a subject and a slow observer, delivering only the latest value once per frame or at a limited rate.
+ * - `AggregateObserver` keeps running statistics of the values it observes (mean, quantiles, most frequent values) instead of logging them.
+ * - `EventBus` dispatches typed events such as `LevelUp` through subscriber lists indexed by ids assigned at compile time by an `EventList`.
+ * - `EventTree` captures and bubbles events through parent/child entities, such as a weapon held by a player in a vehicle.
+ * - `PayloadSubject` publishes large payloads allocated in a per-frame `FrameArena`, shared by every observer instead of copied.
+ * - `HealthUI` and `ScoreUI` are `HudWidget`s: repainted into their own texture only when notified, and the frame is presented only when one changed.
+ * - `ShardedSubject` spreads tens of thousands of observers of a global event over shards notified on worker threads.
+ * - `SlotSubject` tracks observers through a generational `SlotTable` instead of `weak_ptr`, checking liveness with a plain load.
+ * - `TopicSubject` routes events by topic names such as `enemy.3.death` to observers subscribed with `*`/`#` patterns.
  * 
  * @usage
  * The Observer pattern is typically used in situations where multiple components or modules need to react to state changes
@@ -32,130 +42,48 @@
 
 
 
+#include <algorithm>
+#include <ctime>
 #include <iostream>
 #include <memory>
+#include <string>
+#include <vector>
 #include <SDL2/SDL.h>
 
-/**
- * @class Observer
- * @brief Abstract base class for all observers in the observer pattern.
- *
- * Defines the interface for objects that need to be notified when the state of the subject changes.
- */
-class Observer : public std::enable_shared_from_this<Observer> 
-{
-    friend class Subject;
-
-public:
-    Observer() = default;
-    virtual ~Observer() = default;
-
-    /**
-     * @brief Virtual function to handle state notifications.
-     * @param value The updated state value.
-     */
-    virtual void onNotify(int value) = 0;
-
-private:
-    /**< Pointer to the next observer in the chain */
-    std::weak_ptr<Observer> next_;
-};
+#include "Observer.h"
+#include "Aggregates.h"
+#include "EventRegistry.h"
+#include "EventTree.h"
+#include "FrameArena.h"
+#include "Hud.h"
+#include "Mailbox.h"
+#include "PayloadSubject.h"
+#include "ShardedSubject.h"
+#include "Signal.h"
+#include "SlotTable.h"
+#include "TopicSubject.h"
 
 /**
- * @class Subject
- * @brief Represents the subject in the observer pattern.
- *
- * Manages a list of observers and notifies them of state changes.
+ * @class HealthUI
+ * @brief Concrete observer for updating health-related UI: a health bar and its value.
  */
-class Subject 
+class HealthUI : public HudWidget 
 {
 private:
-    std::weak_ptr<Observer> head_; /**< Head of the linked list of observers */
-    int state_; /**< Current state value of the subject */
-
-public:
-    Subject() : state_(0) 
-    {
-        std::cout << "Subject constructor called" << std::endl;
-    }
+    int health_ = 0;
 
-    ~Subject() 
+protected:
+    void paint(SDL_Renderer* renderer) override
     {
-        std::cout << "Subject destructor called" << std::endl;
+        SDL_Rect bar = {0, 8, std::min(std::max(health_, 0), 200), 24};
+        SDL_SetRenderDrawColor(renderer, 200, 40, 40, 255);
+        SDL_RenderFillRect(renderer, &bar);
+        SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+        drawNumber(renderer, health_, getWidth(), 4, 32);
     }
 
-    /**
-     * @brief Adds a new observer to the subject.
-     * @param observer Shared pointer to the observer to be added.
-     */
-    void addObserver(const std::shared_ptr<Observer>& observer) 
-    {
-        if (auto currentHead = head_.lock()) 
-        {
-            observer->next_ = currentHead;
-        }
-        head_ = observer;
-    }
-
-    /**
-     * @brief Removes an observer from the subject.
-     * @param observer Shared pointer to the observer to be removed.
-     */
-    void removeObserver(const std::shared_ptr<Observer>& observer) 
-    {
-        auto currentHead = head_.lock();
-        if (!currentHead) return;
-
-        if (currentHead == observer) 
-        {
-            head_ = currentHead->next_;
-            return;
-        }
-
-        auto current = currentHead;
-        while (current) 
-        {
-            if (auto next = current->next_.lock(); next == observer) 
-            {
-                current->next_ = next->next_;
-                return;
-            }
-            current = current->next_.lock();
-        }
-    }
-
-    /**
-     * @brief Sets the state of the subject and notifies all observers.
-     * @param newState The new state value.
-     */
-    void setState(int newState) 
-    {
-        state_ = newState;
-        notifyObservers();
-    }
-
-    /**
-     * @brief Notifies all observers of the current state.
-     */
-    void notifyObservers() 
-    {
-        auto current = head_.lock();
-        while (current) 
-        {
-            current->onNotify(state_);
-            current = current->next_.lock();
-        }
-    }
-};
-
-/**
- * @class HealthUI
- * @brief Concrete observer for updating health-related UI.
- */
-class HealthUI : public Observer 
-{
 public:
-    HealthUI() 
+    HealthUI() : HudWidget(320, 40)
     {
         std::cout << "Health UI constructor called" << std::endl;
     }
@@ -168,6 +96,8 @@ public:
     void onNotify(int value) override 
     {
         std::cout << "[Health UI] Player health updated to: " << value << std::endl;
+        health_ = value;
+        markDirty();
     }
 };
 
@@ -175,10 +105,20 @@ public:
  * @class ScoreUI
  * @brief Concrete observer for updating score-related UI.
  */
-class ScoreUI : public Observer 
+class ScoreUI : public HudWidget 
 {
+private:
+    int score_ = 0;
+
+protected:
+    void paint(SDL_Renderer* renderer) override
+    {
+        SDL_SetRenderDrawColor(renderer, 250, 210, 60, 255);
+        drawNumber(renderer, score_, getWidth(), 4, 32);
+    }
+
 public:
-    ScoreUI() 
+    ScoreUI() : HudWidget(320, 40)
     {
         std::cout << "Score UI constructor called" << std::endl;
     }
@@ -191,6 +131,8 @@ public:
     void onNotify(int value) override 
     {
         std::cout << "[Score UI] Player score updated to: " << value * 10 << " points" << std::endl;
+        score_ = value * 10;
+        markDirty();
     }
 };
 
@@ -207,6 +149,90 @@ public:
     }
 };
 
+/**
+ * @class TickCounter
+ * @brief Concrete observer standing for one of many components reacting to a global tick.
+ */
+class TickCounter : public Observer 
+{
+public:
+    int ticks = 0;
+
+    void onNotify(int) override 
+    {
+        ++ticks;
+    }
+};
+
+/**
+ * @struct Collision
+ * @brief Event payload too large for onNotify(int): the contacts between two entities.
+ */
+struct Collision
+{
+    int first;
+    int second;
+    int contactCount;
+    float contactDepths[16];
+};
+
+/**
+ * @class CollisionLogger
+ * @brief Concrete observer for logging collisions, reading the payload in place.
+ */
+class CollisionLogger : public PayloadObserver<Collision>
+{
+public:
+    void onEvent(ArenaRef<Collision> collision) override
+    {
+        std::cout << "[Collision Logger] Entities " << collision->first << " and " << collision->second
+                  << " touch at " << collision->contactCount << " points" << std::endl;
+    }
+};
+
+/**
+ * @struct LevelUp
+ * @brief Typed event: the player reached a new level.
+ */
+struct LevelUp
+{
+    int level;
+};
+
+/**
+ * @struct ItemPicked
+ * @brief Typed event: the player picked up an item.
+ */
+struct ItemPicked
+{
+    int itemId;
+};
+
+/** Every typed event of the game; ids follow this order. */
+using GameEvents = EventList<LevelUp, ItemPicked>;
+static_assert(GameEvents::idOf<LevelUp>() == 0 && GameEvents::idOf<ItemPicked>() == 1, "event ids must be dense");
+
+/**
+ * @class AchievementTracker
+ * @brief Concrete observer of several typed events.
+ */
+class AchievementTracker : public EventObserver<LevelUp>, public EventObserver<ItemPicked>
+{
+private:
+    int items_ = 0;
+
+public:
+    void onEvent(const LevelUp& levelUp) override
+    {
+        std::cout << "[Achievements] Reached level " << levelUp.level << std::endl;
+    }
+
+    void onEvent(const ItemPicked& item) override
+    {
+        std::cout << "[Achievements] Item " << item.itemId << " picked, " << ++items_ << " so far" << std::endl;
+    }
+};
+
 /**
  * @brief Main function to initialize SDL and run the observer pattern example.
  *
@@ -247,24 +273,116 @@ int main(int argc, char* argv[])
     auto scoreUI = std::make_shared<ScoreUI>();
     auto logger = std::make_shared<EventLogger>();
 
-    subject->addObserver(healthUI);
-    subject->addObserver(scoreUI);
+    // The UI only needs the latest value once per frame, not every intermediate state.
+    MailboxSet mailboxes;
+    subject->addObserver(mailboxes.add(healthUI, DeliveryPolicy::latestPerFrame()));
+    subject->addObserver(mailboxes.add(scoreUI, DeliveryPolicy::maxRate(4.0)));
     subject->addObserver(logger);
 
+    // Analytics aggregate the states as they come rather than from the log afterwards.
+    auto stateStats = std::make_shared<AggregateObserver>();
+    subject->addObserver(stateStats);
+
+    // Derived values: the score multiplier is recomputed only when health or combo changed, and
+    // at most once per frame no matter how many times they changed.
+    SignalGraph signals;
+    auto health = std::make_shared<SubjectSource>(signals, 0);
+    subject->addObserver(health);
+    SignalGraph::NodeId combo = signals.addSource(1);
+    SignalGraph::NodeId multiplier = signals.addComputed({health->node(), combo}, [](const double* inputs, std::size_t)
+    {
+        return (inputs[0] > 50 ? 2.0 : 1.0) * inputs[1];
+    });
+    signals.addEffect(multiplier, [](double value)
+    {
+        std::cout << "[Signals] Score multiplier is now x" << value << std::endl;
+    });
+
+    // Topic routing: the logger only hears about enemy deaths, whichever enemy it was.
+    TopicSubject topics;
+    topics.subscribe("enemy.*.death", logger);
+
+    // Entity hierarchy: a shot fired by the weapon bubbles up to the player and the vehicle.
+    EventTree entities;
+    EventTree::NodeId vehicle = entities.addNode();
+    EventTree::NodeId player = entities.addNode(vehicle);
+    EventTree::NodeId weapon = entities.addNode(player);
+    entities.addListener(player, false, [](TreeEvent& shot)
+    {
+        std::cout << "[Tree] Player fired, ammo left: " << shot.value << std::endl;
+    });
+    entities.addListener(vehicle, false, [](TreeEvent& shot)
+    {
+        std::cout << "[Tree] Vehicle shakes from recoil of node " << shot.target << std::endl;
+    });
+
+    // Large payloads live in an arena that is reset every frame.
+    FrameArena frameArena;
+    PayloadSubject<Collision> collisions;
+    auto collisionLogger = std::make_shared<CollisionLogger>();
+    collisions.addObserver(collisionLogger);
+
+    // Typed events, each type resolved to its subscribers by a compile-time id.
+    EventBus<GameEvents> gameEvents;
+    auto achievements = std::make_shared<AchievementTracker>();
+    gameEvents.addObserver<LevelUp>(achievements);
+    gameEvents.addObserver<ItemPicked>(achievements);
+
+    // A global tick with a large fan-out, notified from several threads.
+    ShardedSubject ticks;
+    std::vector<std::shared_ptr<TickCounter>> tickCounters;
+    for (int i = 0; i < 20000; ++i)
+    {
+        tickCounters.push_back(std::make_shared<TickCounter>());
+        ticks.addObserver(tickCounters.back());
+    }
+
+    // Pause events reach the logger through a slot table rather than weak_ptr.
+    SlotTable observerSlots;
+    SlotSubject pauses(observerSlots);
+    SlotRegistration loggerSlot(observerSlots, logger.get());
+    pauses.addObserver(loggerSlot.handle());
+
+    // Retained-mode HUD: nothing is drawn unless a widget changed.
+    Hud hud;
+    hud.add(healthUI, 20, 20);
+    hud.add(scoreUI, 20, 70);
+
     bool running = true;
     SDL_Event event;
 
     int counter = 100;
 
+    const Uint32 startTicks = SDL_GetTicks();
+    const std::clock_t startClock = std::clock();
+
     while (running) 
     {
-        while (SDL_PollEvent(&event)) 
+        // With nothing new to show, sleep until an event arrives, waking up now and then for the
+        // mailboxes that deliver at a limited rate.
+        bool hasEvent = hud.needsPresent() ? SDL_PollEvent(&event) : SDL_WaitEventTimeout(&event, 50);
+        for (; hasEvent; hasEvent = SDL_PollEvent(&event)) 
         {
             if (event.type == SDL_QUIT) 
             {
                 running = false;
             }
 
+            if (event.type == SDL_WINDOWEVENT) 
+            {
+                hud.invalidate(false);
+            }
+
+            if (event.type == SDL_RENDER_TARGETS_RESET) 
+            {
+                hud.invalidate(true);
+            }
+
+            if (event.type == SDL_RENDER_DEVICE_RESET) 
+            {
+                hud.releaseTextures();
+            }
+
             if (event.type == SDL_KEYDOWN) 
             {
                 switch (event.key.keysym.sym) 
@@ -279,17 +397,66 @@ int main(int argc, char* argv[])
                     case SDLK_h:
                         subject->setState(--counter);
                         break;
+                    case SDLK_c:
+                        signals.set(combo, signals.get(combo) + 1);
+                        break;
+                    case SDLK_f:
+                        entities.dispatch(weapon, counter);
+                        break;
+                    case SDLK_k:
+                        collisions.publish(frameArena.make<Collision>(Collision{1, counter, counter % 16 + 1, {}}));
+                        break;
+                    case SDLK_l:
+                        gameEvents.publish(LevelUp{counter / 10});
+                        break;
+                    case SDLK_i:
+                        gameEvents.publish(ItemPicked{counter});
+                        break;
+                    case SDLK_t:
+                    {
+                        Uint64 start = SDL_GetPerformanceCounter();
+                        ticks.setState(counter);
+                        std::cout << "[Ticks] " << ticks.size() << " observers ticked in "
+                                  << 1000.0 * (SDL_GetPerformanceCounter() - start) / SDL_GetPerformanceFrequency() << " ms" << std::endl;
+                        break;
+                    }
+                    case SDLK_p:
+                        pauses.setState(counter);
+                        break;
+                    case SDLK_e:
+                        topics.publish("enemy." + std::to_string(counter % 4) + ".death", counter);
+                        break;
                     default:
                         break;
                 }
             }
         }
 
-        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-        SDL_RenderClear(renderer);
-        SDL_RenderPresent(renderer);
+        mailboxes.deliver(SDL_GetTicks());
+        signals.flush();
+
+        if (hud.needsPresent()) 
+        {
+            hud.render(renderer);
+        }
+
+        frameArena.reset();
     }
 
+    mailboxes.printReport();
+    stateStats->flush();
+    stateStats->snapshot().printReport("subject states");
+
+    const double seconds = (SDL_GetTicks() - startTicks) / 1000.0;
+    const double cpuSeconds = static_cast<double>(std::clock() - startClock) / CLOCKS_PER_SEC;
+    const HudStats& hudStats = hud.getStats();
+    std::cout << "[HUD] " << hudStats.framesPresented << " frames presented, " << hudStats.widgetsRasterized
+              << " widget repaints, " << (hudStats.framesPresented ? hudStats.drawSeconds * 1000.0 / hudStats.framesPresented : 0.0)
+              << " ms per update frame, CPU " << (seconds > 0.0 ? 100.0 * cpuSeconds / seconds : 0.0) << "% over " << seconds << " s" << std::endl;
+
+    // hud and the healthUI/scoreUI locals keep the widgets alive past this point (the mailboxes only
+    // hold weak_ptr), so their textures must be released before the renderer is destroyed.
+    hud.releaseTextures();
     SDL_DestroyRenderer(renderer);
     SDL_DestroyWindow(window);
     SDL_Quit();
@@ -0,0 +1,194 @@
+/**
+ * @file clone_bench.cpp
+ * @brief Clones per second of a bullet prototype, through GameObject::clone and through CloneBuffer.
+ *
+ * Each round clones 1M bullets at different positions, then throws them away:
+ * - before: virtual clone into new, with the constructor printing a line, as Bullet used to
+ *   (the output goes to a stream that discards it, so only its formatting is counted);
+ * - virtual clone into new, with Bullet's constructor as it is now;
+ * - CloneBuffer of a type with its own copy constructor;
+ * - CloneBuffer of BulletData, which is trivially copyable.
+ * The positions are patched in a second pass in both CloneBuffer cases. Every way must produce
+ * the same bullets.
+ *
+ * Build and run from the Prototype directory:
+ * @code
+ * make bench && ./bench/clone_bench
+ * @endcode
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <streambuf>
+#include <vector>
+
+#include "CloneBuffer.h"
+#include "GameObject.h"
+
+namespace
+{
+    constexpr std::size_t CloneCount = 1000000;
+    constexpr int Rounds = 10;
+
+    /**
+     * @brief Bullet as it was: a constructor with a side effect.
+     */
+    class PrintingBullet : public GameObject
+    {
+    private:
+        BulletData data;
+
+    public:
+        PrintingBullet(int startX, int startY, int speed) : data{startX, startY, speed}
+        {
+            std::cout << "Bullet constructor called" << std::endl;
+        }
+
+        GameObject* clone(int newX, int newY) const override
+        {
+            return new PrintingBullet(newX, newY, data.speed);
+        }
+
+        void render(SDL_Renderer* renderer) const override
+        {
+            data.render(renderer);
+        }
+
+        const BulletData& getData() const { return data; }
+    };
+
+    /**
+     * @brief BulletData made not trivially copyable, so CloneBuffer calls its copy constructor.
+     */
+    struct CopiedBullet : BulletData
+    {
+        CopiedBullet(const BulletData& data) : BulletData(data) {}
+        CopiedBullet(const CopiedBullet& other) : BulletData(other) {}
+    };
+
+    class DiscardBuffer : public std::streambuf
+    {
+    protected:
+        int overflow(int c) override { return c; }
+        std::streamsize xsputn(const char*, std::streamsize count) override { return count; }
+    };
+
+    double millisecondsSince(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    std::uint64_t checksum(const BulletData& bullet)
+    {
+        return static_cast<std::uint64_t>(bullet.x) * 3 + static_cast<std::uint64_t>(bullet.y) * 5 + bullet.speed;
+    }
+
+    template <typename Prototype>
+    std::uint64_t cloneVirtual(const Prototype& prototype, const std::vector<SDL_Point>& positions, std::vector<GameObject*>& clones)
+    {
+        std::uint64_t sum = 0;
+        for (const SDL_Point& position : positions)
+        {
+            clones.push_back(prototype.clone(position.x, position.y));
+        }
+        for (GameObject* clone : clones)
+        {
+            sum += checksum(static_cast<Prototype*>(clone)->getData());
+            delete clone;
+        }
+        clones.clear();
+        return sum;
+    }
+
+    template <typename T>
+    std::uint64_t cloneBuffered(CloneBuffer<T>& buffer, const T& prototype, const std::vector<SDL_Point>& positions)
+    {
+        std::uint64_t sum = 0;
+        buffer.cloneMany(prototype, positions.size(), [&positions](T& clone, std::size_t i)
+        {
+            clone.x = positions[i].x;
+            clone.y = positions[i].y;
+        });
+        for (const T& clone : buffer)
+        {
+            sum += checksum(clone);
+        }
+        buffer.clear();
+        return sum;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    (void)argc;
+    (void)argv;
+
+    std::vector<SDL_Point> positions;
+    for (std::size_t i = 0; i < CloneCount; ++i)
+    {
+        positions.push_back({static_cast<int>(i % 640), static_cast<int>(480 + i % 97)});
+    }
+    std::vector<GameObject*> clones;
+    clones.reserve(CloneCount);
+
+    const char* names[] = {"virtual clone, printing constructor", "virtual clone", "CloneBuffer, copy constructor",
+                           "CloneBuffer, trivially copyable"};
+    double times[4];
+    std::uint64_t sums[4] = {};
+
+    {
+        DiscardBuffer discard;
+        std::streambuf* console = std::cout.rdbuf(&discard);
+        PrintingBullet prototype(320, 480, 5);
+        auto start = std::chrono::steady_clock::now();
+        for (int round = 0; round < Rounds; ++round)
+        {
+            sums[0] += cloneVirtual(prototype, positions, clones);
+        }
+        times[0] = millisecondsSince(start);
+        std::cout.rdbuf(console);
+    }
+    {
+        Bullet prototype(320, 480, 5);
+        auto start = std::chrono::steady_clock::now();
+        for (int round = 0; round < Rounds; ++round)
+        {
+            sums[1] += cloneVirtual(prototype, positions, clones);
+        }
+        times[1] = millisecondsSince(start);
+    }
+    {
+        CloneBuffer<CopiedBullet> buffer;
+        static_assert(!CloneBuffer<CopiedBullet>::BlockCopy, "a user-provided copy constructor rules out memcpy");
+        const CopiedBullet prototype(BulletData{320, 480, 5});
+        auto start = std::chrono::steady_clock::now();
+        for (int round = 0; round < Rounds; ++round)
+        {
+            sums[2] += cloneBuffered(buffer, prototype, positions);
+        }
+        times[2] = millisecondsSince(start);
+    }
+    {
+        CloneBuffer<BulletData> buffer;
+        static_assert(CloneBuffer<BulletData>::BlockCopy, "BulletData is trivially copyable");
+        const BulletData prototype{320, 480, 5};
+        auto start = std::chrono::steady_clock::now();
+        for (int round = 0; round < Rounds; ++round)
+        {
+            sums[3] += cloneBuffered(buffer, prototype, positions);
+        }
+        times[3] = millisecondsSince(start);
+    }
+
+    const double total = static_cast<double>(CloneCount) * Rounds;
+    for (int mode = 0; mode < 4; ++mode)
+    {
+        std::cout << names[mode] << ": " << total / times[mode] / 1000.0 << "M clones/s (" << times[0] / times[mode]
+                  << "x)" << std::endl;
+    }
+
+    const bool consistent = sums[0] == sums[1] && sums[1] == sums[2] && sums[2] == sums[3];
+    std::cout << "clones " << (consistent ? "match" : "DIFFER") << std::endl;
+    return consistent ? 0 : 1;
+}
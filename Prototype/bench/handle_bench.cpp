@@ -0,0 +1,186 @@
+/**
+ * @file handle_bench.cpp
+ * @brief Cost of resolving references to pooled bullets: generational handles against the alternatives.
+ *
+ * 1M bullets are cloned into a pool, then one in ten is removed and its slot reused by a new
+ * clone, leaving the references to the removed ones stale. Every reference is then resolved,
+ * in clone order and in random order, through:
+ * - raw pointers, which cannot tell a recycled bullet from the one they pointed to;
+ * - 32-bit and 64-bit handles into a HandlePool;
+ * - weak_ptr to bullets owned by shared_ptr;
+ * - ids looked up in an unordered_map.
+ * All but raw pointers must find the same live bullets.
+ *
+ * Build and run from the Prototype directory:
+ * @code
+ * make bench && ./bench/handle_bench
+ * @endcode
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include "GameObject.h"
+#include "HandlePool.h"
+
+namespace
+{
+    constexpr std::size_t BulletCount = 1000000;
+    constexpr int Rounds = 20;
+
+    double millisecondsSince(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    /**
+     * @brief Resolves every reference Rounds times; returns the milliseconds taken and counts what was found.
+     */
+    template <typename Reference, typename Resolve>
+    double timeResolves(const std::vector<Reference>& references, Resolve resolve, std::uint64_t& found, std::uint64_t& sum)
+    {
+        found = 0;
+        sum = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int round = 0; round < Rounds; ++round)
+        {
+            for (const Reference& reference : references)
+            {
+                if (const BulletData* bullet = resolve(reference))
+                {
+                    ++found;
+                    sum += static_cast<std::uint64_t>(bullet->y);
+                }
+            }
+        }
+        return millisecondsSince(start);
+    }
+
+    /**
+     * @brief Same references to each container, in the order of order.
+     */
+    template <typename Reference>
+    std::vector<Reference> reorder(const std::vector<Reference>& references, const std::vector<std::size_t>& order)
+    {
+        std::vector<Reference> reordered;
+        reordered.reserve(order.size());
+        for (std::size_t index : order)
+        {
+            reordered.push_back(references[index]);
+        }
+        return reordered;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    (void)argc;
+    (void)argv;
+
+    HandlePool<BulletData, Handle32> pool32;
+    HandlePool<BulletData, Handle64> pool64;
+    std::vector<BulletData> raw(BulletCount);
+    std::vector<std::shared_ptr<BulletData>> owned;
+    std::unordered_map<std::uint32_t, BulletData> byId;
+
+    std::vector<Handle32> handles32;
+    std::vector<Handle64> handles64;
+    std::vector<BulletData*> pointers;
+    std::vector<std::weak_ptr<BulletData>> weak;
+    std::vector<std::uint32_t> ids;
+
+    const BulletData prototype = {0, 480, 5};
+    for (std::size_t i = 0; i < BulletCount; ++i)
+    {
+        BulletData clone = prototype;
+        clone.x = static_cast<int>(i % 640);
+        clone.y = static_cast<int>(i);
+        handles32.push_back(pool32.add(clone));
+        handles64.push_back(pool64.add(clone));
+        raw[i] = clone;
+        pointers.push_back(&raw[i]);
+        owned.push_back(std::make_shared<BulletData>(clone));
+        weak.push_back(owned.back());
+        byId.emplace(static_cast<std::uint32_t>(i), clone);
+        ids.push_back(static_cast<std::uint32_t>(i));
+    }
+
+    // One in ten dies and its slot goes to a new clone at once.
+    std::uint64_t recycled = 0;
+    for (std::size_t i = 0; i < BulletCount; i += 10)
+    {
+        BulletData clone = prototype;
+        clone.y = -1;
+        pool32.remove(handles32[i]);
+        pool32.add(clone);
+        pool64.remove(handles64[i]);
+        pool64.add(clone);
+        raw[i] = clone;
+        owned[i] = std::make_shared<BulletData>(clone);
+        byId.erase(static_cast<std::uint32_t>(i));
+        byId.emplace(static_cast<std::uint32_t>(BulletCount + i), clone);
+        ++recycled;
+    }
+
+    std::vector<std::size_t> shuffled(BulletCount);
+    for (std::size_t i = 0; i < BulletCount; ++i)
+    {
+        shuffled[i] = i;
+    }
+    std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937(11));
+
+    bool consistent = true;
+    const double resolves = static_cast<double>(BulletCount) * Rounds;
+    std::cout << "order       raw pointer  handle32  handle64  weak_ptr  unordered_map  (ns per resolve)" << std::endl;
+    for (int random = 0; random < 2; ++random)
+    {
+        std::vector<std::size_t> order(BulletCount);
+        for (std::size_t i = 0; i < BulletCount; ++i)
+        {
+            order[i] = random ? shuffled[i] : i;
+        }
+        const auto orderedPointers = reorder(pointers, order);
+        const auto ordered32 = reorder(handles32, order);
+        const auto ordered64 = reorder(handles64, order);
+        const auto orderedWeak = reorder(weak, order);
+        const auto orderedIds = reorder(ids, order);
+
+        std::uint64_t found[5], sums[5];
+        double times[5];
+        times[0] = timeResolves(orderedPointers, [](BulletData* bullet) -> const BulletData* { return bullet; }, found[0], sums[0]);
+        times[1] = timeResolves(ordered32, [&pool32](Handle32 handle) -> const BulletData* { return pool32.resolve(handle); }, found[1], sums[1]);
+        times[2] = timeResolves(ordered64, [&pool64](Handle64 handle) -> const BulletData* { return pool64.resolve(handle); }, found[2], sums[2]);
+        times[3] = timeResolves(orderedWeak, [](const std::weak_ptr<BulletData>& bullet) -> const BulletData*
+        {
+            // Only the check is timed: the bullet outlives the shared_ptr returned by lock().
+            return bullet.lock().get();
+        }, found[3], sums[3]);
+        times[4] = timeResolves(orderedIds, [&byId](std::uint32_t id) -> const BulletData*
+        {
+            auto entry = byId.find(id);
+            return entry == byId.end() ? nullptr : &entry->second;
+        }, found[4], sums[4]);
+
+        for (int mode = 2; mode < 5; ++mode)
+        {
+            consistent = consistent && found[mode] == found[1] && sums[mode] == sums[1];
+        }
+        consistent = consistent && found[1] == (BulletCount - recycled) * Rounds;
+
+        std::cout << (random ? "random " : "clone  ");
+        for (double time : times)
+        {
+            std::cout << "  " << time * 1e6 / resolves;
+        }
+        std::cout << "  (raw pointers read " << (found[0] - found[1]) / Rounds << " recycled bullets)" << std::endl;
+    }
+
+    std::cout << "live bullets " << (consistent ? "match" : "DIFFER") << std::endl;
+    return consistent ? 0 : 1;
+}
@@ -0,0 +1,179 @@
+/**
+ * @file inheritance_bench.cpp
+ * @brief Cost of cloning a prototype at the end of an inheritance chain, resolving the chain on
+ * every clone against copying the template PrototypeRegistry flattened, and cost of re-flattening.
+ *
+ * For chains of 1 to 8 prototypes, each overriding a field of its parent, each round clones the
+ * last one 1M times into the same array, then patches the position:
+ * - resolved: walks from the prototype up to its root, taking each field from the nearest
+ *   prototype that overrides it, as a registry without flattening would on every clone;
+ * - flattened: copies the template.
+ * Both must give the same bullets. Then, in a tree of prototypes 4 wide and 7 deep, one prototype
+ * at each depth is redefined, which must re-flatten exactly it and its descendants.
+ *
+ * Build and run from the Prototype directory:
+ * @code
+ * make bench && ./bench/inheritance_bench
+ * @endcode
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "PrototypeRegistry.h"
+
+namespace
+{
+    constexpr std::size_t CloneCount = 1000000;
+    constexpr int Rounds = 10;
+    constexpr int MaxDepth = 8;
+    constexpr int TreeWidth = 4;
+    constexpr int TreeDepth = 7;
+
+    double millisecondsSince(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    /**
+     * @brief The prototype as it would be without flattening: every field from the nearest
+     * prototype of the chain overriding it, or BulletData's default.
+     */
+    BulletData resolve(const PrototypeRegistry& registry, std::uint32_t id)
+    {
+        BulletData bullet = {0, 0, 0};
+        bool speed = false, width = false, height = false, damage = false, color = false;
+        for (; id != PrototypeRegistry::NoParent; id = registry.getParent(id))
+        {
+            const PrototypeDefinition& definition = registry.getDefinition(id);
+            if (!speed && definition.speed) { bullet.speed = *definition.speed; speed = true; }
+            if (!width && definition.width) { bullet.width = *definition.width; width = true; }
+            if (!height && definition.height) { bullet.height = *definition.height; height = true; }
+            if (!damage && definition.damage) { bullet.damage = *definition.damage; damage = true; }
+            if (!color && definition.color) { bullet.color = *definition.color; color = true; }
+        }
+        return bullet;
+    }
+
+    /**
+     * @brief The depth-th prototype of a chain, which overrides one field in turn.
+     */
+    PrototypeDefinition chainLink(int depth)
+    {
+        PrototypeDefinition definition;
+        if (depth > 0)
+        {
+            definition.parent = "chain" + std::to_string(depth - 1);
+        }
+        switch (depth % 5)
+        {
+            case 0: definition.speed = 3 + depth; break;
+            case 1: definition.width = 10 + depth; break;
+            case 2: definition.height = 20 + depth; break;
+            case 3: definition.damage = 1 + depth; break;
+            default: definition.color = SDL_Color{static_cast<Uint8>(depth * 30), 0, 255, 255}; break;
+        }
+        return definition;
+    }
+
+    std::string nodeName(int depth, int index)
+    {
+        return "node" + std::to_string(depth) + "." + std::to_string(index);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    (void)argc;
+    (void)argv;
+
+    std::vector<BulletData> clones(CloneCount);
+    bool same = true;
+
+    std::cout << "clones per round: " << CloneCount << ", rounds: " << Rounds << std::endl;
+    std::cout << "depth  resolved(ns/clone)  flattened(ns/clone)  speedup" << std::endl;
+
+    PrototypeRegistry chain;
+    for (int depth = 0; depth < MaxDepth; ++depth)
+    {
+        const std::uint32_t id = chain.define("chain" + std::to_string(depth), chainLink(depth));
+
+        auto start = std::chrono::steady_clock::now();
+        for (int round = 0; round < Rounds; ++round)
+        {
+            for (std::size_t i = 0; i < CloneCount; ++i)
+            {
+                clones[i] = resolve(chain, id);
+                clones[i].x = static_cast<int>(i);
+            }
+        }
+        const double resolved = millisecondsSince(start);
+        const std::vector<BulletData> expected = clones;
+
+        start = std::chrono::steady_clock::now();
+        for (int round = 0; round < Rounds; ++round)
+        {
+            for (std::size_t i = 0; i < CloneCount; ++i)
+            {
+                clones[i] = chain.getTemplate(id);
+                clones[i].x = static_cast<int>(i);
+            }
+        }
+        const double flattened = millisecondsSince(start);
+        same = same && std::memcmp(expected.data(), clones.data(), CloneCount * sizeof(BulletData)) == 0;
+
+        const double perClone = 1e6 / (static_cast<double>(CloneCount) * Rounds);
+        std::cout << depth + 1 << "  " << resolved * perClone << "  " << flattened * perClone << "  "
+                  << resolved / flattened << "x" << std::endl;
+    }
+
+    // Every node overrides its damage; the roots' speed and colour reach every descendant.
+    PrototypeRegistry tree;
+    int nodes = 1;
+    for (int depth = 0; depth < TreeDepth; ++depth, nodes *= TreeWidth)
+    {
+        for (int index = 0; index < nodes; ++index)
+        {
+            PrototypeDefinition definition;
+            if (depth == 0)
+            {
+                definition.speed = 3;
+                definition.color = SDL_Color{255, 0, 0, 255};
+            }
+            else
+            {
+                definition.parent = nodeName(depth - 1, index / TreeWidth);
+            }
+            definition.damage = depth;
+            tree.define(nodeName(depth, index), definition);
+        }
+    }
+
+    std::cout << "tree of " << tree.size() << " prototypes" << std::endl;
+    std::cout << "redefined depth  re-flattened  time(us)" << std::endl;
+
+    const std::uint32_t deepest = tree.idOf(nodeName(TreeDepth - 1, 0));
+    std::size_t expectedCount = tree.size();
+    for (int depth = 0; depth < TreeDepth; ++depth)
+    {
+        const std::uint32_t id = tree.idOf(nodeName(depth, 0));
+        PrototypeDefinition definition = tree.getDefinition(id);
+        definition.speed = 10 + depth;
+
+        auto start = std::chrono::steady_clock::now();
+        tree.define(nodeName(depth, 0), definition);
+        const double time = millisecondsSince(start);
+
+        same = same && tree.getLastFlattened() == expectedCount && tree.getTemplate(deepest).speed == 10 + depth
+               && tree.getTemplate(deepest).damage == TreeDepth - 1;
+        std::cout << depth << "  " << tree.getLastFlattened() << "  " << time * 1000.0 << std::endl;
+        expectedCount = (expectedCount - 1) / TreeWidth;
+    }
+
+    std::cout << "templates " << (same ? "match resolved chains" : "DIFFER from resolved chains") << std::endl;
+    return same ? 0 : 1;
+}
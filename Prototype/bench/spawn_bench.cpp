@@ -0,0 +1,222 @@
+/**
+ * @file spawn_bench.cpp
+ * @brief Contention benchmark of 1 to 32 threads cloning bullets: a locked shared field against SpawnBuffers.
+ *
+ * Every frame, the threads clone 64k bullets between them into a BulletField, working out each
+ * bullet's position first. Either each clone locks a mutex around the shared field, or each
+ * thread appends to its own SpawnBuffer and the main thread merges them all at the end of the
+ * frame. The time per frame covers the threads and the merge. The merged field must hold the
+ * same bullets, with the same handles, as cloning every request in thread then sequence order
+ * on one thread.
+ *
+ * Build and run from the Prototype directory:
+ * @code
+ * make bench && ./bench/spawn_bench
+ * @endcode
+ */
+
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Barrier.h"
+#include "SpawnBuffers.h"
+
+namespace
+{
+    constexpr std::size_t SpawnsPerFrame = 65536;
+    constexpr int FrameCount = 20;
+    constexpr Bounds Playfield = {0.0f, 0.0f, 1920.0f, 1080.0f};
+
+    double millisecondsSince(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    /**
+     * @brief The sequence-th request of a thread in a frame, with a little work to place it.
+     */
+    SpawnRequest makeRequest(std::size_t thread, std::size_t sequence, int frame)
+    {
+        const float angle = 0.001f * static_cast<float>(thread * 7919 + sequence);
+        const Vec2 position = {960.0f + 400.0f * std::cos(angle), 540.0f + 400.0f * std::sin(angle)};
+        return {static_cast<std::uint32_t>(sequence % 4), position, static_cast<float>(frame)};
+    }
+
+    void addPrototypes(BulletField& field)
+    {
+        field.addPrototype(Trajectory::linear({0.0f, -3.0f}, 1e9f));
+        field.addPrototype(Trajectory::linear({2.0f, 2.0f}, 1e9f));
+        field.addPrototype(Trajectory::sineWave({0.0f, 4.0f}, 20.0f, 0.05f, 1e9f));
+        field.addPrototype(Trajectory::spiral(2.0f, 0.1f, 0.0f, 1e9f));
+    }
+
+    std::uint64_t mix(std::uint64_t digest, std::uint64_t value)
+    {
+        return (digest ^ value) * 1099511628211ull;
+    }
+
+    /**
+     * @brief Milliseconds for every frame, with each thread locking the shared field per clone.
+     */
+    double runLocked(std::size_t threads)
+    {
+        BulletField field(Playfield);
+        addPrototypes(field);
+        std::mutex fieldMutex;
+        Barrier frameDone(threads + 1);
+        const std::size_t perThread = SpawnsPerFrame / threads;
+
+        std::vector<std::thread> workers;
+        for (std::size_t thread = 0; thread < threads; ++thread)
+        {
+            workers.emplace_back([&, thread]()
+            {
+                for (int frame = 0; frame < FrameCount; ++frame)
+                {
+                    for (std::size_t sequence = 0; sequence < perThread; ++sequence)
+                    {
+                        const SpawnRequest request = makeRequest(thread, sequence, frame);
+                        std::lock_guard<std::mutex> lock(fieldMutex);
+                        field.spawn(request.prototype, request.position, request.time);
+                    }
+                    frameDone.arriveAndWait();
+                }
+            });
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        for (int frame = 0; frame < FrameCount; ++frame)
+        {
+            frameDone.arriveAndWait();
+        }
+        const double time = millisecondsSince(start);
+        for (std::thread& worker : workers)
+        {
+            worker.join();
+        }
+        return time;
+    }
+
+    /**
+     * @brief Milliseconds for every frame, with each thread filling its SpawnBuffer and a merge at
+     * the end of the frame. Also gives a digest of the merged handles and positions.
+     */
+    double runBuffered(std::size_t threads, std::uint64_t& digest)
+    {
+        BulletField field(Playfield);
+        addPrototypes(field);
+        SpawnBuffers buffers(threads);
+        Barrier filled(threads + 1);
+        Barrier merged(threads + 1);
+        const std::size_t perThread = SpawnsPerFrame / threads;
+
+        std::vector<std::thread> workers;
+        for (std::size_t thread = 0; thread < threads; ++thread)
+        {
+            workers.emplace_back([&, thread]()
+            {
+                SpawnBuffer& buffer = buffers.forThread(thread);
+                for (int frame = 0; frame < FrameCount; ++frame)
+                {
+                    for (std::size_t sequence = 0; sequence < perThread; ++sequence)
+                    {
+                        const SpawnRequest request = makeRequest(thread, sequence, frame);
+                        buffer.request(request.prototype, request.position, request.time);
+                    }
+                    filled.arriveAndWait();
+                    merged.arriveAndWait();
+                }
+            });
+        }
+
+        digest = 14695981039346656037ull;
+        double time = 0.0;
+        auto start = std::chrono::steady_clock::now();
+        for (int frame = 0; frame < FrameCount; ++frame)
+        {
+            filled.arriveAndWait();
+            buffers.merge(field);
+            time += millisecondsSince(start);
+
+            // Not timed: digest of what the merge made.
+            for (std::size_t thread = 0; thread < threads; ++thread)
+            {
+                for (BulletHandle bullet : buffers.forThread(thread).getSpawned())
+                {
+                    Vec2 position;
+                    field.positionOf(bullet, static_cast<float>(frame), position);
+                    digest = mix(digest, bullet.value);
+                    digest = mix(digest, static_cast<std::uint64_t>(std::lround(position.x * 16.0f)));
+                }
+            }
+
+            start = std::chrono::steady_clock::now();
+            merged.arriveAndWait();
+        }
+        time += millisecondsSince(start);
+        for (std::thread& worker : workers)
+        {
+            worker.join();
+        }
+        return time;
+    }
+
+    /**
+     * @brief Digest of cloning every request on one thread, in thread then sequence order.
+     */
+    std::uint64_t referenceDigest(std::size_t threads)
+    {
+        BulletField field(Playfield);
+        addPrototypes(field);
+        const std::size_t perThread = SpawnsPerFrame / threads;
+        std::uint64_t digest = 14695981039346656037ull;
+        for (int frame = 0; frame < FrameCount; ++frame)
+        {
+            for (std::size_t thread = 0; thread < threads; ++thread)
+            {
+                for (std::size_t sequence = 0; sequence < perThread; ++sequence)
+                {
+                    const SpawnRequest request = makeRequest(thread, sequence, frame);
+                    const BulletHandle bullet = field.spawn(request.prototype, request.position, request.time);
+                    Vec2 position;
+                    field.positionOf(bullet, static_cast<float>(frame), position);
+                    digest = mix(digest, bullet.value);
+                    digest = mix(digest, static_cast<std::uint64_t>(std::lround(position.x * 16.0f)));
+                }
+            }
+        }
+        return digest;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    (void)argc;
+    (void)argv;
+
+    std::cout << "hardware threads: " << std::thread::hardware_concurrency() << ", clones per frame: " << SpawnsPerFrame
+              << ", frames: " << FrameCount << std::endl;
+    std::cout << "threads  locked(ms/frame)  buffered(ms/frame)  speedup  buffered(M clones/s)" << std::endl;
+
+    bool deterministic = true;
+    for (std::size_t threads : {1, 2, 4, 8, 16, 32})
+    {
+        const double locked = runLocked(threads);
+        std::uint64_t digest = 0;
+        const double buffered = runBuffered(threads, digest);
+        deterministic = deterministic && digest == referenceDigest(threads);
+
+        const double clones = static_cast<double>(SpawnsPerFrame / threads * threads) * FrameCount;
+        std::cout << threads << "  " << locked / FrameCount << "  " << buffered / FrameCount << "  " << locked / buffered
+                  << "x  " << clones / buffered / 1000.0 << std::endl;
+    }
+
+    std::cout << "merges " << (deterministic ? "deterministic" : "DIFFER from thread order") << std::endl;
+    return deterministic ? 0 : 1;
+}
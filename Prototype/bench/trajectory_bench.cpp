@@ -0,0 +1,193 @@
+/**
+ * @file trajectory_bench.cpp
+ * @brief Benchmark of 1M bullets moved eagerly every tick against analytic trajectories evaluated lazily.
+ *
+ * A 1920x1080 playfield, with 1M bullets spawned around and inside it, runs for a number of ticks.
+ * Each tick counts the bullets inside the playfield, as rendering would have to find them.
+ * - Straight bullets: Bullet::update on every bullet each tick, against a BulletField with
+ *   linear trajectories that only computes the positions of bullets in their window.
+ * - Mixed bullets (linear, sine-wave, spiral and Bezier): every position computed each tick,
+ *   against the same BulletField.
+ * Both ways must count the same bullets at every tick.
+ *
+ * Build and run from the Prototype directory:
+ * @code
+ * make bench && ./bench/trajectory_bench
+ * @endcode
+ */
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "GameObject.h"
+#include "Trajectory.h"
+
+namespace
+{
+    constexpr int BulletCount = 1000000;
+    constexpr int TickCount = 240;
+    constexpr Bounds Playfield = {0.0f, 0.0f, 1920.0f, 1080.0f};
+
+    double millisecondsSince(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    void report(const char* name, double eagerTime, double spawnTime, double lazyTime, std::uint64_t active)
+    {
+        std::cout << name << ": eager " << eagerTime / TickCount << " ms per tick, lazy " << lazyTime / TickCount
+                  << " ms per tick (" << eagerTime / lazyTime << "x) plus " << spawnTime << " ms to spawn, "
+                  << active / TickCount << " bullets in their window on average" << std::endl;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    (void)argc;
+    (void)argv;
+
+    std::mt19937 random(7);
+    std::uniform_real_distribution<float> spreadX(-4000.0f, 6000.0f);
+    std::uniform_real_distribution<float> spreadY(-4000.0f, 6000.0f);
+    std::uniform_int_distribution<int> speeds(1, 12);
+    bool consistent = true;
+
+    // Straight bullets, moving up by their speed every tick like Bullet::update.
+    {
+        std::vector<Bullet> eager;
+        eager.reserve(BulletCount);
+        BulletField field(Playfield);
+        std::vector<std::uint32_t> prototypes;
+        for (int speed = 0; speed <= 12; ++speed)
+        {
+            prototypes.push_back(field.addPrototype(Trajectory::linear({0.0f, static_cast<float>(-speed)}, 1e9f)));
+        }
+
+        std::vector<Vec2> spawns;
+        std::vector<int> bulletSpeeds;
+        for (int i = 0; i < BulletCount; ++i)
+        {
+            spawns.push_back({std::round(spreadX(random)), std::round(spreadY(random))});
+            bulletSpeeds.push_back(speeds(random));
+        }
+
+        for (int i = 0; i < BulletCount; ++i)
+        {
+            eager.emplace_back(static_cast<int>(spawns[i].x), static_cast<int>(spawns[i].y), bulletSpeeds[i]);
+        }
+
+        std::vector<std::uint64_t> eagerCounts(TickCount + 1), lazyCounts(TickCount + 1);
+        auto start = std::chrono::steady_clock::now();
+        for (int tick = 1; tick <= TickCount; ++tick)
+        {
+            std::uint64_t visible = 0;
+            for (Bullet& bullet : eager)
+            {
+                bullet.update();
+                visible += Playfield.contains({static_cast<float>(bullet.getX()), static_cast<float>(bullet.getY())});
+            }
+            eagerCounts[tick] = visible;
+        }
+        const double eagerTime = millisecondsSince(start);
+
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < BulletCount; ++i)
+        {
+            field.spawn(prototypes[bulletSpeeds[i]], spawns[i], 0.0f);
+        }
+        const double spawnTime = millisecondsSince(start);
+
+        std::uint64_t active = 0;
+        start = std::chrono::steady_clock::now();
+        for (int tick = 1; tick <= TickCount; ++tick)
+        {
+            const float time = static_cast<float>(tick);
+            field.advance(time);
+            std::uint64_t visible = 0;
+            for (BulletHandle bullet : field.getActive())
+            {
+                Vec2 position;
+                visible += field.positionOf(bullet, time, position) && Playfield.contains(position);
+            }
+            lazyCounts[tick] = visible;
+            active += field.activeCount();
+        }
+        const double lazyTime = millisecondsSince(start);
+
+        consistent = consistent && eagerCounts == lazyCounts;
+        report("straight", eagerTime, spawnTime, lazyTime, active);
+    }
+
+    // Mixed trajectories, with every position computed each tick in the eager case.
+    {
+        std::vector<Trajectory> trajectories = {
+            Trajectory::linear({3.0f, -5.0f}, 1e9f),
+            Trajectory::sineWave({0.0f, -6.0f}, 40.0f, 0.02f, 1e9f),
+            Trajectory::spiral(4.0f, 0.05f, 0.0f, 1e9f),
+            Trajectory::bezier({300.0f, -400.0f}, {-300.0f, -800.0f}, {0.0f, -1200.0f}, 200.0f),
+        };
+        BulletField field(Playfield);
+        for (const Trajectory& trajectory : trajectories)
+        {
+            field.addPrototype(trajectory);
+        }
+
+        std::vector<Vec2> spawns;
+        std::vector<std::uint32_t> kinds;
+        for (int i = 0; i < BulletCount; ++i)
+        {
+            spawns.push_back({spreadX(random), spreadY(random)});
+            kinds.push_back(static_cast<std::uint32_t>(i % trajectories.size()));
+        }
+
+        std::vector<std::uint64_t> eagerCounts(TickCount + 1), lazyCounts(TickCount + 1);
+        auto start = std::chrono::steady_clock::now();
+        for (int tick = 1; tick <= TickCount; ++tick)
+        {
+            const float time = static_cast<float>(tick);
+            std::uint64_t visible = 0;
+            for (int i = 0; i < BulletCount; ++i)
+            {
+                const Trajectory& trajectory = trajectories[kinds[i]];
+                if (time > trajectory.getLifetime()) continue;
+                const Vec2 offset = trajectory.offsetAt(time);
+                visible += Playfield.contains({spawns[i].x + offset.x, spawns[i].y + offset.y});
+            }
+            eagerCounts[tick] = visible;
+        }
+        const double eagerTime = millisecondsSince(start);
+
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < BulletCount; ++i)
+        {
+            field.spawn(kinds[i], spawns[i], 0.0f);
+        }
+        const double spawnTime = millisecondsSince(start);
+
+        std::uint64_t active = 0;
+        start = std::chrono::steady_clock::now();
+        for (int tick = 1; tick <= TickCount; ++tick)
+        {
+            const float time = static_cast<float>(tick);
+            field.advance(time);
+            std::uint64_t visible = 0;
+            for (BulletHandle bullet : field.getActive())
+            {
+                Vec2 position;
+                visible += field.positionOf(bullet, time, position) && Playfield.contains(position);
+            }
+            lazyCounts[tick] = visible;
+            active += field.activeCount();
+        }
+        const double lazyTime = millisecondsSince(start);
+
+        consistent = consistent && eagerCounts == lazyCounts;
+        report("mixed", eagerTime, spawnTime, lazyTime, active);
+    }
+
+    std::cout << "visible counts " << (consistent ? "match" : "DIFFER") << std::endl;
+    return consistent ? 0 : 1;
+}
@@ -0,0 +1,43 @@
+#ifndef BARRIER_H
+#define BARRIER_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+/**
+ * @class Barrier
+ * @brief Lets a fixed number of threads wait for each other, any number of times.
+ *
+ * Everything a thread wrote before arriving is visible to every thread once they are released,
+ * so long-lived workers can be handed a frame's work and hand back its results through it.
+ */
+class Barrier
+{
+private:
+    std::mutex mutex;
+    std::condition_variable allArrived;
+    std::size_t count;
+    std::size_t waiting = 0;
+    std::uint64_t generation = 0;
+
+public:
+    explicit Barrier(std::size_t count) : count(count) {}
+
+    void arriveAndWait()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        const std::uint64_t arrivedIn = generation;
+        if (++waiting == count)
+        {
+            waiting = 0;
+            ++generation;
+            allArrived.notify_all();
+            return;
+        }
+        allArrived.wait(lock, [this, arrivedIn]() { return generation != arrivedIn; });
+    }
+};
+
+#endif
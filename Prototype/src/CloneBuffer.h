@@ -0,0 +1,121 @@
+#ifndef CLONE_BUFFER_H
+#define CLONE_BUFFER_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/**
+ * @class CloneBuffer
+ * @brief Contiguous storage for many clones of concrete prototypes of type T.
+ *
+ * Clones are copied in place from the prototype, with no allocation or virtual call per clone;
+ * what differs between them (usually the position) is patched in a second pass over the new
+ * clones only. When T is trivially copyable, which is checked at compile time, growing the
+ * storage moves the clones with one memcpy instead of moving and destroying them one by one.
+ */
+template <typename T>
+class CloneBuffer
+{
+public:
+    static constexpr bool BlockCopy = std::is_trivially_copyable_v<T>; ///< Whether clones are relocated by memcpy.
+
+private:
+    T* items = nullptr;
+    std::size_t count = 0;
+    std::size_t capacity = 0;
+
+    void grow(std::size_t needed)
+    {
+        const std::size_t newCapacity = std::max(needed, capacity * 2);
+        T* newItems = static_cast<T*>(::operator new(newCapacity * sizeof(T), std::align_val_t(alignof(T))));
+        if constexpr (BlockCopy)
+        {
+            if (count > 0)
+            {
+                std::memcpy(newItems, items, count * sizeof(T));
+            }
+        }
+        else
+        {
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                new (newItems + i) T(std::move(items[i]));
+                items[i].~T();
+            }
+        }
+        ::operator delete(items, std::align_val_t(alignof(T)));
+        items = newItems;
+        capacity = newCapacity;
+    }
+
+public:
+    CloneBuffer() = default;
+
+    ~CloneBuffer()
+    {
+        clear();
+        ::operator delete(items, std::align_val_t(alignof(T)));
+    }
+
+    CloneBuffer(const CloneBuffer&) = delete;
+    CloneBuffer& operator=(const CloneBuffer&) = delete;
+
+    /**
+     * @brief Appends copies of a prototype.
+     *
+     * @param prototype The object to clone. It may be one of the buffer's own clones.
+     * @param clones How many copies to append.
+     * @param patch Called as patch(clone, i) on each new clone, i counting from 0, once they are all copied.
+     * @return The first new clone.
+     */
+    template <typename Patch>
+    T* cloneMany(const T& prototype, std::size_t clones, Patch patch)
+    {
+        if (clones == 0) return items + count;
+
+        // Copied before growing, as grow() frees the storage the prototype may be in.
+        const T source(prototype);
+        if (count + clones > capacity)
+        {
+            grow(count + clones);
+        }
+        T* first = items + count;
+        std::uninitialized_fill_n(first, clones, source);
+        count += clones;
+
+        for (std::size_t i = 0; i < clones; ++i)
+        {
+            patch(first[i], i);
+        }
+        return first;
+    }
+
+    void clear()
+    {
+        if constexpr (!std::is_trivially_destructible_v<T>)
+        {
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                items[i].~T();
+            }
+        }
+        count = 0;
+    }
+
+    T& operator[](std::size_t index) { return items[index]; }
+    const T& operator[](std::size_t index) const { return items[index]; }
+
+    T* begin() { return items; }
+    T* end() { return items + count; }
+    const T* begin() const { return items; }
+    const T* end() const { return items + count; }
+
+    std::size_t size() const { return count; }
+};
+
+#endif
@@ -0,0 +1,137 @@
+#ifndef GAME_OBJECT_H
+#define GAME_OBJECT_H
+
+#include "SDL2/SDL.h"
+#include <type_traits>
+
+/**
+ * @class GameObject
+ * @brief Abstract base class for all game objects in the prototype pattern.
+ * 
+ * Defines the common interface for all game objects that can be cloned and rendered.
+ */
+class GameObject
+{
+public:
+    /**
+     * @brief Clones the current object to create a new instance.
+     * 
+     * @param newX The new x-coordinate for the cloned object.
+     * @param newY The new y-coordinate for the cloned object.
+     * @return A pointer to the cloned GameObject.
+     */
+    virtual GameObject* clone(int newX, int newY) const = 0;
+
+    /**
+     * @brief Renders the object on the screen.
+     * 
+     * @param renderer The SDL renderer to draw the object.
+     */
+    virtual void render(SDL_Renderer* renderer) const = 0;
+
+    /**
+     * @brief Virtual destructor for proper cleanup of derived classes.
+     */
+    virtual ~GameObject() = default;
+};
+
+/**
+ * @struct BulletData
+ * @brief The state of a Bullet as plain data.
+ * 
+ * Being trivially copyable, it can be cloned by plain copies, many at a time, without a virtual
+ * call or a constructor per bullet (see CloneBuffer).
+ */
+struct BulletData
+{
+    int x, y;                             ///< The x and y coordinates of the Bullet.
+    int speed;                            ///< The speed at which the Bullet moves vertically.
+    int width = 10, height = 20;          ///< The size of the Bullet on screen.
+    int damage = 1;                       ///< The damage the Bullet deals on a hit.
+    SDL_Color color = {255, 0, 0, 255};   ///< The colour the Bullet is drawn in.
+
+    /**
+     * @brief Renders the Bullet on the screen using SDL.
+     * 
+     * @param renderer The SDL renderer used to draw the Bullet.
+     */
+    void render(SDL_Renderer* renderer) const
+    {
+        SDL_Rect rect = {x, y, width, height};
+        SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a); 
+        SDL_RenderFillRect(renderer, &rect);
+    }
+
+    /**
+     * @brief Updates the position of the Bullet by moving it vertically.
+     */
+    void update() 
+    {
+        y -= speed; 
+    }
+};
+
+static_assert(std::is_trivially_copyable_v<BulletData>, "BulletData must stay clonable by plain copies");
+
+/**
+ * @class Bullet
+ * @brief Represents a Bullet in the game, inherits from GameObject.
+ * 
+ * This class provides functionality to clone the bullet, render it on the screen, 
+ * and update its position based on speed.
+ */
+class Bullet : public GameObject
+{
+private:
+    BulletData data; ///< Position and speed of the Bullet.
+
+public:
+    /**
+     * @brief Constructs a Bullet object with a starting position and speed.
+     * 
+     * @param startX The initial x-coordinate of the Bullet (default is 0).
+     * @param startY The initial y-coordinate of the Bullet (default is 0).
+     * @param speed The speed of the Bullet (default is 0).
+     */
+    Bullet(int startX = 0, int startY = 0, int speed = 0)
+    : data{startX, startY, speed} 
+    {
+    }
+
+    /**
+     * @brief Clones the Bullet object and returns a new instance with updated position.
+     * 
+     * @param newX The new x-coordinate for the cloned Bullet.
+     * @param newY The new y-coordinate for the cloned Bullet.
+     * @return A pointer to the new Bullet object.
+     */
+    GameObject* clone(int newX, int newY) const override
+    {
+        return new Bullet(newX, newY, data.speed);
+    }
+
+    /**
+     * @brief Renders the Bullet on the screen using SDL.
+     * 
+     * @param renderer The SDL renderer used to draw the Bullet.
+     */
+    void render(SDL_Renderer* renderer) const override
+    {
+        data.render(renderer);
+    }
+
+    /**
+     * @brief Updates the position of the Bullet by moving it vertically.
+     */
+    void update() 
+    {
+        data.update();
+    }
+
+    const BulletData& getData() const { return data; }
+    int getX() const { return data.x; }
+    int getY() const { return data.y; }
+    int getSpeed() const { return data.speed; }
+};
+
+#endif
@@ -0,0 +1,155 @@
+#ifndef HANDLE_POOL_H
+#define HANDLE_POOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+/**
+ * @struct GenerationalHandle
+ * @brief Reference to an object in a HandlePool: a slot index and the generation of the slot, in one word.
+ *
+ * The low IndexBits bits hold the index and the rest the generation. The value 0 is the null
+ * handle, which never resolves.
+ */
+template <typename Word, unsigned IndexBits>
+struct GenerationalHandle
+{
+    static constexpr unsigned GenerationBits = sizeof(Word) * 8 - IndexBits;
+    static constexpr Word IndexMask = (Word{1} << IndexBits) - 1;
+    static constexpr Word MaxGeneration = (Word{1} << GenerationBits) - 1;
+    static constexpr std::size_t MaxSlots = static_cast<std::size_t>(IndexMask) + 1;
+
+    Word value = 0; ///< Generation and index.
+
+    static GenerationalHandle make(std::size_t index, Word generation)
+    {
+        return {static_cast<Word>(generation << IndexBits | static_cast<Word>(index))};
+    }
+
+    std::size_t index() const { return static_cast<std::size_t>(value & IndexMask); }
+    Word generation() const { return value >> IndexBits; }
+
+    explicit operator bool() const { return value != 0; }
+    bool operator==(GenerationalHandle other) const { return value == other.value; }
+    bool operator!=(GenerationalHandle other) const { return value != other.value; }
+};
+
+using Handle32 = GenerationalHandle<std::uint32_t, 22>; ///< 4M slots, each reused up to 1023 times.
+using Handle64 = GenerationalHandle<std::uint64_t, 32>; ///< 4G slots, each reused up to 4G times.
+
+/**
+ * @class HandlePool
+ * @brief Pooled objects referred to by generational handles instead of pointers.
+ *
+ * Every slot remembers the handle it currently answers to. Freeing a slot bumps its generation,
+ * so handles to the object that was there stop matching, even after the slot is reused: resolve()
+ * is one load from the slot's array and one compare, and never returns a recycled object. Slot 0
+ * is never used, so the null handle resolves to nothing without a bounds check. A slot whose
+ * generation would wrap around is retired instead of reused.
+ */
+template <typename T, typename Handle = Handle32>
+class HandlePool
+{
+private:
+    using Word = decltype(Handle::value);
+
+    std::vector<T> items;
+    std::vector<Word> handles;       ///< Handle each slot answers to.
+    std::vector<std::uint8_t> alive; ///< Whether each slot holds an object.
+    std::vector<std::uint32_t> freeSlots;
+    std::size_t live = 0;
+
+public:
+    HandlePool()
+    {
+        items.emplace_back();
+        handles.push_back(Handle::make(0, Handle::MaxGeneration).value);
+        alive.push_back(0);
+    }
+
+    /**
+     * @brief Stores an object and returns its handle.
+     * @throws std::length_error if every slot the handle can address is taken.
+     */
+    Handle add(const T& item)
+    {
+        std::size_t slot;
+        if (!freeSlots.empty())
+        {
+            slot = freeSlots.back();
+            freeSlots.pop_back();
+            items[slot] = item;
+        }
+        else
+        {
+            if (items.size() >= Handle::MaxSlots)
+            {
+                throw std::length_error("HandlePool: no slot left for this handle size");
+            }
+            slot = items.size();
+            items.push_back(item);
+            handles.push_back(Handle::make(slot, 1).value);
+            alive.push_back(0);
+        }
+        alive[slot] = 1;
+        ++live;
+        return Handle{handles[slot]};
+    }
+
+    /**
+     * @brief Frees the object's slot: every handle to it stops resolving.
+     * @return False if the handle was already stale.
+     */
+    bool remove(Handle handle)
+    {
+        if (!resolve(handle)) return false;
+
+        const std::size_t slot = handle.index();
+        alive[slot] = 0;
+        --live;
+        if (handle.generation() == Handle::MaxGeneration)
+        {
+            handles[slot] = Handle::make(slot, 0).value;
+            return true;
+        }
+        handles[slot] = Handle::make(slot, handle.generation() + 1).value;
+        freeSlots.push_back(static_cast<std::uint32_t>(slot));
+        return true;
+    }
+
+    /**
+     * @brief The object, or nullptr if the handle is null or stale.
+     */
+    T* resolve(Handle handle)
+    {
+        const std::size_t slot = handle.index();
+        return handles[slot] == handle.value ? &items[slot] : nullptr;
+    }
+
+    const T* resolve(Handle handle) const
+    {
+        const std::size_t slot = handle.index();
+        return handles[slot] == handle.value ? &items[slot] : nullptr;
+    }
+
+    /**
+     * @brief Calls f(handle, object) for every object, in slot order.
+     */
+    template <typename F>
+    void forEach(F f)
+    {
+        for (std::size_t slot = 1; slot < items.size(); ++slot)
+        {
+            if (alive[slot])
+            {
+                f(Handle{handles[slot]}, items[slot]);
+            }
+        }
+    }
+
+    std::size_t size() const { return live; }
+};
+
+#endif
@@ -0,0 +1,75 @@
+#include "PrototypeRegistry.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+void PrototypeRegistry::flatten(std::uint32_t id)
+{
+    // The parent's template is already flat, so one level of overrides is all there is to apply.
+    const PrototypeDefinition& definition = definitions[id];
+    BulletData flat = parents[id] == NoParent ? BulletData{0, 0, 0} : templates[parents[id]];
+    if (definition.speed) flat.speed = *definition.speed;
+    if (definition.width) flat.width = *definition.width;
+    if (definition.height) flat.height = *definition.height;
+    if (definition.damage) flat.damage = *definition.damage;
+    if (definition.color) flat.color = *definition.color;
+    templates[id] = flat;
+}
+
+std::uint32_t PrototypeRegistry::define(const std::string& name, const PrototypeDefinition& definition)
+{
+    std::uint32_t parent = NoParent;
+    if (!definition.parent.empty())
+    {
+        auto found = ids.find(definition.parent);
+        if (found == ids.end())
+        {
+            throw std::invalid_argument("PrototypeRegistry: parent '" + definition.parent + "' of '" + name + "' is not defined");
+        }
+        parent = found->second;
+    }
+
+    std::uint32_t id;
+    auto existing = ids.find(name);
+    if (existing == ids.end())
+    {
+        id = static_cast<std::uint32_t>(templates.size());
+        ids.emplace(name, id);
+        definitions.push_back(definition);
+        parents.push_back(NoParent);
+        children.emplace_back();
+        templates.emplace_back();
+    }
+    else
+    {
+        id = existing->second;
+        for (std::uint32_t ancestor = parent; ancestor != NoParent; ancestor = parents[ancestor])
+        {
+            if (ancestor == id)
+            {
+                throw std::invalid_argument("PrototypeRegistry: '" + name + "' cannot inherit from its own descendant '" + definition.parent + "'");
+            }
+        }
+        definitions[id] = definition;
+        if (parents[id] != NoParent)
+        {
+            std::vector<std::uint32_t>& siblings = children[parents[id]];
+            siblings.erase(std::find(siblings.begin(), siblings.end(), id));
+        }
+    }
+    parents[id] = parent;
+    if (parent != NoParent)
+    {
+        children[parent].push_back(id);
+    }
+
+    // Breadth-first from the prototype: every parent is flattened before its children.
+    std::vector<std::uint32_t> queue = {id};
+    for (std::size_t next = 0; next < queue.size(); ++next)
+    {
+        flatten(queue[next]);
+        queue.insert(queue.end(), children[queue[next]].begin(), children[queue[next]].end());
+    }
+    lastFlattened = queue.size();
+    return id;
+}
@@ -0,0 +1,85 @@
+#ifndef PROTOTYPE_REGISTRY_H
+#define PROTOTYPE_REGISTRY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "GameObject.h"
+
+/**
+ * @struct PrototypeDefinition
+ * @brief A bullet prototype as designers write it: a parent and the fields it overrides.
+ *
+ * Fields left empty are inherited from the parent, or take BulletData's defaults at the root.
+ */
+struct PrototypeDefinition
+{
+    std::string parent;             ///< Name of the parent prototype; empty for a root.
+    std::optional<int> speed;
+    std::optional<int> width;
+    std::optional<int> height;
+    std::optional<int> damage;
+    std::optional<SDL_Color> color;
+};
+
+/**
+ * @class PrototypeRegistry
+ * @brief Named bullet prototypes inheriting from each other, flattened when they are defined.
+ *
+ * Each prototype's chain of parents and overrides is resolved once, when it is defined, into a
+ * flattened BulletData: cloning one is a single copy of that template, however deep its
+ * ancestry. Redefining a prototype re-flattens it and its descendants only, parents before
+ * children, so the rest of the registry is left alone. Templates are only handed out as const
+ * references; the id of a prototype stays the same when it is redefined.
+ */
+class PrototypeRegistry
+{
+private:
+    std::unordered_map<std::string, std::uint32_t> ids;
+    std::vector<PrototypeDefinition> definitions;
+    std::vector<std::uint32_t> parents;                ///< Parent id of each prototype, or NoParent.
+    std::vector<std::vector<std::uint32_t>> children;
+    std::vector<BulletData> templates;                 ///< Flattened template of each prototype.
+    std::size_t lastFlattened = 0;
+
+    void flatten(std::uint32_t id);
+
+public:
+    static constexpr std::uint32_t NoParent = UINT32_MAX;
+
+    /**
+     * @brief Defines a prototype, or redefines it with a new parent or overrides, and re-flattens
+     * it with all its descendants.
+     *
+     * @throws std::invalid_argument if the parent is not defined yet, or is the prototype itself
+     * or one of its descendants.
+     * @return The prototype's id.
+     */
+    std::uint32_t define(const std::string& name, const PrototypeDefinition& definition);
+
+    /**
+     * @throws std::out_of_range if no prototype has this name.
+     */
+    std::uint32_t idOf(const std::string& name) const { return ids.at(name); }
+
+    /**
+     * @brief The flattened template to clone, by id.
+     */
+    const BulletData& getTemplate(std::uint32_t id) const { return templates[id]; }
+
+    const PrototypeDefinition& getDefinition(std::uint32_t id) const { return definitions[id]; }
+    std::uint32_t getParent(std::uint32_t id) const { return parents[id]; }
+
+    /**
+     * @brief Number of templates the last define() flattened: the prototype and its descendants.
+     */
+    std::size_t getLastFlattened() const { return lastFlattened; }
+
+    std::size_t size() const { return templates.size(); }
+};
+
+#endif
@@ -0,0 +1,18 @@
+#include "SpawnBuffers.h"
+
+std::size_t SpawnBuffers::merge(BulletField& field)
+{
+    std::size_t kept = 0;
+    for (SpawnBuffer& buffer : buffers)
+    {
+        buffer.spawned.clear();
+        for (const SpawnRequest& request : buffer.requests)
+        {
+            const BulletHandle bullet = field.spawn(request.prototype, request.position, request.time);
+            buffer.spawned.push_back(bullet);
+            kept += static_cast<bool>(bullet);
+        }
+        buffer.requests.clear();
+    }
+    return kept;
+}
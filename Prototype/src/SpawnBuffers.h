@@ -0,0 +1,93 @@
+#ifndef SPAWN_BUFFERS_H
+#define SPAWN_BUFFERS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Trajectory.h"
+
+/**
+ * @struct SpawnRequest
+ * @brief A bullet to clone into a BulletField at the next merge.
+ */
+struct SpawnRequest
+{
+    std::uint32_t prototype;
+    Vec2 position;
+    float time;
+};
+
+/**
+ * @class SpawnBuffer
+ * @brief Spawn requests of one thread, collected without any locking until the next merge.
+ *
+ * Only its own thread may use a buffer between merges; it sits on its own cache lines so that
+ * threads filling neighbouring buffers do not slow each other down.
+ */
+class alignas(64) SpawnBuffer
+{
+    friend class SpawnBuffers;
+
+private:
+    std::vector<SpawnRequest> requests;
+    std::vector<BulletHandle> spawned;
+
+public:
+    /**
+     * @brief Queues a clone of a prototype.
+     * @return The request's sequence number in this buffer, which indexes getSpawned() after the merge.
+     */
+    std::size_t request(std::uint32_t prototype, Vec2 position, float time)
+    {
+        requests.push_back({prototype, position, time});
+        return requests.size() - 1;
+    }
+
+    /**
+     * @brief Handles of the bullets cloned by the last merge, by sequence number; null for bullets
+     * that never reach the playfield.
+     */
+    const std::vector<BulletHandle>& getSpawned() const { return spawned; }
+
+    std::size_t pendingCount() const { return requests.size(); }
+};
+
+/**
+ * @class SpawnBuffers
+ * @brief One SpawnBuffer per gameplay thread, merged into a BulletField at a sync point.
+ *
+ * Threads clone bullets at the same time without sharing a lock: each one appends to its own
+ * buffer. merge(), called once every thread is done, for instance at the end of a frame, clones
+ * them into the field by thread index first and sequence number second. That order does not
+ * depend on how the threads were scheduled, so the same requests always give the same bullets
+ * with the same handles.
+ */
+class SpawnBuffers
+{
+private:
+    std::vector<SpawnBuffer> buffers;
+
+public:
+    /**
+     * @param threadCount Number of threads, which use the buffers 0 to threadCount - 1.
+     */
+    explicit SpawnBuffers(std::size_t threadCount) : buffers(threadCount) {}
+
+    /**
+     * @brief The buffer of a thread, by the fixed index it was given (not its std::thread::id,
+     * whose order varies from run to run).
+     */
+    SpawnBuffer& forThread(std::size_t threadIndex) { return buffers[threadIndex]; }
+
+    /**
+     * @brief Clones every queued request into the field and empties the buffers. No thread may
+     * request meanwhile.
+     * @return Number of bullets kept by the field.
+     */
+    std::size_t merge(BulletField& field);
+
+    std::size_t getThreadCount() const { return buffers.size(); }
+};
+
+#endif
@@ -0,0 +1,211 @@
+#include "Trajectory.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
+namespace
+{
+    constexpr float TwoPi = 6.28318530718f;
+
+    /**
+     * @brief Narrows [enter, exit] to the times when p + v * t lies between low and high on one axis.
+     */
+    void clipAxis(float p, float v, float low, float high, float& enter, float& exit)
+    {
+        if (v == 0.0f)
+        {
+            if (p < low || p > high)
+            {
+                exit = enter - 1.0f;
+            }
+            return;
+        }
+        float t1 = (low - p) / v;
+        float t2 = (high - p) / v;
+        if (t1 > t2)
+        {
+            std::swap(t1, t2);
+        }
+        enter = std::max(enter, t1);
+        exit = std::min(exit, t2);
+    }
+}
+
+Trajectory Trajectory::linear(Vec2 velocity, float lifetime)
+{
+    Trajectory trajectory;
+    trajectory.kind = Linear;
+    trajectory.velocity = velocity;
+    trajectory.lifetime = lifetime;
+    return trajectory;
+}
+
+Trajectory Trajectory::sineWave(Vec2 velocity, float amplitude, float frequency, float lifetime)
+{
+    Trajectory trajectory = linear(velocity, lifetime);
+    trajectory.kind = SineWave;
+    trajectory.amplitude = std::fabs(amplitude);
+    trajectory.frequency = frequency;
+    const float speed = std::hypot(velocity.x, velocity.y);
+    trajectory.sway = speed > 0.0f ? Vec2{-velocity.y / speed, velocity.x / speed} : Vec2{1.0f, 0.0f};
+    return trajectory;
+}
+
+Trajectory Trajectory::spiral(float radialSpeed, float angularSpeed, float startAngle, float lifetime)
+{
+    Trajectory trajectory;
+    trajectory.kind = Spiral;
+    trajectory.radialSpeed = std::max(radialSpeed, 1e-6f);
+    trajectory.angularSpeed = angularSpeed;
+    trajectory.startAngle = startAngle;
+    trajectory.lifetime = lifetime;
+    return trajectory;
+}
+
+Trajectory Trajectory::bezier(Vec2 control1, Vec2 control2, Vec2 end, float duration)
+{
+    Trajectory trajectory;
+    trajectory.kind = Bezier;
+    trajectory.control1 = control1;
+    trajectory.control2 = control2;
+    trajectory.end = end;
+    trajectory.lifetime = duration;
+    return trajectory;
+}
+
+Vec2 Trajectory::offsetAt(float time) const
+{
+    switch (kind)
+    {
+        case Linear:
+            return {velocity.x * time, velocity.y * time};
+        case SineWave:
+        {
+            const float side = amplitude * std::sin(TwoPi * frequency * time);
+            return {velocity.x * time + sway.x * side, velocity.y * time + sway.y * side};
+        }
+        case Spiral:
+        {
+            const float radius = radialSpeed * time;
+            const float angle = startAngle + angularSpeed * time;
+            return {radius * std::cos(angle), radius * std::sin(angle)};
+        }
+        case Bezier:
+        {
+            // The curve starts at the spawn point, so the first control point drops out.
+            const float s = lifetime > 0.0f ? std::clamp(time / lifetime, 0.0f, 1.0f) : 1.0f;
+            const float r = 1.0f - s;
+            const float b1 = 3.0f * r * r * s;
+            const float b2 = 3.0f * r * s * s;
+            const float b3 = s * s * s;
+            return {b1 * control1.x + b2 * control2.x + b3 * end.x, b1 * control1.y + b2 * control2.y + b3 * end.y};
+        }
+    }
+    return {};
+}
+
+bool Trajectory::window(Vec2 spawn, const Bounds& area, float& enter, float& exit) const
+{
+    enter = 0.0f;
+    exit = lifetime;
+
+    switch (kind)
+    {
+        case Linear:
+            clipAxis(spawn.x, velocity.x, area.left, area.right, enter, exit);
+            clipAxis(spawn.y, velocity.y, area.top, area.bottom, enter, exit);
+            break;
+        case SineWave:
+            // The straight line through an area grown by the amplitude.
+            clipAxis(spawn.x, velocity.x, area.left - amplitude, area.right + amplitude, enter, exit);
+            clipAxis(spawn.y, velocity.y, area.top - amplitude, area.bottom + amplitude, enter, exit);
+            break;
+        case Spiral:
+        {
+            // The bullet is always at radialSpeed * t from the spawn point, so it can only be in the
+            // area between the nearest and the farthest distance from the spawn point to the area.
+            const float nearX = std::max({area.left - spawn.x, 0.0f, spawn.x - area.right});
+            const float nearY = std::max({area.top - spawn.y, 0.0f, spawn.y - area.bottom});
+            const float farX = std::max(std::fabs(area.left - spawn.x), std::fabs(area.right - spawn.x));
+            const float farY = std::max(std::fabs(area.top - spawn.y), std::fabs(area.bottom - spawn.y));
+            enter = std::max(enter, std::hypot(nearX, nearY) / radialSpeed);
+            exit = std::min(exit, std::hypot(farX, farY) / radialSpeed);
+            break;
+        }
+        case Bezier:
+        {
+            // The curve stays within the bounding box of its control points.
+            const float left = spawn.x + std::min({0.0f, control1.x, control2.x, end.x});
+            const float right = spawn.x + std::max({0.0f, control1.x, control2.x, end.x});
+            const float top = spawn.y + std::min({0.0f, control1.y, control2.y, end.y});
+            const float bottom = spawn.y + std::max({0.0f, control1.y, control2.y, end.y});
+            if (right < area.left || left > area.right || bottom < area.top || top > area.bottom)
+            {
+                return false;
+            }
+            break;
+        }
+    }
+    return enter <= exit;
+}
+
+std::uint32_t BulletField::addPrototype(const Trajectory& trajectory)
+{
+    prototypes.push_back(trajectory);
+    return static_cast<std::uint32_t>(prototypes.size() - 1);
+}
+
+BulletHandle BulletField::spawn(std::uint32_t prototype, Vec2 position, float time)
+{
+    float enter, exit;
+    if (!prototypes[prototype].window(position, playfield, enter, exit)) return BulletHandle();
+
+    const BulletHandle bullet = bullets.add(Spawned{position, time, time + exit, prototype});
+    pending.emplace_back(time + enter, bullet.value);
+    std::push_heap(pending.begin(), pending.end(), std::greater<std::pair<float, std::uint32_t>>());
+    return bullet;
+}
+
+void BulletField::advance(float time)
+{
+    // Only the bullets at the front of the queue are looked at; the rest are not touched.
+    while (!pending.empty() && pending.front().first <= time)
+    {
+        std::pop_heap(pending.begin(), pending.end(), std::greater<std::pair<float, std::uint32_t>>());
+        active.push_back(BulletHandle{pending.back().second});
+        pending.pop_back();
+    }
+
+    // Bullets despawned meanwhile no longer resolve and are dropped with the expired ones.
+    for (std::size_t i = 0; i < active.size();)
+    {
+        const Spawned* spawned = bullets.resolve(active[i]);
+        if (!spawned || spawned->exitTime < time)
+        {
+            bullets.remove(active[i]);
+            active[i] = active.back();
+            active.pop_back();
+        }
+        else
+        {
+            ++i;
+        }
+    }
+}
+
+void BulletField::queryCircle(Vec2 center, float radius, float time, std::vector<BulletHandle>& hits) const
+{
+    for (BulletHandle bullet : active)
+    {
+        Vec2 position;
+        if (!positionOf(bullet, time, position)) continue;
+
+        const float dx = position.x - center.x;
+        const float dy = position.y - center.y;
+        if (dx * dx + dy * dy <= radius * radius)
+        {
+            hits.push_back(bullet);
+        }
+    }
+}
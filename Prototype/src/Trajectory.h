@@ -0,0 +1,196 @@
+#ifndef TRAJECTORY_H
+#define TRAJECTORY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "HandlePool.h"
+
+/**
+ * @struct Vec2
+ * @brief A position or an offset in the plane.
+ */
+struct Vec2
+{
+    float x = 0.0f;
+    float y = 0.0f;
+};
+
+/**
+ * @struct Bounds
+ * @brief Axis-aligned rectangle, edges included.
+ */
+struct Bounds
+{
+    float left, top, right, bottom;
+
+    bool contains(Vec2 point) const
+    {
+        return point.x >= left && point.x <= right && point.y >= top && point.y <= bottom;
+    }
+};
+
+/**
+ * @class Trajectory
+ * @brief Motion prototype: a closed-form path followed by every bullet cloned from it.
+ *
+ * A bullet cloned from a trajectory keeps only its spawn position and time; where it is at any
+ * time is computed from those, so nothing about it changes from one tick to the next. Time is in
+ * whatever unit the caller uses (seconds, ticks), as long as speeds use the same one.
+ */
+class Trajectory
+{
+public:
+    enum Kind
+    {
+        Linear,   ///< Straight line at constant velocity.
+        SineWave, ///< Straight line, swaying sideways.
+        Spiral,   ///< Spiralling out of the spawn point.
+        Bezier    ///< Cubic Bezier curve from the spawn point, travelled in a fixed duration.
+    };
+
+    /**
+     * @param velocity Displacement per time unit.
+     * @param lifetime Time after which the bullet is gone.
+     */
+    static Trajectory linear(Vec2 velocity, float lifetime);
+
+    /**
+     * @param amplitude Largest sideways distance from the straight line.
+     * @param frequency Sways per time unit.
+     */
+    static Trajectory sineWave(Vec2 velocity, float amplitude, float frequency, float lifetime);
+
+    /**
+     * @param radialSpeed Distance from the spawn point gained per time unit, above 0.
+     * @param angularSpeed Radians turned per time unit.
+     */
+    static Trajectory spiral(float radialSpeed, float angularSpeed, float startAngle, float lifetime);
+
+    /**
+     * @param control1, control2, end Curve points relative to the spawn point.
+     * @param duration Time to reach the end, after which the bullet is gone.
+     */
+    static Trajectory bezier(Vec2 control1, Vec2 control2, Vec2 end, float duration);
+
+    /**
+     * @brief Offset from the spawn point at a time since spawning, between 0 and the lifetime.
+     */
+    Vec2 offsetAt(float time) const;
+
+    /**
+     * @brief Times since spawning between which a bullet spawned at a point may be in the area.
+     *
+     * Exact for linear trajectories and conservative for the others: the bullet is never in the
+     * area outside the window, but may not be in it all along. Returns false if it never is.
+     */
+    bool window(Vec2 spawn, const Bounds& area, float& enter, float& exit) const;
+
+    Kind getKind() const { return kind; }
+    float getLifetime() const { return lifetime; }
+
+private:
+    Kind kind = Linear;
+    Vec2 velocity;        ///< Linear and SineWave.
+    Vec2 sway;            ///< SineWave: unit vector across the velocity.
+    float amplitude = 0.0f;
+    float frequency = 0.0f;
+    float radialSpeed = 0.0f;
+    float angularSpeed = 0.0f;
+    float startAngle = 0.0f;
+    Vec2 control1, control2, end; ///< Bezier.
+    float lifetime = 0.0f;
+};
+
+using BulletHandle = Handle32; ///< Handle to a bullet in a BulletField.
+
+/**
+ * @class BulletField
+ * @brief Bullets cloned from trajectory prototypes, whose positions are computed only when asked for.
+ *
+ * Bullets matter only inside the playfield, where they are drawn and collide. When a bullet is
+ * spawned, the window of time it may spend there is worked out once, and the bullet waits in a
+ * queue ordered by the time it enters. advance() moves the bullets whose window opened into the
+ * active list and drops those whose window closed. Bullets outside their window cost nothing per
+ * tick, and a bullet that never reaches the playfield is not stored at all.
+ *
+ * Bullets are referred to by generational handles, so a system still holding the handle of a
+ * bullet that was despawned, or whose slot was reused, finds it gone rather than another bullet.
+ */
+class BulletField
+{
+private:
+    struct Spawned
+    {
+        Vec2 spawn;
+        float spawnTime;
+        float exitTime;
+        std::uint32_t prototype;
+    };
+
+    Bounds playfield;
+    std::vector<Trajectory> prototypes;
+    HandlePool<Spawned, BulletHandle> bullets;
+    std::vector<std::pair<float, std::uint32_t>> pending; ///< Min-heap of entry times and handles.
+    std::vector<BulletHandle> active;                     ///< Bullets inside their window.
+
+public:
+    explicit BulletField(const Bounds& playfield) : playfield(playfield) {}
+
+    std::uint32_t addPrototype(const Trajectory& trajectory);
+
+    /**
+     * @brief Clones a bullet from a prototype at a position and time.
+     * @return The bullet, or a null handle if it never reaches the playfield and so is not kept.
+     */
+    BulletHandle spawn(std::uint32_t prototype, Vec2 position, float time);
+
+    /**
+     * @brief Removes a bullet before its time, for instance when it hits something.
+     * @return False if it was already gone.
+     */
+    bool despawn(BulletHandle bullet) { return bullets.remove(bullet); }
+
+    /**
+     * @brief Brings the active list up to a time, which must not go backwards.
+     */
+    void advance(float time);
+
+    /**
+     * @brief The bullets that may be in the playfield at the time of the last advance().
+     *
+     * Bullets despawned since then are still listed until the next advance(), but no longer resolve.
+     */
+    const std::vector<BulletHandle>& getActive() const { return active; }
+
+    /**
+     * @brief Position of a bullet at a time within its window.
+     * @return False if the bullet is gone, leaving position unchanged.
+     */
+    bool positionOf(BulletHandle bullet, float time, Vec2& position) const
+    {
+        const Spawned* spawned = bullets.resolve(bullet);
+        if (!spawned) return false;
+
+        const Vec2 offset = prototypes[spawned->prototype].offsetAt(time - spawned->spawnTime);
+        position = {spawned->spawn.x + offset.x, spawned->spawn.y + offset.y};
+        return true;
+    }
+
+    /**
+     * @brief Motion of a bullet, which must not be gone.
+     */
+    Trajectory::Kind kindOf(BulletHandle bullet) const { return prototypes[bullets.resolve(bullet)->prototype].getKind(); }
+
+    /**
+     * @brief Appends to hits the active bullets within a radius of a point at a time.
+     */
+    void queryCircle(Vec2 center, float radius, float time, std::vector<BulletHandle>& hits) const;
+
+    std::size_t pendingCount() const { return pending.size(); }
+    std::size_t activeCount() const { return active.size(); }
+};
+
+#endif
@@ -11,104 +11,38 @@
  * @example
  * In the context of a game, suppose you have a `Bullet` object that has a starting position and speed. Instead of creating a new `Bullet` from scratch every time, you can clone an existing `Bullet`, adjust its position or other properties, and use the new object without needing to re-initialize its properties.
  *
+ * Bullets can also be cloned from `Trajectory` prototypes into a `BulletField`: each keeps only its spawn position and time,
+ * and its position on a linear, sine-wave, spiral or Bezier path is computed only when it is drawn, so it costs nothing per tick.
+ *
+ * Field bullets are referred to by generational `BulletHandle`s rather than pointers, so a handle to a bullet that was removed,
+ * or whose slot was reused by a newer clone, is detected as stale.
+ *
+ * Systems on different threads clone field bullets through their own `SpawnBuffer`, merged into the field at a sync point
+ * in thread and request order, so that the result does not depend on scheduling.
+ *
+ * Prototypes that are plain data, like `BulletData`, are cloned many at a time into a `CloneBuffer` by plain copies,
+ * with no virtual call or constructor per clone, and their positions patched afterwards.
+ *
+ * Bullet prototypes can inherit from each other in a `PrototypeRegistry`, a "fast bullet" being a "bullet" with its speed
+ * overridden. Each is flattened into a complete template when it is defined, so a clone is one copy; press U to resize
+ * "bullet" and see its descendants re-flattened with it.
+ *
  * @see https://refactoring.guru/design-patterns/prototype
  * @see https://www.dofactory.com/design-patterns/prototype
  */
 
 #include "SDL2/SDL.h"
+#include <cmath>
 #include <iostream>
+#include <thread>
+#include <vector>
 
-/**
- * @class GameObject
- * @brief Abstract base class for all game objects in the prototype pattern.
- * 
- * Defines the common interface for all game objects that can be cloned and rendered.
- */
-class GameObject
-{
-public:
-    /**
-     * @brief Clones the current object to create a new instance.
-     * 
-     * @param newX The new x-coordinate for the cloned object.
-     * @param newY The new y-coordinate for the cloned object.
-     * @return A pointer to the cloned GameObject.
-     */
-    virtual GameObject* clone(int newX, int newY) const = 0;
-
-    /**
-     * @brief Renders the object on the screen.
-     * 
-     * @param renderer The SDL renderer to draw the object.
-     */
-    virtual void render(SDL_Renderer* renderer) const = 0;
-
-    /**
-     * @brief Virtual destructor for proper cleanup of derived classes.
-     */
-    virtual ~GameObject() = default;
-};
-
-/**
- * @class Bullet
- * @brief Represents a Bullet in the game, inherits from GameObject.
- * 
- * This class provides functionality to clone the bullet, render it on the screen, 
- * and update its position based on speed.
- */
-class Bullet : public GameObject
-{
-private:
-    int x , y; ///< The x and y coordinates of the Bullet.
-    int speed; ///< The speed at which the Bullet moves vertically.
-
-public:
-    /**
-     * @brief Constructs a Bullet object with a starting position and speed.
-     * 
-     * @param startX The initial x-coordinate of the Bullet (default is 0).
-     * @param startY The initial y-coordinate of the Bullet (default is 0).
-     * @param speed The speed of the Bullet (default is 0).
-     */
-    Bullet(int startX = 0, int startY = 0, int speed = 0)
-    : x(startX), y(startY), speed(speed) 
-    {
-        std::cout << "Bullet constructor called" << std::endl;
-    }
-
-    /**
-     * @brief Clones the Bullet object and returns a new instance with updated position.
-     * 
-     * @param newX The new x-coordinate for the cloned Bullet.
-     * @param newY The new y-coordinate for the cloned Bullet.
-     * @return A pointer to the new Bullet object.
-     */
-    GameObject* clone(int newX, int newY) const override
-    {
-        return new Bullet(newX, newY, speed);
-    }
-
-    /**
-     * @brief Renders the Bullet on the screen using SDL.
-     * 
-     * @param renderer The SDL renderer used to draw the Bullet.
-     */
-    void render(SDL_Renderer* renderer) const override
-    {
-        SDL_Rect rect = {x, y, 10, 20};
-        SDL_SetRenderDrawColor(renderer, 255, 0, 0, 255); 
-        SDL_RenderFillRect(renderer, &rect);
-    }
-
-    /**
-     * @brief Updates the position of the Bullet by moving it vertically.
-     */
-    void update() 
-    {
-        y -= speed; 
-    }
-};
-
+#include "Barrier.h"
+#include "CloneBuffer.h"
+#include "GameObject.h"
+#include "PrototypeRegistry.h"
+#include "SpawnBuffers.h"
+#include "Trajectory.h"
 
 /**
  * @brief Main function that initializes SDL, 
@@ -141,6 +75,83 @@ int main(int argc, char* argv[])
     Bullet originalBullet(320, 480, 5); 
     Bullet* clonedBullet = static_cast<Bullet*>(originalBullet.clone(100, 480));
 
+    // Motion prototypes in pixels and seconds; bullets leave the window or expire.
+    BulletField field({0.0f, 0.0f, 640.0f, 480.0f});
+    const std::uint32_t patterns[] = {
+        field.addPrototype(Trajectory::linear({60.0f, -240.0f}, 10.0f)),
+        field.addPrototype(Trajectory::sineWave({0.0f, -180.0f}, 30.0f, 2.0f, 10.0f)),
+        field.addPrototype(Trajectory::spiral(60.0f, 3.0f, 0.0f, 10.0f)),
+        field.addPrototype(Trajectory::bezier({-200.0f, -100.0f}, {200.0f, -300.0f}, {0.0f, -450.0f}, 3.0f)),
+    };
+    std::uint32_t ring[8];
+    for (int i = 0; i < 8; ++i)
+    {
+        const float angle = i * 0.785398f;
+        ring[i] = field.addPrototype(Trajectory::linear({150.0f * std::cos(angle), 150.0f * std::sin(angle)}, 10.0f));
+    }
+    SpawnBuffers spawnBuffers(2);
+    Uint32 nextSpawn = 0;
+
+    // Two gameplay systems clone bullets at the same time, each on its own long-lived thread and
+    // into its own buffer. The main thread releases both through spawnStart, with the time in
+    // spawnTime, and merges the buffers once both reached spawnDone.
+    Barrier spawnStart(3);
+    Barrier spawnDone(3);
+    float spawnTime = 0.0f;
+    bool stopSpawning = false;
+    std::thread emitter([&]()
+    {
+        SpawnBuffer& buffer = spawnBuffers.forThread(0);
+        for (spawnStart.arriveAndWait(); !stopSpawning; spawnStart.arriveAndWait())
+        {
+            for (std::uint32_t pattern : patterns)
+            {
+                buffer.request(pattern, {420.0f, 460.0f}, spawnTime);
+            }
+            spawnDone.arriveAndWait();
+        }
+    });
+    std::thread turret([&]()
+    {
+        SpawnBuffer& buffer = spawnBuffers.forThread(1);
+        for (spawnStart.arriveAndWait(); !stopSpawning; spawnStart.arriveAndWait())
+        {
+            for (std::uint32_t direction : ring)
+            {
+                buffer.request(direction, {160.0f, 160.0f}, spawnTime);
+            }
+            spawnDone.arriveAndWait();
+        }
+    });
+
+    // Other systems refer to field bullets by handle only: a shield removing the bullets that
+    // hit it, and a marker following one spiral bullet.
+    const Vec2 shield = {420.0f, 250.0f};
+    std::vector<BulletHandle> hits;
+    BulletHandle tracked;
+
+    // Volleys of plain-data bullets, cloned by plain copies of flattened templates: "heavy
+    // bullet" inherits its speed from "fast bullet", which inherits the rest from "bullet".
+    PrototypeRegistry prototypes;
+    PrototypeDefinition baseBullet;
+    baseBullet.speed = 3;
+    baseBullet.height = 20;
+    PrototypeDefinition fastBullet;
+    fastBullet.parent = "bullet";
+    fastBullet.speed = 6;
+    fastBullet.color = SDL_Color{255, 160, 0, 255};
+    PrototypeDefinition heavyBullet;
+    heavyBullet.parent = "fast bullet";
+    heavyBullet.width = 16;
+    heavyBullet.damage = 3;
+    const std::uint32_t volleyKinds[] = {
+        prototypes.define("bullet", baseBullet),
+        prototypes.define("fast bullet", fastBullet),
+        prototypes.define("heavy bullet", heavyBullet),
+    };
+    CloneBuffer<BulletData> volley;
+    Uint32 nextVolley = 0;
+
     bool running = true;
     SDL_Event event;
 
@@ -152,22 +163,110 @@ int main(int argc, char* argv[])
             {
                 running = false;
             }
+            else if (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_u)
+            {
+                baseBullet.height = *baseBullet.height % 40 + 10;
+                prototypes.define("bullet", baseBullet);
+                std::cout << "bullet height " << *baseBullet.height << ": re-flattened " << prototypes.getLastFlattened()
+                          << " templates" << std::endl;
+            }
         }
 
         originalBullet.update();
         clonedBullet->update();
 
+        if (SDL_GetTicks() >= nextVolley)
+        {
+            volley.clear();
+            for (std::size_t kind = 0; kind < 3; ++kind)
+            {
+                volley.cloneMany(prototypes.getTemplate(volleyKinds[kind]), 5, [kind](BulletData& bullet, std::size_t i)
+                {
+                    bullet.x = 20 + static_cast<int>(kind * 5 + i) * 40;
+                    bullet.y = 480;
+                });
+            }
+            nextVolley = SDL_GetTicks() + 2000;
+        }
+        for (BulletData& bullet : volley)
+        {
+            bullet.update();
+        }
+
         SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255); // Черный фон
         SDL_RenderClear(renderer);
 
         originalBullet.render(renderer);
         clonedBullet->render(renderer);
+        for (const BulletData& bullet : volley)
+        {
+            bullet.render(renderer);
+        }
+
+        // Only bullets that may be on screen get a position, and only now.
+        const Uint32 ticks = SDL_GetTicks();
+        const float now = ticks / 1000.0f;
+        if (ticks >= nextSpawn)
+        {
+            // The spawning threads fill their buffers, merged in a fixed order once both are done.
+            spawnTime = now;
+            spawnStart.arriveAndWait();
+            spawnDone.arriveAndWait();
+            spawnBuffers.merge(field);
+
+            if (!tracked)
+            {
+                tracked = spawnBuffers.forThread(0).getSpawned()[2];
+            }
+            nextSpawn = ticks + 150;
+        }
+        field.advance(now);
+
+        // Bullets hitting the shield are removed; anyone holding their handle sees them gone.
+        hits.clear();
+        field.queryCircle(shield, 40.0f, now, hits);
+        for (BulletHandle bullet : hits)
+        {
+            field.despawn(bullet);
+        }
+        SDL_Rect shieldRect = {static_cast<int>(shield.x) - 28, static_cast<int>(shield.y) - 28, 56, 56};
+        SDL_SetRenderDrawColor(renderer, 0, 120, 255, 255);
+        SDL_RenderDrawRect(renderer, &shieldRect);
+
+        for (BulletHandle bullet : field.getActive())
+        {
+            Vec2 position;
+            if (!field.positionOf(bullet, now, position)) continue;
+
+            const Uint8 shade = static_cast<Uint8>(100 + 50 * field.kindOf(bullet));
+            SDL_Rect rect = {static_cast<int>(position.x) - 3, static_cast<int>(position.y) - 3, 6, 6};
+            SDL_SetRenderDrawColor(renderer, 255, shade, 0, 255);
+            SDL_RenderFillRect(renderer, &rect);
+        }
+
+        // The tracked bullet is followed through its handle until it expires or hits the shield.
+        Vec2 trackedPosition;
+        if (field.positionOf(tracked, now, trackedPosition))
+        {
+            SDL_Rect marker = {static_cast<int>(trackedPosition.x) - 8, static_cast<int>(trackedPosition.y) - 8, 16, 16};
+            SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+            SDL_RenderDrawRect(renderer, &marker);
+        }
+        else
+        {
+            tracked = BulletHandle();
+        }
 
         SDL_RenderPresent(renderer);
 
         SDL_Delay(16); 
     }
     
+    stopSpawning = true;
+    spawnStart.arriveAndWait();
+    emitter.join();
+    turret.join();
+
     delete clonedBullet;
     SDL_DestroyRenderer(renderer);
     SDL_DestroyWindow(window);